@@ -1,123 +1,195 @@
 #include "ai.h"
 #include "logger.h"
+#include "profiler.h"
 #include "glyphs.h"
 #include "constants.h"
 #include "combat.h"
+#include "pathfinding.h"
 
-#include <queue>
-#include <unordered_map>
-#include <map>
 #include <utility>
 #include <cstdlib>
 #include <random> // FIXED: For central RNG
 #include <cmath>
 #include <algorithm>
-#include <chrono>
 
-namespace {
-    struct Node {
-        int x;
-        int y;
-    };
+namespace ai {
+    // Central RNG for AI (FIXED: Use same RNG as combat for determinism)
+    // IMPROVED: AI stream of the session bound to this thread
+    static Rng& ai_rng() {
+        return rngs::stream(rngs::Stream::Ai);
+    }
+    // How far (Manhattan) the player may drift from a cached route's target
+    // before the route is replanned
+    constexpr int PATH_TARGET_TOLERANCE = 2;
 
-    struct KeyHash {
-        std::size_t operator()(const std::pair<int, int>& k) const noexcept {
-            return (static_cast<std::size_t>(k.first) << 32) ^ static_cast<std::size_t>(k.second);
+    PathStats& path_stats() {
+        thread_local PathStats stats;
+        return stats;
+    }
+
+    // Replace blocked step i of a cached route with a short A* detour to the
+    // next walkable step, keeping the rest of the route intact
+    static bool detour_around(EnemyPath& path, int i, const Position& epos, const Dungeon& dungeon) {
+        int j = i + 1;
+        while (j < path.length && !dungeon.is_walkable(path.steps[j].x, path.steps[j].y)) {
+            ++j;
+        }
+        if (j >= path.length) {
+            path.length = i;  // Blocked near the end: keep the prefix, replan when used up
+            return true;
         }
-    };
-    
-    // Safety limit to prevent infinite loops in pathfinding
-    constexpr int MAX_PATHFIND_ITERATIONS = 10000;
-}
 
-namespace ai {
-    // Central RNG for AI (FIXED: Use same RNG as combat for determinism)
-    static std::mt19937& ai_rng() {
-        static std::mt19937 rng(std::random_device{}());
-        return rng;
+        ++path_stats().repairs;
+        const Position from = (i == path.cursor) ? epos : path.steps[i - 1];
+        thread_local std::vector<Position> detour;
+        if (!path_engine().find_path(dungeon, from, path.steps[j], detour, 64)) {
+            return false;
+        }
+
+        Position merged[EnemyPath::MAX_STEPS];
+        int n = 0;
+        for (int k = path.cursor; k < i && n < EnemyPath::MAX_STEPS; ++k) {
+            merged[n++] = path.steps[k];
+        }
+        for (size_t k = 0; k < detour.size() && n < EnemyPath::MAX_STEPS; ++k) {
+            merged[n++] = detour[k];
+        }
+        for (int k = j + 1; k < path.length && n < EnemyPath::MAX_STEPS; ++k) {
+            merged[n++] = path.steps[k];
+        }
+        std::copy(merged, merged + n, path.steps);
+        path.cursor = 0;
+        path.length = n;
+        return true;
+    }
+
+    // Bring a cached route up to date with tiles changed since it was planned
+    static bool repair_path(EnemyPath& path, const Position& epos, const Dungeon& dungeon) {
+        if (path.tileRevision == dungeon.revision()) {
+            return true;
+        }
+        if (!dungeon.change_log_covers(path.tileRevision)) {
+            path.clear();
+            return false;
+        }
+        for (uint32_t rev = path.tileRevision + 1; rev != dungeon.revision() + 1; ++rev) {
+            int idx = dungeon.changed_tile(rev);
+            int cx = idx % dungeon.width();
+            int cy = idx / dungeon.width();
+            if (dungeon.is_walkable(cx, cy)) {
+                continue;  // Still passable, route stays valid
+            }
+            for (int i = path.cursor; i < path.length; ++i) {
+                if (path.steps[i].x == cx && path.steps[i].y == cy) {
+                    if (!detour_around(path, i, epos, dungeon)) {
+                        path.clear();
+                        return false;
+                    }
+                    break;
+                }
+            }
+        }
+        path.tileRevision = dungeon.revision();
+        return true;
     }
+
+    // Take the next step of the enemy's cached route
+    static bool advance_path(Enemy& e, const Dungeon& dungeon) {
+        EnemyPath& path = e.path();
+        if (path.remaining() <= 0) {
+            return false;
+        }
+        Position epos = e.get_position();
+        Position next = path.steps[path.cursor];
+        if (manhattan_distance(epos.x, epos.y, next.x, next.y) != 1 || !dungeon.is_walkable(next.x, next.y)) {
+            path.clear();  // Knocked off the route (teleport, push) or route is stale
+            return false;
+        }
+        if (!e.can_enter(next.x, next.y)) {
+            return false;  // Another enemy is in the way; keep the route for later
+        }
+        e.move_by(next.x - epos.x, next.y - epos.y);
+        ++path.cursor;
+        return true;
+    }
+
+    // Follow the cached route if it was planned for the same purpose and the
+    // player is still close to where it was planned for
+    static bool follow_cached_path(Enemy& e, EnemyPath::Purpose purpose, const Position& ppos, const Dungeon& dungeon) {
+        EnemyPath& path = e.path();
+        if (path.purpose != purpose || path.remaining() <= 0 ||
+            manhattan_distance(path.target.x, path.target.y, ppos.x, ppos.y) > PATH_TARGET_TOLERANCE) {
+            return false;
+        }
+        // Close to the end of a chase the drift matters: home in on the live position
+        if (purpose == EnemyPath::Purpose::Chase && path.remaining() <= PATH_TARGET_TOLERANCE) {
+            return false;
+        }
+        if (!repair_path(path, e.get_position(), dungeon) || !advance_path(e, dungeon)) {
+            return false;
+        }
+        ++path_stats().cachedSteps;
+        return true;
+    }
+
     // Basic pathfinding step toward player
+    // IMPROVED: Reads the dungeon's cached player distance field instead of running
+    // a BFS per step. The downhill route is cached on the enemy and reused while the
+    // player stays near its target, so the field is rebuilt only when a route is stale.
     static void step_toward_player(Enemy& e, const Player& player, const Dungeon& dungeon) {
         Position epos = e.get_position();
         Position ppos = player.get_position();
         if (epos.x == ppos.x && epos.y == ppos.y) {
             return;
         }
-        
-        std::queue<Node> q;
-        std::unordered_map<std::pair<int, int>, std::pair<int, int>, KeyHash> parent;
-        q.push({epos.x, epos.y});
-        parent[{epos.x, epos.y}] = {-9999, -9999};
-        const int dirs[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
-        bool found = false;
-        int iterations = 0;
-        
-        while (!q.empty() && iterations < MAX_PATHFIND_ITERATIONS) {
-            iterations++;
-            Node cur = q.front();
-            q.pop();
-            if (cur.x == ppos.x && cur.y == ppos.y) {
-                found = true;
-                break;
-            }
-            for (auto& d : dirs) {
-                int nx = cur.x + d[0];
-                int ny = cur.y + d[1];
-                if (!dungeon.in_bounds(nx, ny) || !dungeon.is_walkable(nx, ny)) {
-                    continue;
-                }
-                std::pair<int,int> key{nx, ny};
-                if (parent.find(key) == parent.end()) {
-                    parent[key] = {cur.x, cur.y};
-                    q.push({nx, ny});
-                }
-            }
-        }
-        
-        if (iterations >= MAX_PATHFIND_ITERATIONS) {
-            LOG_WARN("Pathfinding hit iteration limit! Enemy at (" + 
-                     std::to_string(epos.x) + "," + std::to_string(epos.y) + 
-                     ") seeking player at (" + std::to_string(ppos.x) + "," + 
-                     std::to_string(ppos.y) + ")");
+        if (follow_cached_path(e, EnemyPath::Purpose::Chase, ppos, dungeon)) {
             return;
         }
-        
-        if (!found) {
-            LOG_DEBUG("No path found from enemy to player");
-            return;
+
+        if (!dungeon.distance_field_current(ppos)) {
+            ++path_stats().searches;
         }
-        
-        // Reconstruct one step
-        std::pair<int,int> step{ppos.x, ppos.y};
-        std::pair<int,int> prev{-1, -1};
-        int reconstructIterations = 0;
-        while (reconstructIterations < MAX_PATHFIND_ITERATIONS) {
-            reconstructIterations++;
-            auto it = parent.find(step);
-            if (it == parent.end()) {
-                break;
+        EnemyPath& path = e.path();
+        path.clear();
+        path.purpose = EnemyPath::Purpose::Chase;
+        path.target = ppos;
+        path.tileRevision = dungeon.revision();
+
+        const int dirs[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
+        Position cur = epos;
+        uint16_t curDist = dungeon.distance_to(ppos, cur.x, cur.y);
+        while (path.length < EnemyPath::MAX_STEPS && curDist != 0) {
+            Position best = cur;
+            for (const auto& d : dirs) {
+                uint16_t dist = dungeon.distance_to(ppos, cur.x + d[0], cur.y + d[1]);
+                if (dist < curDist) {
+                    curDist = dist;
+                    best = {cur.x + d[0], cur.y + d[1]};
+                }
             }
-            prev = step;
-            if (it->second.first == -9999) {
+            if (best.x == cur.x && best.y == cur.y) {
                 break;
             }
-            step = it->second;
+            path.steps[path.length++] = best;
+            cur = best;
         }
-        
-        if (reconstructIterations >= MAX_PATHFIND_ITERATIONS) {
-            LOG_WARN("Path reconstruction hit iteration limit!");
+
+        if (advance_path(e, dungeon)) {
             return;
         }
-        
-        int dx = 0;
-        int dy = 0;
-        if (prev.first != -1) {
-            dx = prev.first - epos.x;
-            dy = prev.second - epos.y;
-        }
-        if (dx != 0 || dy != 0) {
-            e.move_by(dx, dy);
+
+        // Route blocked by another enemy: take any other free downhill step
+        uint16_t here = dungeon.distance_to(ppos, epos.x, epos.y);
+        for (const auto& d : dirs) {
+            int nx = epos.x + d[0];
+            int ny = epos.y + d[1];
+            if (dungeon.distance_to(ppos, nx, ny) < here && e.can_enter(nx, ny)) {
+                path.clear();
+                e.move_by(d[0], d[1]);
+                return;
+            }
         }
+        LOG_DEBUG("No free path from enemy to player");
     }
 
     // Tier 1 (Basic): Just chase the player
@@ -186,6 +258,22 @@ namespace ai {
 
     // Line of sight using Bresenham's algorithm
     bool has_line_of_sight(int x1, int y1, int x2, int y2, const Dungeon& dungeon) {
+        // IMPROVED: Queries from the player's tile read the cached shadowcast FOV
+        const Position& eye = dungeon.fov_origin();
+        if (dungeon.fov_current(eye, constants::fov_radius)) {
+            bool fromEye = (x1 == eye.x && y1 == eye.y);
+            bool toEye = (x2 == eye.x && y2 == eye.y);
+            if (fromEye || toEye) {
+                int ox = fromEye ? x2 : x1;
+                int oy = fromEye ? y2 : y1;
+                int ex = ox - eye.x;
+                int ey = oy - eye.y;
+                if (ex * ex + ey * ey <= constants::fov_radius * constants::fov_radius) {
+                    return dungeon.is_visible(ox, oy);
+                }
+            }
+        }
+
         int dx = std::abs(x2 - x1);
         int dy = std::abs(y2 - y1);
         int sx = (x1 < x2) ? 1 : -1;
@@ -221,8 +309,8 @@ namespace ai {
         return std::abs(x2 - x1) + std::abs(y2 - y1);
     }
     
-    // Move enemy away from player
-    void move_away_from(Enemy& enemy, const Player& player, const Dungeon& dungeon) {
+    // Greedy single step directly away from the player
+    static void step_away_greedy(Enemy& enemy, const Player& player, const Dungeon& dungeon) {
         Position epos = enemy.get_position();
         Position ppos = player.get_position();
         
@@ -236,7 +324,7 @@ namespace ai {
         // Try to move away
         int nx = epos.x + dx;
         int ny = epos.y + dy;
-        if (dungeon.in_bounds(nx, ny) && dungeon.is_walkable(nx, ny)) {
+        if (dungeon.in_bounds(nx, ny) && dungeon.is_walkable(nx, ny) && enemy.can_enter(nx, ny)) {
             enemy.move_by(dx, dy);
             return;
         }
@@ -245,7 +333,7 @@ namespace ai {
         if (dx != 0) {
             nx = epos.x + dx;
             ny = epos.y;
-            if (dungeon.in_bounds(nx, ny) && dungeon.is_walkable(nx, ny)) {
+            if (dungeon.in_bounds(nx, ny) && dungeon.is_walkable(nx, ny) && enemy.can_enter(nx, ny)) {
                 enemy.move_by(dx, 0);
                 return;
             }
@@ -255,13 +343,66 @@ namespace ai {
         if (dy != 0) {
             nx = epos.x;
             ny = epos.y + dy;
-            if (dungeon.in_bounds(nx, ny) && dungeon.is_walkable(nx, ny)) {
+            if (dungeon.in_bounds(nx, ny) && dungeon.is_walkable(nx, ny) && enemy.can_enter(nx, ny)) {
                 enemy.move_by(0, dy);
                 return;
             }
         }
     }
     
+    // Move enemy away from player
+    // IMPROVED: Paths to the nearby tile with the greatest walking distance from
+    // the player instead of a greedy step that gets stuck on walls and corners.
+    void move_away_from(Enemy& enemy, const Player& player, const Dungeon& dungeon) {
+        constexpr int RETREAT_RADIUS = 5;
+        Position epos = enemy.get_position();
+        Position ppos = player.get_position();
+        if (follow_cached_path(enemy, EnemyPath::Purpose::Retreat, ppos, dungeon)) {
+            return;
+        }
+
+        uint16_t bestDist = dungeon.distance_to(ppos, epos.x, epos.y);
+        if (bestDist == Dungeon::UNREACHABLE_DISTANCE) {
+            step_away_greedy(enemy, player, dungeon);
+            return;
+        }
+
+        Position goal = epos;
+        int goalCost = 0;
+        for (int y = epos.y - RETREAT_RADIUS; y <= epos.y + RETREAT_RADIUS; ++y) {
+            for (int x = epos.x - RETREAT_RADIUS; x <= epos.x + RETREAT_RADIUS; ++x) {
+                uint16_t d = dungeon.distance_to(ppos, x, y);
+                if (d == Dungeon::UNREACHABLE_DISTANCE || d < bestDist) {
+                    continue;
+                }
+                int cost = manhattan_distance(epos.x, epos.y, x, y);
+                if (d > bestDist || (d == bestDist && cost < goalCost)) {
+                    bestDist = d;
+                    goal = {x, y};
+                    goalCost = cost;
+                }
+            }
+        }
+        if (goal.x == epos.x && goal.y == epos.y) {
+            return;  // Already as far away as the neighbourhood allows
+        }
+
+        ++path_stats().searches;
+        thread_local std::vector<Position> route;
+        EnemyPath& path = enemy.path();
+        path.clear();
+        if (path_engine().find_path(dungeon, epos, goal, route, RETREAT_RADIUS * RETREAT_RADIUS * 8)) {
+            path.purpose = EnemyPath::Purpose::Retreat;
+            path.target = ppos;
+            path.tileRevision = dungeon.revision();
+            path.length = static_cast<int>(std::min<size_t>(route.size(), EnemyPath::MAX_STEPS));
+            std::copy(route.begin(), route.begin() + path.length, path.steps);
+        }
+        if (!advance_path(enemy, dungeon)) {
+            step_away_greedy(enemy, player, dungeon);
+        }
+    }
+    
     // Ranged attack from enemy to player
     void ranged_attack(Enemy& enemy, Player& player, int baseDamage, int depth, MessageLog& log) {
         // Calculate damage with depth scaling
@@ -279,15 +420,11 @@ namespace ai {
         }
     }
     
-    // Archer behavior: keep distance, shoot if in range (with 4 second cooldown)
+    // Archer behavior: keep distance, shoot if in range (with a cooldown of a few turns)
+    // IMPROVED: Cooldown is a turn counter on the archer instead of a wall-clock map keyed by position
     static void behavior_archer(Enemy& enemy, Player& player, const Dungeon& dungeon, MessageLog& log, int depth = 1) {
-        static std::map<std::pair<int, int>, std::chrono::steady_clock::time_point> lastArcherShotTime;  // Track last shot time per archer position
-        
         Position epos = enemy.get_position();
         Position ppos = player.get_position();
-        
-        // Use position as key to track individual archers
-        auto archerKey = std::make_pair(epos.x, epos.y);
 
         Position3D enemyPos{epos.x, epos.y, enemy.is_grounded() ? 0 : 2};
         Position3D playerPos{ppos.x, ppos.y, 0};
@@ -299,19 +436,11 @@ namespace ai {
             return;
         }
         
-        // Check if 4 seconds have passed since last shot
-        auto now = std::chrono::steady_clock::now();
-        bool canShoot = true;
-        if (lastArcherShotTime.find(archerKey) != lastArcherShotTime.end()) {
-            auto timeSinceLastShot = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - lastArcherShotTime[archerKey]);
-            canShoot = (timeSinceLastShot.count() >= 4000);  // 4 seconds
-        }
-        
+        bool canShoot = enemy.timers().shotCooldown == 0;
         if ((distCategory == CombatDistance::MEDIUM || distCategory == CombatDistance::FAR) &&
-            has_line_of_sight(epos.x, epos.y, ppos.x, ppos.y, dungeon) && canShoot) {
+            canShoot && has_line_of_sight(epos.x, epos.y, ppos.x, ppos.y, dungeon)) {
             ranged_attack(enemy, player, 4, depth, log);
-            lastArcherShotTime[archerKey] = now;  // Update last shot time
+            enemy.timers().shotCooldown = game_constants::ARCHER_SHOT_COOLDOWN_TURNS;
             LOG_DEBUG("Archer firing from distance category " + std::to_string(static_cast<int>(distCategory)));
             return;
         }
@@ -320,8 +449,10 @@ namespace ai {
     }
 
     void take_turn(Enemy& enemy, const Player& player, const Dungeon& dungeon, MessageLog& log) {
+        PROF_ZONE("ai_take_turn");
         // Update tier before acting
         enemy.knowledge().update_tier();
+        enemy.timers().tick();
         
         enemy.tick_statuses(log);
         if (enemy.stats().hp <= 0) {
@@ -371,24 +502,16 @@ namespace ai {
     
     // Boss-specific behavior with attack patterns
     void behavior_boss(Enemy& enemy, const Player& player, const Dungeon& dungeon, MessageLog& log) {
-        static std::map<EnemyType, int> bossActionCounter;  // Track action count per boss
-        static std::map<EnemyType, std::chrono::steady_clock::time_point> lastBossMessageTime;  // Track last message time per boss
-        
-        int& counter = bossActionCounter[enemy.enemy_type()];
-        counter++;
+        // IMPROVED: Pattern step and message throttle are per-boss turn counters
+        // (were maps keyed by boss type and a 5 second wall-clock throttle)
+        EnemyTimers& timers = enemy.timers();
+        int counter = ++timers.patternCounter;
         
         Position epos = enemy.get_position();
         Position ppos = player.get_position();
         int dist = std::abs(epos.x - ppos.x) + std::abs(epos.y - ppos.y);
         
-        // Check if 5 seconds have passed since last boss message
-        auto now = std::chrono::steady_clock::now();
-        bool canShowMessage = true;
-        if (lastBossMessageTime.find(enemy.enemy_type()) != lastBossMessageTime.end()) {
-            auto timeSinceLastMessage = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - lastBossMessageTime[enemy.enemy_type()]);
-            canShowMessage = (timeSinceLastMessage.count() >= 5000);  // 5 seconds
-        }
+        bool canShowMessage = timers.messageCooldown == 0;
         
         // Boss-specific patterns based on type
         switch (enemy.enemy_type()) {
@@ -399,14 +522,14 @@ namespace ai {
                     // BRACE phase - move toward player but prepare defense
                     if (canShowMessage) {
                     log.add(MessageType::Warning, glyphs::shield() + std::string(" ") + enemy.name() + " braces for impact!");
-                        lastBossMessageTime[enemy.enemy_type()] = now;
+                        timers.messageCooldown = game_constants::BOSS_MESSAGE_COOLDOWN_TURNS;
                     }
                     step_toward_player(enemy, player, dungeon);
                 } else if (patternStep == 1 && dist <= 2) {
                     // TACKLE phase - aggressive charge
                     if (canShowMessage) {
                     log.add(MessageType::Combat, enemy.name() + " charges at you!");
-                        lastBossMessageTime[enemy.enemy_type()] = now;
+                        timers.messageCooldown = game_constants::BOSS_MESSAGE_COOLDOWN_TURNS;
                     }
                     step_toward_player(enemy, player, dungeon);
                     step_toward_player(enemy, player, dungeon);
@@ -422,27 +545,32 @@ namespace ai {
                 if (patternStep == 0 && dist > 2) {
                     if (canShowMessage) {
                     log.add(MessageType::Warning, glyphs::ice() + std::string(" ") + enemy.name() + " prepares a frost attack!");
-                        lastBossMessageTime[enemy.enemy_type()] = now;
+                        timers.messageCooldown = game_constants::BOSS_MESSAGE_COOLDOWN_TURNS;
                     }
                     // Simulate ranged attack - move away to cast
                     move_away_from(enemy, player, dungeon);
                 } else if (patternStep == 1) {
                     if (canShowMessage) {
                     log.add(MessageType::Combat, enemy.name() + " teleports!");
-                        lastBossMessageTime[enemy.enemy_type()] = now;
+                        timers.messageCooldown = game_constants::BOSS_MESSAGE_COOLDOWN_TURNS;
                     }
                     // Teleport to random nearby position
-                    std::random_device rd;
-                    std::mt19937 rng(rd());
-                    int newX = ppos.x + (rng() % 5) - 2;
-                    int newY = ppos.y + (rng() % 5) - 2;
-                    if (dungeon.is_walkable(newX, newY)) {
+                    // IMPROVED: Session AI stream instead of a fresh random_device + mt19937
+                    Rng& rng = ai_rng();
+                    int newX = ppos.x + static_cast<int>(rng() % 5) - 2;
+                    int newY = ppos.y + static_cast<int>(rng() % 5) - 2;
+                    // Only land where the player can actually be reached on foot,
+                    // not on the far side of a wall
+                    thread_local std::vector<Position> landingPath;
+                    if (dungeon.is_walkable(newX, newY) && enemy.can_enter(newX, newY) &&
+                        path_engine().find_path(dungeon, {newX, newY}, ppos, landingPath, 64) &&
+                        landingPath.size() <= 4) {
                         enemy.set_position(newX, newY);
                     }
                 } else {
                     if (canShowMessage) {
                     log.add(MessageType::Warning, glyphs::fire() + std::string(" ") + enemy.name() + " channels fire magic!");
-                        lastBossMessageTime[enemy.enemy_type()] = now;
+                        timers.messageCooldown = game_constants::BOSS_MESSAGE_COOLDOWN_TURNS;
                     }
                     step_toward_player(enemy, player, dungeon);
                 }
@@ -455,14 +583,14 @@ namespace ai {
                     if (dist > 3) {
                         if (canShowMessage) {
                         log.add(MessageType::Warning, glyphs::fire() + std::string(" ") + enemy.name() + " breathes fire!");
-                            lastBossMessageTime[enemy.enemy_type()] = now;
+                            timers.messageCooldown = game_constants::BOSS_MESSAGE_COOLDOWN_TURNS;
                         }
                         // Stay at range
                     } else {
                         // Too close, retreat
                         if (canShowMessage) {
                         log.add(MessageType::Combat, enemy.name() + " retreats to optimal range!");
-                            lastBossMessageTime[enemy.enemy_type()] = now;
+                            timers.messageCooldown = game_constants::BOSS_MESSAGE_COOLDOWN_TURNS;
                         }
                         move_away_from(enemy, player, dungeon);
                     }
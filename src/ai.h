@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include "enemy.h"
 #include "dungeon.h"
@@ -13,6 +14,21 @@
  */
 namespace ai {
 
+    /**
+     * @brief Counters for pathfinding work done by enemy AI on the calling thread.
+     */
+    struct PathStats {
+        uint64_t searches = 0;    ///< Full searches: distance field rebuilds and A* plans
+        uint64_t repairs = 0;     ///< Local detours spliced into cached routes
+        uint64_t cachedSteps = 0; ///< Steps taken from a cached route without searching
+    };
+
+    /**
+     * @brief Get the pathfinding counters for the calling thread.
+     * @return Mutable counters (callers may snapshot and diff per turn)
+     */
+    PathStats& path_stats();
+
     /**
      * @brief Executes the enemy's turn, choosing and performing an action.
      * @param enemy The enemy taking its turn.
@@ -24,6 +40,10 @@ namespace ai {
 
     /**
      * @brief Checks line of sight between two points using Bresenham's algorithm.
+     *
+     * When one endpoint is the origin of the dungeon's current field of view
+     * (see Dungeon::compute_fov) and the other is within sight radius, the
+     * answer is read from the visibility bitset instead of re-tracing.
      * @param x1 Start x coordinate.
      * @param y1 Start y coordinate.
      * @param x2 End x coordinate.
@@ -0,0 +1,120 @@
+#include "animation.h"
+#include "input.h"
+#include "logger.h"
+#include "ui.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <utility>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // How often finish() checks for a key while waiting out a hold
+    constexpr int POLL_MS = 5;
+
+    struct QueuedStep {
+        anim::Step draw;
+        int holdMs;
+    };
+
+    std::deque<QueuedStep> g_steps;
+    Clock::time_point g_nextDue{};   // When the next step may run (end of the current hold)
+    bool g_enabled = true;
+
+    bool instant() {
+        return !g_enabled || ui::delays_skipped();
+    }
+
+    void run(QueuedStep& step) {
+        if (step.draw) {
+            step.draw();
+        }
+        g_nextDue = Clock::now() + std::chrono::milliseconds(step.holdMs);
+    }
+}
+
+namespace anim {
+    void push(Step draw, int holdMs) {
+        // Nothing is drawn in headless mode, so frames are dropped outright
+        if (ui::headless()) {
+            return;
+        }
+        if (instant()) {
+            if (draw) draw();
+            return;
+        }
+        QueuedStep step{std::move(draw), std::max(0, holdMs)};
+        if (g_steps.empty() && Clock::now() >= g_nextDue) {
+            run(step);
+            return;
+        }
+        g_steps.push_back(std::move(step));
+    }
+
+    void call(Step draw) {
+        push(std::move(draw), 0);
+    }
+
+    void pause(int ms) {
+        push(nullptr, ms);
+    }
+
+    int advance() {
+        auto now = Clock::now();
+        while (!g_steps.empty() && now >= g_nextDue) {
+            QueuedStep step = std::move(g_steps.front());
+            g_steps.pop_front();
+            run(step);
+            now = Clock::now();
+        }
+        if (g_steps.empty() && now >= g_nextDue) {
+            return -1;
+        }
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(g_nextDue - now).count();
+        return static_cast<int>(std::max<long long>(0, wait));
+    }
+
+    void skip() {
+        while (!g_steps.empty()) {
+            QueuedStep step = std::move(g_steps.front());
+            g_steps.pop_front();
+            if (step.draw) {
+                step.draw();
+            }
+        }
+        g_nextDue = Clock::now();
+    }
+
+    void finish() {
+        while (true) {
+            int waitMs = advance();
+            if (waitMs < 0) {
+                return;
+            }
+            if (input::key_available()) {
+                LOG_DEBUG("Animation skipped by key press");
+                skip();
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(waitMs, POLL_MS)));
+        }
+    }
+
+    bool active() {
+        return !g_steps.empty() || Clock::now() < g_nextDue;
+    }
+
+    void set_enabled(bool enabled) {
+        g_enabled = enabled;
+        if (!enabled) {
+            skip();
+        }
+    }
+
+    bool enabled() {
+        return g_enabled;
+    }
+}
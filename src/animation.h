@@ -0,0 +1,39 @@
+#pragma once
+
+#include <functional>
+
+// Animation timeline: effects queue their frames here instead of sleeping
+// between them. The loops that own the screen advance the timeline once per
+// frame, so game logic never waits on an animation, and any key press skips
+// straight to the final frame (the key is kept for the next read).
+namespace anim {
+    using Step = std::function<void()>;
+
+    // Queue a frame: run draw, then hold for holdMs before the next step.
+    // Runs at once when the timeline is idle; with animations disabled (or
+    // delays skipped) every step runs immediately and holds are dropped.
+    void push(Step draw, int holdMs);
+
+    // Queue a draw with no hold
+    void call(Step draw);
+
+    // Queue a pause
+    void pause(int ms);
+
+    // Run every step that is due, without waiting
+    // Returns: milliseconds until the next step is due, or -1 once the timeline is done
+    int advance();
+
+    // Run all remaining steps immediately, skipping their holds
+    void skip();
+
+    // Play the timeline to the end; a key press skips the rest
+    void finish();
+
+    // Steps queued or a hold still running
+    bool active();
+
+    // Turn animations on or off globally (--no-animations)
+    void set_enabled(bool enabled);
+    bool enabled();
+}
@@ -0,0 +1,118 @@
+#include "assets.h"
+#include "embedded_assets.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    std::string g_arena;                                    // Override file text, back to back
+    std::unordered_map<std::string, assets::Sprite> g_sprites;
+
+    // Same text the old line-by-line loader produced: the final newline is dropped
+    std::string_view trim_final_newline(std::string_view text) {
+        if (!text.empty() && text.back() == '\n') {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    void add(const std::string& name, std::string_view text) {
+        assets::Sprite sprite;
+        sprite.text = trim_final_newline(text);
+        auto dims = assets::measure(sprite.text);
+        sprite.height = dims.first;
+        sprite.width = dims.second;
+        g_sprites[name] = sprite;
+    }
+
+    // Files under root replace the embedded assets of the same name
+    size_t load_overrides(const std::string& root) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        std::vector<fs::path> files;
+        for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec) && it->path().extension() == ".txt") {
+                files.push_back(it->path());
+            }
+        }
+        if (files.empty()) {
+            LOG_WARN("Assets: no overrides found in " + root);
+            return 0;
+        }
+        std::sort(files.begin(), files.end());
+
+        // Sized up front so the arena is filled with one allocation; views are
+        // only taken once it stops growing
+        uintmax_t total = 0;
+        for (const auto& file : files) {
+            uintmax_t size = fs::file_size(file, ec);
+            if (!ec) total += size;
+        }
+        g_arena.reserve(static_cast<size_t>(total));
+
+        struct Span { std::string name; size_t offset; size_t length; };
+        std::vector<Span> spans;
+        spans.reserve(files.size());
+        for (const auto& file : files) {
+            std::ifstream in(file, std::ios::binary);
+            if (!in) {
+                continue;
+            }
+            size_t offset = g_arena.size();
+            g_arena.append(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            std::string name = fs::relative(file, root, ec).replace_extension().generic_string();
+            spans.push_back({std::move(name), offset, g_arena.size() - offset});
+        }
+        for (const auto& span : spans) {
+            add(span.name, std::string_view(g_arena).substr(span.offset, span.length));
+        }
+        LOG_INFO("Assets: " + std::to_string(spans.size()) + " overrides from " + root +
+                 " (" + std::to_string(g_arena.size()) + " bytes)");
+        return spans.size();
+    }
+}
+
+namespace assets {
+    size_t load(const std::string& overrideDir) {
+        g_sprites.clear();
+        g_arena.clear();
+
+        // Embedded text is static data, so these views need no copies or file opens
+        const embedded::Entry* entries = embedded::entries();
+        for (size_t i = 0; i < embedded::count(); ++i) {
+            add(entries[i].name, std::string_view(entries[i].text, entries[i].length));
+        }
+        if (!overrideDir.empty()) {
+            load_overrides(overrideDir);
+        }
+        LOG_INFO("Assets: " + std::to_string(g_sprites.size()) + " available (" +
+                 std::to_string(embedded::count()) + " embedded)");
+        return g_sprites.size();
+    }
+
+    const Sprite* find(const std::string& name) {
+        auto it = g_sprites.find(name);
+        return it == g_sprites.end() ? nullptr : &it->second;
+    }
+
+    std::pair<int, int> measure(std::string_view text) {
+        int height = 0;
+        int width = 0;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            ++height;
+            width = std::max(width, static_cast<int>(end - start));
+            start = end + 1;
+        }
+        return std::make_pair(height, width);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+// ASCII art registry. The art under assets/ascii is compiled into the binary
+// (embedded_assets.h), so startup opens no files; a directory given with
+// --asset-dir is read once on top of it, for modding. Assets are named by their
+// path relative to the asset root, without the extension ("title", "combat/rat").
+namespace assets {
+    struct Sprite {
+        std::string_view text;   // Lines joined by '\n', no trailing newline (static or arena storage)
+        int height = 0;          // Rows
+        int width = 0;           // Longest row in bytes
+    };
+
+    // Register the embedded assets, then every .txt under overrideDir (if set),
+    // replacing whatever was loaded before
+    // Returns: number of assets available
+    size_t load(const std::string& overrideDir = "");
+
+    // Registered asset, or nullptr if it was not found at load time
+    const Sprite* find(const std::string& name);
+
+    // (height, width) of multi-line text, counted the way std::getline splits it
+    std::pair<int, int> measure(std::string_view text);
+}
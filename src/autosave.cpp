@@ -0,0 +1,107 @@
+#include "autosave.h"
+#include "logger.h"
+#include "profiler.h"
+
+namespace {
+    // Point a copied floor's enemies at the copy's own occupancy grid (a
+    // FloorData copy's enemies still reference the original's)
+    void detach(FloorData& floor) {
+        floor.occupancy.rebuild(floor.dungeon.width(), floor.dungeon.height(), floor.enemies);
+    }
+}
+
+Autosaver::~Autosaver() {
+    stop();
+}
+
+bool Autosaver::start(int slot, const std::string& dbPath) {
+    if (running()) {
+        return true;
+    }
+    slot_ = slot;
+    bool ok = true;
+    if (!dbPath.empty() && !db_.open(dbPath)) {
+        LOG_WARN("Autosave: floors will not be saved (" + db_.last_error() + ")");
+        ok = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    thread_ = std::thread(&Autosaver::writer_loop, this);
+    return ok;
+}
+
+void Autosaver::submit(const GameState& state, const FloorData& liveFloor,
+                       const std::vector<traps::Trap>& traps) {
+    if (!running()) {
+        return;
+    }
+    PROF_ZONE("autosave_snapshot");
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->image = fileio::encode_save(state);
+    snapshot->floorNum = state.depth;
+    if (db_.is_open()) {
+        snapshot->liveFloor = liveFloor;
+        detach(snapshot->liveFloor);
+        snapshot->traps = traps;
+    }
+
+    std::unique_ptr<Snapshot> replaced;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        replaced = std::move(pending_);
+        pending_ = std::move(snapshot);
+    }
+    wake_.notify_one();
+    // An unwritten snapshot is freed here, outside the lock
+}
+
+void Autosaver::stop() {
+    if (!running()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    db_.close();
+}
+
+void Autosaver::writer_loop() {
+    for (;;) {
+        std::unique_ptr<Snapshot> snapshot;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return pending_ || stopping_; });
+            if (!pending_) {
+                return;   // Stopping with nothing left to write
+            }
+            snapshot = std::move(pending_);
+        }
+        write(*snapshot);
+    }
+}
+
+void Autosaver::write(Snapshot& snapshot) {
+    PROF_ZONE("autosave_write");
+    if (!fileio::write_slot_image(snapshot.image, slot_)) {
+        LOG_WARN("Autosave: could not write slot " + std::to_string(slot_));
+        return;
+    }
+
+    if (db_.is_open()) {
+        bool ok = db_.begin_transaction();
+        ok = ok && db_.save_floor(slot_, snapshot.floorNum, snapshot.liveFloor, snapshot.traps);
+        ok = ok && db_.commit_transaction();
+        if (!ok) {
+            db_.rollback_transaction();
+            LOG_WARN("Autosave: floors not saved (" + db_.last_error() + ")");
+        }
+    }
+
+    written_.fetch_add(1, std::memory_order_relaxed);
+    LOG_DEBUG("Autosave written to slot " + std::to_string(slot_));
+}
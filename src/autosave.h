@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "database.h"
+#include "fileio.h"
+#include "floor_manager.h"
+#include "traps.h"
+
+// Background autosave. submit() runs on the game thread and only takes a
+// snapshot: the slot's save image (fileio::encode_save) plus a copy of the
+// live floor and its traps. A writer thread then does the slow part - the slot file with its
+// fsync and rename, and one database transaction for the floor. Only the
+// newest snapshot matters, so one still queued when another arrives is
+// replaced rather than written.
+class Autosaver {
+public:
+    Autosaver() = default;
+    ~Autosaver();
+
+    Autosaver(const Autosaver&) = delete;
+    Autosaver& operator=(const Autosaver&) = delete;
+
+    // Start the writer thread. Images go to save slot `slot`; the live floor
+    // goes to the database at dbPath under the same slot (empty = image only).
+    // Returns false if the database cannot be opened (images are still written)
+    bool start(int slot, const std::string& dbPath = "");
+
+    // Snapshot and queue a save of the game state and the live floor (number
+    // state.depth) with its traps
+    void submit(const GameState& state, const FloorData& liveFloor,
+                const std::vector<traps::Trap>& traps);
+
+    // Write whatever is still queued, then stop the writer
+    void stop();
+
+    bool running() const { return thread_.joinable(); }
+    uint64_t saves_written() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    struct Snapshot {
+        std::vector<uint8_t> image;                                  // fileio save image
+        int floorNum = 0;
+        FloorData liveFloor;
+        std::vector<traps::Trap> traps;
+    };
+
+    void writer_loop();
+    void write(Snapshot& snapshot);
+
+    int slot_ = 1;
+    Database db_;                                      // Used only by the writer once started
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::unique_ptr<Snapshot> pending_;                // Guarded by mutex_
+    bool stopping_ = false;                            // Guarded by mutex_
+    std::atomic<uint64_t> written_{0};
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Little-endian encoding shared by the binary save formats (Database floor
+// blobs, save slot files). Fixed-width fields, strings prefixed with a 16-bit
+// length; the reader never reads past its buffer.
+
+// Appends to a caller-owned buffer, so several writers (and codecs such as
+// tile_codec) can build one contiguous image
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void u8(uint8_t v) { out_.push_back(v); }
+    void u16(uint16_t v) { u8(static_cast<uint8_t>(v)); u8(static_cast<uint8_t>(v >> 8)); }
+    void u32(uint32_t v) { u16(static_cast<uint16_t>(v)); u16(static_cast<uint16_t>(v >> 16)); }
+    void i32(int v) { u32(static_cast<uint32_t>(v)); }
+    void f32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u32(bits);
+    }
+    void str(const std::string& v) {
+        size_t length = std::min<size_t>(v.size(), 0xFFFF);
+        u16(static_cast<uint16_t>(length));
+        out_.insert(out_.end(), v.data(), v.data() + length);
+    }
+
+    // Current end of the buffer, and an in-place rewrite of a u32 written
+    // earlier (length prefixes filled in once the body is known)
+    size_t position() const { return out_.size(); }
+    void patch_u32(size_t at, uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            out_[at + static_cast<size_t>(i)] = static_cast<uint8_t>(v >> (8 * i));
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+// Bounds-checked reader over borrowed bytes (a blob column, a mapped file).
+// Reads past the end return zero and clear ok(), so callers check once after
+// decoding instead of after every field.
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool ok() const { return ok_; }
+    bool done() const { return ok_ && pos_ == size_; }
+    size_t remaining() const { return size_ - pos_; }
+
+    uint8_t u8() {
+        if (pos_ >= size_) { ok_ = false; return 0; }
+        return data_[pos_++];
+    }
+    uint16_t u16() { uint16_t lo = u8(); return static_cast<uint16_t>(lo | (u8() << 8)); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | (static_cast<uint32_t>(u16()) << 16); }
+    int i32() { return static_cast<int>(u32()); }
+    float f32() {
+        uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    std::string str() {
+        size_t length = u16();
+        if (length > remaining()) { ok_ = false; return {}; }
+        std::string v(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return v;
+    }
+
+    // Raw access for codecs and nested sections: the unread bytes, then how
+    // many of them were used
+    const uint8_t* cursor() const { return data_ + pos_; }
+    void skip(size_t n) {
+        if (n > remaining()) { ok_ = false; return; }
+        pos_ += n;
+    }
+
+    // Element count, rejected if the buffer is too short to hold that many
+    size_t count(size_t minBytesEach) {
+        size_t n = u16();
+        if (n * minBytesEach > remaining()) { ok_ = false; return 0; }
+        return n;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
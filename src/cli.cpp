@@ -32,14 +32,31 @@ void print_help(const char* programName) {
     std::cout << "  -d, --difficulty <lvl>  Set difficulty: easy, normal, hard (default: normal)\n";
     std::cout << "  --debug                 Enable debug mode (shows extra info)\n";
     std::cout << "  --log-file <path>       Write debug log to specified file\n";
+    std::cout << "  --log-level <lvl>       Lowest level logged: debug, info, warn, error (default: debug)\n";
+    std::cout << "  --profile <path>        Profile hot zones; write a Chrome trace to path, print p50/p95/p99 at exit\n";
     std::cout << "  --no-color              Disable ANSI color output\n";
     std::cout << "  --no-unicode            Use ASCII-only characters (no box-drawing)\n";
+    std::cout << "  --no-animations         Skip animations and effect delays\n";
+    std::cout << "  --asset-dir <path>      Load ASCII art from path over the built-in art\n";
+    std::cout << "  --headless              Play bot games without a terminal and print statistics\n";
+    std::cout << "  --runs <number>         Number of headless runs (default: 100)\n";
+    std::cout << "  --max-turns <number>    Turn limit per headless run (default: 5000)\n";
+    std::cout << "  --class <name>          Headless player class: warrior, rogue, mage (default: warrior)\n";
+    std::cout << "  --threads <number>      Headless worker threads, 0 = one per core (default: 1)\n";
+    std::cout << "  --autosave-turns <n>    Autosave in the background every n turns, 0 = only on exit (default: 25)\n";
+    std::cout << "  --record <path>         Record input for replay (default: saves/last.replay)\n";
+    std::cout << "  --no-record             Do not record input\n";
+    std::cout << "  --replay <path>         Play back a recorded game\n";
+    std::cout << "  --speed <normal|max>    Replay speed; max skips animation delays (default: normal)\n";
     std::cout << "\n";
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " --seed 12345\n";
     std::cout << "  " << programName << " --difficulty hard --debug\n";
     std::cout << "  " << programName << " --no-unicode --no-color\n";
     std::cout << "  " << programName << " --log-file game.log\n";
+    std::cout << "  " << programName << " --headless --runs 500 --seed 1\n";
+    std::cout << "  " << programName << " --replay saves/last.replay --speed max\n";
+    std::cout << "  " << programName << " --profile trace.json\n";
     std::cout << "\n";
     std::cout << "In-Game Controls:\n";
     std::cout << "  W/A/S/D or Arrows  Move player\n";
@@ -124,6 +141,36 @@ CLIConfig parse(int argc, char* argv[]) {
             continue;
         }
         
+        // Log level
+        if (std::strcmp(arg, "--log-level") == 0) {
+            static const char* const levels[] = {"debug", "info", "warn", "error"};
+            const char* lvl = (i + 1 < argc) ? argv[++i] : "";
+            int found = -1;
+            for (int l = 0; l < 4; ++l) {
+                if (std::strcmp(lvl, levels[l]) == 0) found = l;
+            }
+            if (found >= 0) {
+                config.logLevel = found;
+            } else {
+                LOG_ERROR(std::string("Error: Invalid log level '") + lvl + "'. Use: debug, info, warn, error");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
+        // Profiler trace
+        if (std::strcmp(arg, "--profile") == 0) {
+            if (i + 1 < argc) {
+                config.profileFile = argv[++i];
+            } else {
+                LOG_ERROR("Error: --profile requires a path argument");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
         // No color
         if (std::strcmp(arg, "--no-color") == 0) {
             config.noColor = true;
@@ -136,6 +183,123 @@ CLIConfig parse(int argc, char* argv[]) {
             continue;
         }
         
+        // No animations
+        if (std::strcmp(arg, "--no-animations") == 0) {
+            config.noAnimations = true;
+            continue;
+        }
+        
+        // Asset override directory
+        if (std::strcmp(arg, "--asset-dir") == 0) {
+            if (i + 1 < argc) {
+                config.assetDir = argv[++i];
+            } else {
+                LOG_ERROR("Error: --asset-dir requires a path argument");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
+        // Headless simulation
+        if (std::strcmp(arg, "--headless") == 0) {
+            config.headless = true;
+            continue;
+        }
+        
+        // Headless run count / turn limit
+        if (std::strcmp(arg, "--runs") == 0 || std::strcmp(arg, "--max-turns") == 0) {
+            int value = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+            if (value > 0) {
+                ++i;
+                (std::strcmp(arg, "--runs") == 0 ? config.runs : config.maxTurns) = value;
+            } else {
+                LOG_ERROR(std::string("Error: ") + arg + " requires a positive number");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
+        // Headless worker threads
+        if (std::strcmp(arg, "--threads") == 0) {
+            if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+                config.threads = std::atoi(argv[++i]);
+            } else {
+                LOG_ERROR("Error: --threads requires a number argument");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
+        // Autosave interval
+        if (std::strcmp(arg, "--autosave-turns") == 0) {
+            if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+                config.autosaveTurns = std::atoi(argv[++i]);
+            } else {
+                LOG_ERROR("Error: --autosave-turns requires a number argument");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
+        // Input recording / replay
+        if (std::strcmp(arg, "--record") == 0 || std::strcmp(arg, "--replay") == 0) {
+            if (i + 1 < argc) {
+                (std::strcmp(arg, "--record") == 0 ? config.recordFile : config.replayFile) = argv[++i];
+            } else {
+                LOG_ERROR(std::string("Error: ") + arg + " requires a path argument");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
+        if (std::strcmp(arg, "--no-record") == 0) {
+            config.recordFile.clear();
+            continue;
+        }
+        
+        // Replay speed
+        if (std::strcmp(arg, "--speed") == 0) {
+            const char* speed = (i + 1 < argc) ? argv[++i] : "";
+            if (std::strcmp(speed, "max") == 0) {
+                config.replayMaxSpeed = true;
+            } else if (std::strcmp(speed, "normal") == 0) {
+                config.replayMaxSpeed = false;
+            } else {
+                LOG_ERROR(std::string("Error: Invalid speed '") + speed + "'. Use: normal, max");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
+        // Headless player class
+        if (std::strcmp(arg, "--class") == 0) {
+            if (i + 1 < argc) {
+                const char* cls = argv[++i];
+                if (std::strcmp(cls, "warrior") == 0) {
+                    config.playerClass = 0;
+                } else if (std::strcmp(cls, "rogue") == 0) {
+                    config.playerClass = 1;
+                } else if (std::strcmp(cls, "mage") == 0) {
+                    config.playerClass = 2;
+                } else {
+                    LOG_ERROR(std::string("Error: Invalid class '") + cls + "'. Use: warrior, rogue, mage");
+                    config.exitRequested = true;
+                    config.exitCode = 1;
+                }
+            } else {
+                LOG_ERROR("Error: --class requires an argument");
+                config.exitRequested = true;
+                config.exitCode = 1;
+            }
+            continue;
+        }
+        
         // Unknown argument
         LOG_ERROR(std::string("Error: Unknown argument '") + arg + "'");
         LOG_ERROR("Use --help for usage information");
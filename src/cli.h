@@ -12,10 +12,29 @@ struct CLIConfig {
     // Display settings
     bool noColor = false;            // Disable ANSI colors
     bool noUnicode = false;          // Use ASCII-only characters
+    bool noAnimations = false;       // Show only the final frame of every animation
+    std::string assetDir;            // ASCII art overriding the built-in assets (empty = built-in only)
     
     // Debug settings
     bool debug = false;              // Enable debug mode
     std::string logFile;             // Log file path (empty = no logging)
+    int logLevel = 0;                // Lowest level logged: 0=debug, 1=info, 2=warn, 3=error
+    std::string profileFile;         // Chrome trace output of the zone profiler (empty = off)
+    
+    // Headless simulation
+    bool headless = false;           // Run bot games without a terminal and print stats
+    int runs = 100;                  // Number of headless runs (seeds seed..seed+runs-1)
+    int maxTurns = 5000;             // Turn limit per headless run
+    int playerClass = 0;             // 0=warrior, 1=rogue, 2=mage
+    int threads = 1;                 // Headless worker threads (0 = one per core)
+    
+    // Saving
+    int autosaveTurns = 25;          // Background autosave every N turns (0 = only on exit)
+    
+    // Input replay
+    std::string recordFile = "saves/last.replay";  // Where keys are recorded (empty = off)
+    std::string replayFile;          // Replay to play back instead of reading the keyboard
+    bool replayMaxSpeed = false;     // Skip animation delays during playback
     
     // Control flow
     bool showHelp = false;           // Show help and exit
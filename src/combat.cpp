@@ -69,7 +69,10 @@
      */
 #include "combat.h"
 #include "logger.h"
+#include "profiler.h"
 #include "ui.h"
+#include "assets.h"
+#include "animation.h"
 #include "input.h"
 #include "glyphs.h"
 #include "constants.h"
@@ -83,14 +86,12 @@
 #include <map>
 #include <unordered_set>
 #include <functional>
-#include <thread>
-#include <chrono>
 #include <cctype>
 
 namespace combat {
-    static std::mt19937& combat_rng() {
-        static std::mt19937 rng(std::random_device{}());
-        return rng;
+    // IMPROVED: Combat stream of the session bound to this thread
+    static Rng& combat_rng() {
+        return rngs::stream(rngs::Stream::Combat);
     }
 
     static bool roll_percentage(int percent) {
@@ -892,7 +893,7 @@ namespace combat {
                                    CombatDistance currentDistance, const Position3D& playerPos,
                                    const Position3D& enemyPos, const CombatArena* arena,
                                    const MessageLog& log) {
-        LOG_OP_START("show_combat_menu");
+        PROF_ZONE("show_combat_menu");
         
         // Get terminal size for layout calculation
         auto termSize = input::get_terminal_size();
@@ -1182,7 +1183,7 @@ namespace combat {
         std::cout << "Space: Wait   ESC: Cancel";
         ui::move_cursor(bottomSectionRow + bottomSectionHeight - 2, menuCol + 2);
         std::cout << "Choose action: ";
-        std::cout.flush();
+        // IMPROVED: No flush - read_key_blocking() submits the whole menu in one write
         
         LOG_DEBUG("Combat menu: Waiting for player input...");
         int inputAttempts = 0;
@@ -1192,21 +1193,18 @@ namespace combat {
                 LOG_DEBUG("Combat menu: Input attempt #" + std::to_string(inputAttempts));
             }
             
-            LOG_OP_START("read_key_blocking_combat");
             int key = input::read_key_blocking();
-            LOG_OP_END("read_key_blocking_combat");
             
             // Safety check: if read_key_blocking returns -1 (timeout/error), log and continue
             if (key == -1) {
                 LOG_WARN("Combat menu: read_key_blocking returned -1, retrying...");
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                ui::delay(10);
                 continue;
             }
             
             LOG_DEBUG("Combat menu: Received key: " + std::to_string(key));
             
             if (key == ' ' || key == 27) {
-                LOG_OP_END("show_combat_menu");
                 return CombatAction::WAIT;
             }
             
@@ -1226,7 +1224,6 @@ namespace combat {
                     if (binding.second == CombatAction::CONSUMABLE && consumableKeyToName.count(key)) {
                         g_lastSelectedConsumableName = consumableKeyToName[key];
                     }
-                    LOG_OP_END("show_combat_menu");
                     return binding.second;
                 }
             }
@@ -1459,9 +1456,7 @@ namespace combat {
         int retreatChance = 50 + speedDiff * 5;  // Base 50% + 5% per speed point
         retreatChance = std::max(20, std::min(90, retreatChance));  // Clamp 20-90%
         
-        std::random_device rd;
-        std::mt19937 rng(rd());
-        int roll = std::uniform_int_distribution<int>(0, 100)(rng);
+        int roll = std::uniform_int_distribution<int>(0, 100)(combat_rng());
         
         if (roll < retreatChance) {
             log.add(MessageType::Info, glyphs::arrow_left() + std::string(" You successfully retreat!"));
@@ -1472,8 +1467,21 @@ namespace combat {
         }
     }
 
+    // Queue a redraw of the combat viewport as it looks now. The combatants are
+    // copied, so turn logic that runs ahead of the timeline does not change
+    // what the animation shows.
+    static void queue_viewport_redraw(const Player& player, const Enemy& enemy, CombatDistance distance) {
+        anim::call([player, enemy, distance] {
+            auto termSize = input::get_terminal_size();
+            const int topViewportHeight = std::max(15, termSize.height / 2);
+            ui::clear();
+            ui::draw_combat_viewport(0, 0, termSize.width, topViewportHeight, player, enemy, distance);
+        });
+    }
+
     // Enter tactical combat mode - full combat loop with menu
     bool enter_combat_mode(Player& player, Enemy& enemy, Dungeon& dungeon, MessageLog& log) {
+        PROF_ZONE("enter_combat_mode");
         LOG_DEBUG("Entering tactical combat mode with " + enemy.name());
         
         // Initialize 3D positions
@@ -1550,6 +1558,11 @@ namespace combat {
                 }
             }
             
+            // IMPROVED: Turn animations run on the timeline while the turn logic
+            // has already finished; play out what is left before drawing the
+            // menu. A key press skips them and becomes the menu choice.
+            anim::finish();
+            
             // Clear screen and show combat UI
             ui::clear();
             
@@ -1559,10 +1572,8 @@ namespace combat {
             int menuCol = std::max(2, (termSize.width - 120) / 2);
             
             // Show combat menu with arena visualization
-            LOG_OP_START("combat_menu_call");
             CombatAction action = show_combat_menu(player, enemies, menuRow, menuCol, hasRangedWeapon, 
                                                    currentDistance, playerPos, enemyPos, &arena, log);
-            LOG_OP_END("combat_menu_call");
             
             // Handle WAIT action (cancel combat)
             if (action == CombatAction::WAIT) {
@@ -1623,26 +1634,23 @@ namespace combat {
                 const int topViewportHeight = std::max(15, termSize.height / 2);
                 
                 // Redraw viewport for animation
-                ui::clear();
-                ui::draw_combat_viewport(0, 0, termSize.width, topViewportHeight, player, enemy, currentDistance);
+                queue_viewport_redraw(player, enemy, currentDistance);
                 
                 // Get player sprite and calculate dimensions
-                std::string playerSprite = ui::get_player_sprite(player.player_class());
-                auto playerDims = ui::calculate_sprite_dimensions(playerSprite);
+                const assets::Sprite& playerSprite = ui::get_player_sprite(player.player_class());
                 int playerSpriteCol = termSize.width / 4;  // ~25% from left
-                int playerSpriteRow = topViewportHeight - playerDims.first - 3; // From bottom
+                int playerSpriteRow = topViewportHeight - playerSprite.height - 3; // From bottom
                 
                 // Get enemy sprite and calculate dimensions
-                std::string enemySprite = ui::get_enemy_sprite(enemy);
-                auto enemyDims = ui::calculate_sprite_dimensions(enemySprite);
+                const assets::Sprite& enemySprite = ui::get_enemy_sprite(enemy);
                 int enemySpriteCol = termSize.width * 2 / 3;  // ~67% from left
                 int enemySpriteRow = 2; // From top
                 
                 // Calculate center positions for projectiles
-                int playerCenterRow = playerSpriteRow + playerDims.first / 2;
-                int playerCenterCol = playerSpriteCol + playerDims.second / 2;
-                int enemyCenterRow = enemySpriteRow + enemyDims.first / 2;
-                int enemyCenterCol = enemySpriteCol + enemyDims.second / 2;
+                int playerCenterRow = playerSpriteRow + playerSprite.height / 2;
+                int playerCenterCol = playerSpriteCol + playerSprite.width / 2;
+                int enemyCenterRow = enemySpriteRow + enemySprite.height / 2;
+                int enemyCenterCol = enemySpriteCol + enemySprite.width / 2;
                 
                 std::string playerColor = constants::color_player;
                 std::string enemyColor = enemy.color().empty() ? "\033[91m" : enemy.color();
@@ -1667,26 +1675,27 @@ namespace combat {
                 } else if (pclass == PlayerClass::Rogue || attackType == AttackType::Ranged) {
                     // Rogue: Slide animation
                     ui::animate_rogue_slide(playerSpriteRow, playerSpriteCol, enemySpriteCol - 5, 
-                                          playerSprite, playerColor);
+                                          playerSprite.text, playerColor);
                 } else if (pclass == PlayerClass::Warrior) {
                     // Warrior: Charge animation
                     ui::animate_warrior_charge(playerSpriteRow, playerSpriteCol, enemySpriteCol - 5, 
-                                             playerSprite, playerColor);
+                                             playerSprite.text, playerColor);
                 } else {
                     // Default: Simple slide
-                    ui::animate_sprite_attack(playerSpriteRow, playerSpriteCol, playerSprite, playerColor, true);
+                    ui::animate_sprite_attack(playerSpriteRow, playerSpriteCol, playerSprite.text, playerColor, true);
                 }
                 
                 // Animate enemy shake after attack
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
-                ui::animate_sprite_shake(enemySpriteRow, enemySpriteCol, enemySprite, enemyColor, 2, 300);
+                anim::pause(200);
+                ui::animate_sprite_shake(enemySpriteRow, enemySpriteCol, enemySprite.text, enemyColor, 2, 300);
                 
                 // Don't clear screen here - wait until after damage is applied
             }
             
-            LOG_OP_START("execute_action");
-            combat::execute_action(player, enemies, ctx, log, dungeon, &arena);
-            LOG_OP_END("execute_action");
+            {
+                PROF_ZONE("execute_action");
+                combat::execute_action(player, enemies, ctx, log, dungeon, &arena);
+            }
             
             // Update enemy reference from vector (in case execute_action modified it)
             if (!enemies.empty()) {
@@ -1716,13 +1725,10 @@ namespace combat {
                 
                 // Redraw viewport to show current state (enemy at 0 HP) before death animation
                 auto termSizeForDeath = input::get_terminal_size();
-                const int topViewportHeightForDeath = std::max(15, termSizeForDeath.height / 2);
-                ui::clear();
-                ui::draw_combat_viewport(0, 0, termSizeForDeath.width, topViewportHeightForDeath, player, enemy, currentDistance);
+                queue_viewport_redraw(player, enemy, currentDistance);
                 
                 // Get enemy sprite position for explosion (must match viewport positioning)
-                std::string enemySpriteForDeath = ui::get_enemy_sprite(enemy);
-                auto enemyDimsForDeath = ui::calculate_sprite_dimensions(enemySpriteForDeath);
+                const assets::Sprite& enemySpriteForDeath = ui::get_enemy_sprite(enemy);
                 
                 // Match the positioning used in draw_combat_viewport exactly
                 // In draw_combat_viewport:
@@ -1733,18 +1739,17 @@ namespace combat {
                 int enemySpriteColForDeath = termSizeForDeath.width * 2 / 3;  // Match draw_combat_viewport
                 
                 // Calculate center of enemy sprite for explosion
-                // enemyDims.first = height (rows), enemyDims.second = width (columns)
-                int explosionRow = enemySpriteRowForDeath + enemyDimsForDeath.first / 2;
-                int explosionCol = enemySpriteColForDeath + enemyDimsForDeath.second / 2;
+                int explosionRow = enemySpriteRowForDeath + enemySpriteForDeath.height / 2;
+                int explosionCol = enemySpriteColForDeath + enemySpriteForDeath.width / 2;
                 
                 // Brief pause before explosion
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                anim::pause(200);
                 
                 // Play explosion animation at enemy center
                 ui::animate_explosion(explosionRow, explosionCol, "\033[91m");  // Red explosion
                 
                 // Brief pause to show death
-                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                anim::pause(300);
                 
                 // Add victory message
                 log.add(MessageType::Combat, enemy.name() + " defeated!");
@@ -1784,27 +1789,24 @@ namespace combat {
                         // Show telegraph warning
                         log.add(MessageType::Warning, glyphs::warning() + std::string(" ") + enemy.name() + " is preparing a heavy attack...");
                         ui::flash_warning();
-                        std::this_thread::sleep_for(std::chrono::milliseconds(500));  // Pause for visibility
+                        anim::pause(500);  // Pause for visibility
                     }
                     
                     // Animate enemy attack
                     auto termSizeForEnemyAnim = input::get_terminal_size();
                     const int topViewportHeightForEnemyAnim = std::max(15, termSizeForEnemyAnim.height / 2);
-                    ui::clear();
-                    ui::draw_combat_viewport(0, 0, termSizeForEnemyAnim.width, topViewportHeightForEnemyAnim, player, enemy, currentDistance);
+                    queue_viewport_redraw(player, enemy, currentDistance);
                     
                     // Get enemy sprite and calculate dimensions
-                    std::string enemySprite = ui::get_enemy_sprite(enemy);
-                    auto enemyDims = ui::calculate_sprite_dimensions(enemySprite);
+                    const assets::Sprite& enemySprite = ui::get_enemy_sprite(enemy);
                     std::string enemyColor = enemy.color().empty() ? "\033[91m" : enemy.color();
                     int enemySpriteCol = termSizeForEnemyAnim.width * 2 / 3;  // Match viewport positioning
                     int enemySpriteRow = 2; // From top
                     
                     // Get player sprite and calculate dimensions for shake animation
-                    std::string playerSprite = ui::get_player_sprite(player.player_class());
-                    auto playerDims = ui::calculate_sprite_dimensions(playerSprite);
+                    const assets::Sprite& playerSprite = ui::get_player_sprite(player.player_class());
                     int playerSpriteCol = termSizeForEnemyAnim.width / 4;  // Match viewport positioning
-                    int playerSpriteRow = topViewportHeightForEnemyAnim - playerDims.first - 3; // From bottom
+                    int playerSpriteRow = topViewportHeightForEnemyAnim - playerSprite.height - 3; // From bottom
                     std::string playerColor = constants::color_player;
                     
                     // Check if enemy is ranged or melee
@@ -1814,24 +1816,24 @@ namespace combat {
                     
                     if (isRangedEnemy) {
                         // Ranged enemy: projectile animation
-                        int enemyCenterRow = enemySpriteRow + enemyDims.first / 2;
-                        int enemyCenterCol = enemySpriteCol + enemyDims.second / 2;
-                        int playerCenterRow = playerSpriteRow + playerDims.first / 2;
-                        int playerCenterCol = playerSpriteCol + playerDims.second / 2;
+                        int enemyCenterRow = enemySpriteRow + enemySprite.height / 2;
+                        int enemyCenterCol = enemySpriteCol + enemySprite.width / 2;
+                        int playerCenterRow = playerSpriteRow + playerSprite.height / 2;
+                        int playerCenterCol = playerSpriteCol + playerSprite.width / 2;
                         ui::animate_projectile(enemyCenterRow, enemyCenterCol, playerCenterRow, playerCenterCol,
                                               "→", enemyColor);
                         ui::animate_explosion(playerCenterRow, playerCenterCol, enemyColor);
                     } else {
                         // Melee enemy: slide animation
-                        ui::animate_sprite_attack(enemySpriteRow, enemySpriteCol, enemySprite, enemyColor, false);
+                        ui::animate_sprite_attack(enemySpriteRow, enemySpriteCol, enemySprite.text, enemyColor, false);
                     }
                     
                     // Animate player shake
-                    std::this_thread::sleep_for(std::chrono::milliseconds(200));
-                    ui::animate_sprite_shake(playerSpriteRow, playerSpriteCol, playerSprite, playerColor, 2, 300);
+                    anim::pause(200);
+                    ui::animate_sprite_shake(playerSpriteRow, playerSpriteCol, playerSprite.text, playerColor, 2, 300);
                     
                     // Redraw viewport after animation
-                    ui::clear();
+                    anim::call(ui::clear);
                     
                     // Enemy attacks player
                     combat::melee(player, enemy, log, currentDistance);
@@ -1853,19 +1855,91 @@ namespace combat {
             player.tick_statuses();
             
             // Small delay for readability
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            anim::pause(100);
         }
         
+        // Finish the closing animations (death explosion) before the map returns
+        anim::finish();
+        
         // Return true if player won or retreated, false if player died
         return playerWon;
     }
 
+    // Headless tactical combat (batch simulation)
+    bool auto_resolve_combat(Player& player, Enemy& enemy, Dungeon& dungeon, MessageLog& log,
+                             const ActionChooser& choose, int maxRounds) {
+        Position3D playerPos;
+        playerPos.x = player.get_position().x;
+        playerPos.y = player.get_position().y;
+        playerPos.depth = 0;
+        
+        Position3D enemyPos;
+        enemyPos.x = enemy.get_position().x;
+        enemyPos.y = enemy.get_position().y;
+        enemyPos.depth = 0;
+        
+        CombatDistance currentDistance = calculate_combat_distance(playerPos, enemyPos);
+        std::vector<Enemy> enemies;
+        
+        for (int round = 0; round < maxRounds; ++round) {
+            if (player.get_stats().hp <= 0) {
+                return false;
+            }
+            if (enemy.stats().hp <= 0) {
+                return true;
+            }
+            
+            enemies.clear();
+            enemies.push_back(enemy);
+            
+            CombatContext ctx;
+            ctx.targetIndex = 0;
+            ctx.consumableUsedIndex = -1;
+            ctx.action = choose(player, enemy, currentDistance, ctx.consumableUsedIndex);
+            ctx.playerPos = playerPos;
+            ctx.enemyPos = enemyPos;
+            ctx.currentDistance = currentDistance;
+            
+            combat::execute_action(player, enemies, ctx, log, dungeon, nullptr);
+            if (!enemies.empty()) {
+                enemy = enemies[0];
+            }
+            playerPos = ctx.playerPos;
+            enemyPos = ctx.enemyPos;
+            currentDistance = ctx.currentDistance;
+            
+            if (enemy.stats().hp <= 0) {
+                log.add(MessageType::Combat, enemy.name() + " defeated!");
+                return true;
+            }
+            if (player.get_stats().hp <= 0) {
+                return false;
+            }
+            
+            // Enemy turn: melee when adjacent, otherwise close in
+            Position ep = enemy.get_position();
+            Position pp = player.get_position();
+            if (std::abs(ep.x - pp.x) + std::abs(ep.y - pp.y) == 1) {
+                combat::melee(player, enemy, log, currentDistance);
+            } else {
+                ai::take_turn(enemy, player, dungeon, log);
+                enemyPos.x = enemy.get_position().x;
+                enemyPos.y = enemy.get_position().y;
+                currentDistance = calculate_combat_distance(playerPos, enemyPos);
+            }
+            
+            player.tick_cooldowns();
+            player.tick_statuses();
+        }
+        LOG_DEBUG("auto_resolve_combat: round limit reached against " + enemy.name());
+        return enemy.stats().hp <= 0;
+    }
+
     // Apply weapon affixes during combat
     void apply_weapon_affixes(const Item& weapon, Enemy& target, Player& attacker, MessageLog& log) {
         if (weapon.affix == ItemAffix::NONE) return;
         
-        std::random_device rd;
-        std::mt19937 rng(rd());
+        Rng& rng = combat_rng();
         
         switch (weapon.affix) {
             case ItemAffix::LIFESTEAL: {
@@ -1968,9 +2042,7 @@ namespace combat {
             
             case ItemAffix::EVASION: {
                 // 20% chance to completely dodge
-                std::random_device rd;
-                std::mt19937 rng(rd());
-                if (std::uniform_int_distribution<int>(0, 100)(rng) < 20) {
+                if (std::uniform_int_distribution<int>(0, 100)(combat_rng()) < 20) {
                     finalDamage = 0;
                     log.add(MessageType::Combat, glyphs::arrow_right() + std::string(" Dodged!"));
                 }
@@ -2035,7 +2107,7 @@ bool CombatArena::apply_hazard(const Position3D& pos, Player& player, MessageLog
     return false;
 }
 
-CombatArena CombatArena::generate_random(int hazardCount, const Dungeon& dungeon, std::mt19937& rng) {
+CombatArena CombatArena::generate_random(int hazardCount, const Dungeon& dungeon, Rng& rng) {
     CombatArena arena;
     std::uniform_int_distribution<int> hazardDist(0, 4);  // 5 hazard types (excluding NONE)
     std::uniform_int_distribution<int> xDist(1, dungeon.width() - 2);
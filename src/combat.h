@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 #include "player.h"
 #include "enemy.h"
 #include "ui.h"
@@ -111,6 +112,17 @@ namespace combat {
     // Returns: true if player won/retreated, false if player died
     bool enter_combat_mode(Player& player, Enemy& enemy, Dungeon& dungeon, MessageLog& log);
     
+    // Picks the player's action for a headless combat round; set consumableIndex
+    // (inventory index) when returning CombatAction::CONSUMABLE
+    using ActionChooser = std::function<CombatAction(const Player& player, const Enemy& enemy,
+                                                     CombatDistance distance, int& consumableIndex)>;
+    
+    // Headless tactical combat - same turn order as enter_combat_mode, with the
+    // player's action supplied by a callback and no menus, drawing or delays
+    // Returns: true if the enemy died, false if the player died or maxRounds ran out
+    bool auto_resolve_combat(Player& player, Enemy& enemy, Dungeon& dungeon, MessageLog& log,
+                             const ActionChooser& choose, int maxRounds = 200);
+    
     // Apply weapon affixes during combat
     void apply_weapon_affixes(const Item& weapon, Enemy& target, Player& attacker, MessageLog& log);
     
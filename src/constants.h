@@ -101,6 +101,9 @@ namespace constants {
     // Very far (7+): Almost invisible (fog of war edge)
     inline const std::string shade_fog = "\033[38;5;232m";        // Near black
 
+    // Explored but out of sight: terrain remembered from an earlier visit
+    inline const std::string shade_remembered = "\033[38;5;59m";  // Slate gray
+
     // ==========================================================
     // MESSAGE TYPE COLORS
     // ==========================================================
@@ -166,12 +169,19 @@ namespace game_constants {
     constexpr int MIN_SAVE_SLOT = 1;
     constexpr int MAX_SAVE_SLOT = 3;
     constexpr int CORPSE_SAVE_SLOT = 2; // Special slot for corpse run data
+    constexpr int AUTOSAVE_INTERVAL_TURNS = 25; // Default for --autosave-turns
+    constexpr const char* FLOOR_DATABASE_PATH = "saves/floors.db"; // Floors of each save slot
     
     // Boss floor depths
     constexpr int BOSS_FLOOR_1 = 2;
     constexpr int BOSS_FLOOR_2 = 4;
     constexpr int BOSS_FLOOR_3 = 6; // Final boss (6 floors total)
     
+    // Largest map the game builds (width = 30 + depth*10, height = 15 + depth*5
+    // on the final floor); loaders reject stored maps beyond this
+    constexpr int MAX_MAP_WIDTH = 30 + BOSS_FLOOR_3 * 10;
+    constexpr int MAX_MAP_HEIGHT = 15 + BOSS_FLOOR_3 * 5;
+    
     // Enemy spawning limits
     constexpr int MAX_ENEMIES_PER_FLOOR = 1000; // Safety limit
     constexpr int MAX_INVENTORY_SIZE = 1000; // Safety limit
@@ -193,6 +203,10 @@ namespace game_constants {
     constexpr int BOSS_SPAWN_SEARCH_RADIUS = 3;
     constexpr int MAX_SPAWN_ATTEMPTS = 100;
     
+    // AI cooldowns, counted in enemy turns so behaviour does not depend on frame rate
+    constexpr int ARCHER_SHOT_COOLDOWN_TURNS = 4;    // Was 4 seconds of wall-clock time
+    constexpr int BOSS_MESSAGE_COOLDOWN_TURNS = 5;   // Was 5 seconds of wall-clock time
+    
     // Enemy scaling
     constexpr int ENEMY_HP_SCALING_PER_DEPTH = 1;
     constexpr int ENEMY_ATK_SCALING_DIVISOR = 2; // depth / 2
@@ -200,6 +214,7 @@ namespace game_constants {
     // UI constants
     constexpr int UI_HEARTBEAT_INTERVAL_SECONDS = 5;
     constexpr int UI_FRAME_LOG_INTERVAL = 100;
+    constexpr int UI_SHRINE_MESSAGE_FRAMES = 60;  // ~1 second of idle 16ms frames between shrine messages
     constexpr int UI_STATUS_FRAME_HEIGHT = 3;
     constexpr int UI_MESSAGE_FRAME_HEIGHT = 5;
     constexpr int UI_BORDER_WIDTH = 2;
@@ -1,12 +1,51 @@
 #include "database.h"
 #include "logger.h"
+#include "tile_codec.h"
+#include "byte_io.h"
+#include "constants.h"
 #include "../lib/sqlite3.h"
+#include <algorithm>
 #include <cstring>
-#include <sstream>
 
 // Global instance
 static Database g_database;
 
+namespace {
+    // Resets a cached statement and clears its bindings when it goes out of
+    // scope, so it is ready for its next use on every return path
+    class StatementReset {
+    public:
+        explicit StatementReset(sqlite3_stmt* stmt) : stmt_(stmt) {}
+        ~StatementReset() {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+        }
+        StatementReset(const StatementReset&) = delete;
+        StatementReset& operator=(const StatementReset&) = delete;
+
+    private:
+        sqlite3_stmt* stmt_;
+    };
+
+    void bind_blob(sqlite3_stmt* stmt, int index, const std::vector<uint8_t>& data) {
+        // SQLITE_STATIC: the vector outlives the step that reads it
+        sqlite3_bind_blob(stmt, index, data.data(), static_cast<int>(data.size()), SQLITE_STATIC);
+    }
+
+    void bind_text(sqlite3_stmt* stmt, int index, const std::string& text) {
+        sqlite3_bind_text(stmt, index, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+    }
+
+    // Leads every floor blob; bump when a layout changes (older blobs are rejected)
+    constexpr uint8_t FLOOR_FORMAT_VERSION = 2;
+
+    // Blob column as (pointer, size); an empty or NULL column is (nullptr, 0)
+    std::pair<const uint8_t*, size_t> column_blob(sqlite3_stmt* stmt, int column) {
+        const void* data = sqlite3_column_blob(stmt, column);
+        return {static_cast<const uint8_t*>(data), static_cast<size_t>(sqlite3_column_bytes(stmt, column))};
+    }
+}
+
 namespace game {
     Database& db() {
         return g_database;
@@ -34,11 +73,19 @@ bool Database::open(const std::string& path) {
     }
     
     LOG_INFO("Database opened: " + path);
+    
+    // IMPROVED: Write-ahead log - a commit appends to the WAL with one fsync
+    // instead of journalling and rewriting pages, and readers never block on it
+    execute("PRAGMA journal_mode=WAL");
     return init_schema();
 }
 
 void Database::close() {
     if (db_) {
+        for (auto& entry : statements_) {
+            sqlite3_finalize(entry.second);
+        }
+        statements_.clear();
         sqlite3_close(db_);
         db_ = nullptr;
         LOG_INFO("Database closed");
@@ -61,35 +108,37 @@ bool Database::execute(const std::string& sql) {
     return true;
 }
 
-bool Database::query(const std::string& sql, 
-                     std::function<void(int argc, char** argv, char** colNames)> callback) {
-    if (!db_) return false;
-    
-    struct CallbackData {
-        std::function<void(int, char**, char**)>* fn;
-    };
-    
-    CallbackData data{&callback};
-    
-    auto sqliteCallback = [](void* userData, int argc, char** argv, char** colNames) -> int {
-        auto* data = static_cast<CallbackData*>(userData);
-        (*data->fn)(argc, argv, colNames);
-        return 0;
-    };
+sqlite3_stmt* Database::prepare(const char* sql) {
+    if (!db_) return nullptr;
     
-    char* errMsg = nullptr;
-    int rc = sqlite3_exec(db_, sql.c_str(), sqliteCallback, &data, &errMsg);
+    auto it = statements_.find(sql);
+    if (it != statements_.end()) {
+        return it->second;
+    }
     
-    if (rc != SQLITE_OK) {
-        lastError_ = errMsg ? errMsg : "Unknown error";
-        LOG_ERROR("SQL query error: " + lastError_);
-        sqlite3_free(errMsg);
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        set_error("SQL prepare error");
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+    statements_.emplace(sql, stmt);
+    return stmt;
+}
+
+bool Database::step_done(sqlite3_stmt* stmt) {
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        set_error("SQL error");
         return false;
     }
-    
     return true;
 }
 
+void Database::set_error(const char* context) {
+    lastError_ = db_ ? sqlite3_errmsg(db_) : "Database not open";
+    LOG_ERROR(std::string(context) + ": " + lastError_);
+}
+
 bool Database::init_schema() {
     // Players table
     if (!execute(R"(
@@ -126,9 +175,13 @@ bool Database::init_schema() {
             stairs_down_x INTEGER,
             stairs_down_y INTEGER,
             visited INTEGER DEFAULT 1,
+            traps_data BLOB,
+            cleared INTEGER DEFAULT 0,
+            seed INTEGER DEFAULT 0,
             UNIQUE(save_slot, floor_num)
         )
     )")) return false;
+    if (!upgrade_floors_table()) return false;
     
     // Corpses table
     if (!execute(R"(
@@ -164,24 +217,74 @@ bool Database::init_schema() {
     return true;
 }
 
+bool Database::upgrade_floors_table() {
+    static const char* const ADDED_COLUMNS[][2] = {
+        {"traps_data", "ALTER TABLE floors ADD COLUMN traps_data BLOB"},
+        {"cleared", "ALTER TABLE floors ADD COLUMN cleared INTEGER DEFAULT 0"},
+        {"seed", "ALTER TABLE floors ADD COLUMN seed INTEGER DEFAULT 0"},
+    };
+    
+    std::vector<std::string> columns;
+    {
+        sqlite3_stmt* stmt = prepare("PRAGMA table_info(floors)");
+        if (!stmt) return false;
+        StatementReset reset(stmt);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            columns.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+        }
+    }
+    for (const auto& column : ADDED_COLUMNS) {
+        if (std::find(columns.begin(), columns.end(), column[0]) == columns.end() &&
+            !execute(column[1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Database::begin_transaction() {
+    sqlite3_stmt* stmt = prepare("BEGIN IMMEDIATE");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    return step_done(stmt);
+}
+
+bool Database::commit_transaction() {
+    sqlite3_stmt* stmt = prepare("COMMIT");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    return step_done(stmt);
+}
+
+void Database::rollback_transaction() {
+    // Not cached: a failed statement may have rolled back already, and then
+    // ROLLBACK fails harmlessly
+    if (db_ && sqlite3_get_autocommit(db_) == 0) {
+        execute("ROLLBACK");
+    }
+}
+
 bool Database::save_player(int saveSlot, const Player& player, int floor, unsigned int seed) {
-    std::stringstream ss;
-    ss << "INSERT OR REPLACE INTO players "
-       << "(save_slot, name, player_class, hp, max_hp, attack, defense, speed, floor, seed, updated_at) "
-       << "VALUES ("
-       << saveSlot << ", "
-       << "'Player', "
-       << static_cast<int>(player.player_class()) << ", "
-       << player.get_stats().hp << ", "
-       << player.get_stats().maxHp << ", "
-       << player.get_stats().attack << ", "
-       << player.get_stats().defense << ", "
-       << player.get_stats().speed << ", "
-       << floor << ", "
-       << seed << ", "
-       << "CURRENT_TIMESTAMP)";
-    
-    if (execute(ss.str())) {
+    sqlite3_stmt* stmt = prepare(
+        "INSERT OR REPLACE INTO players "
+        "(save_slot, name, player_class, hp, max_hp, attack, defense, speed, floor, seed, updated_at) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, CURRENT_TIMESTAMP)");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    
+    const auto& stats = player.get_stats();
+    sqlite3_bind_int(stmt, 1, saveSlot);
+    sqlite3_bind_text(stmt, 2, "Player", -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 3, static_cast<int>(player.player_class()));
+    sqlite3_bind_int(stmt, 4, stats.hp);
+    sqlite3_bind_int(stmt, 5, stats.maxHp);
+    sqlite3_bind_int(stmt, 6, stats.attack);
+    sqlite3_bind_int(stmt, 7, stats.defense);
+    sqlite3_bind_int(stmt, 8, stats.speed);
+    sqlite3_bind_int(stmt, 9, floor);
+    sqlite3_bind_int64(stmt, 10, seed);   // Unsigned 32-bit does not fit an int
+    
+    if (step_done(stmt)) {
         LOG_INFO("Saved player to slot " + std::to_string(saveSlot));
         return true;
     }
@@ -189,277 +292,504 @@ bool Database::save_player(int saveSlot, const Player& player, int floor, unsign
 }
 
 bool Database::load_player(int saveSlot, Player& player, int& floor, unsigned int& seed) {
-    bool found = false;
-    
-    std::stringstream ss;
-    ss << "SELECT player_class, hp, max_hp, attack, defense, speed, floor, seed "
-       << "FROM players WHERE save_slot = " << saveSlot;
-    
-    query(ss.str(), [&](int argc, char** argv, char**) {
-        if (argc >= 8 && argv[0]) {
-            PlayerClass pclass = static_cast<PlayerClass>(std::stoi(argv[0]));
-            player = Player(pclass);
-            
-            auto& stats = player.get_stats();
-            stats.hp = std::stoi(argv[1]);
-            stats.maxHp = std::stoi(argv[2]);
-            stats.attack = std::stoi(argv[3]);
-            stats.defense = std::stoi(argv[4]);
-            stats.speed = std::stoi(argv[5]);
-            
-            floor = std::stoi(argv[6]);
-            seed = static_cast<unsigned int>(std::stoul(argv[7]));
-            
-            found = true;
-        }
-    });
-    
-    if (found) {
-        LOG_INFO("Loaded player from slot " + std::to_string(saveSlot));
+    sqlite3_stmt* stmt = prepare(
+        "SELECT player_class, hp, max_hp, attack, defense, speed, floor, seed "
+        "FROM players WHERE save_slot = ?");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    sqlite3_bind_int(stmt, 1, saveSlot);
+    
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return false;
     }
-    return found;
+    
+    PlayerClass pclass = static_cast<PlayerClass>(sqlite3_column_int(stmt, 0));
+    player = Player(pclass);
+    
+    auto& stats = player.get_stats();
+    stats.hp = sqlite3_column_int(stmt, 1);
+    stats.maxHp = sqlite3_column_int(stmt, 2);
+    stats.attack = sqlite3_column_int(stmt, 3);
+    stats.defense = sqlite3_column_int(stmt, 4);
+    stats.speed = sqlite3_column_int(stmt, 5);
+    
+    floor = sqlite3_column_int(stmt, 6);
+    seed = static_cast<unsigned int>(sqlite3_column_int64(stmt, 7));
+    
+    LOG_INFO("Loaded player from slot " + std::to_string(saveSlot));
+    return true;
 }
 
 bool Database::delete_save(int saveSlot) {
-    std::stringstream ss;
-    ss << "DELETE FROM players WHERE save_slot = " << saveSlot;
-    if (!execute(ss.str())) return false;
-    
-    ss.str("");
-    ss << "DELETE FROM floors WHERE save_slot = " << saveSlot;
-    execute(ss.str());
+    {
+        sqlite3_stmt* stmt = prepare("DELETE FROM players WHERE save_slot = ?");
+        if (!stmt) return false;
+        StatementReset reset(stmt);
+        sqlite3_bind_int(stmt, 1, saveSlot);
+        if (!step_done(stmt)) return false;
+    }
+    {
+        sqlite3_stmt* stmt = prepare("DELETE FROM floors WHERE save_slot = ?");
+        if (stmt) {
+            StatementReset reset(stmt);
+            sqlite3_bind_int(stmt, 1, saveSlot);
+            step_done(stmt);
+        }
+    }
     
     LOG_INFO("Deleted save slot " + std::to_string(saveSlot));
     return true;
 }
 
 bool Database::has_save(int saveSlot) {
-    bool exists = false;
-    
-    std::stringstream ss;
-    ss << "SELECT 1 FROM players WHERE save_slot = " << saveSlot << " LIMIT 1";
-    
-    query(ss.str(), [&](int argc, char** argv, char**) {
-        if (argc > 0 && argv[0]) {
-            exists = true;
-        }
-    });
-    
-    return exists;
+    sqlite3_stmt* stmt = prepare("SELECT 1 FROM players WHERE save_slot = ? LIMIT 1");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    sqlite3_bind_int(stmt, 1, saveSlot);
+    return sqlite3_step(stmt) == SQLITE_ROW;
 }
 
-bool Database::save_floor(int saveSlot, int floorNum, const Dungeon& dungeon,
-                          const std::vector<Enemy>& enemies) {
-    auto dungeonData = serialize_dungeon(dungeon);
-    auto enemiesData = serialize_enemies(enemies);
-    
-    // For simplicity, we'll store as hex strings (proper implementation would use prepared statements)
-    std::stringstream dungeonHex, enemiesHex;
-    for (uint8_t b : dungeonData) {
-        dungeonHex << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(b);
-    }
-    for (uint8_t b : enemiesData) {
-        enemiesHex << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(b);
+bool Database::save_floor(int saveSlot, int floorNum, const FloorData& floor,
+                          const std::vector<traps::Trap>& traps) {
+    auto dungeonData = serialize_dungeon(floor.dungeon);
+    auto enemiesData = serialize_enemies(floor.enemies);
+    auto itemsData = serialize_items(floor.items);
+    auto trapsData = serialize_traps(traps);
+    
+    sqlite3_stmt* stmt = prepare(
+        "INSERT OR REPLACE INTO floors (save_slot, floor_num, dungeon_data, enemies_data, items_data, "
+        "traps_data, stairs_up_x, stairs_up_y, stairs_down_x, stairs_down_y, visited, cleared, seed) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    
+    sqlite3_bind_int(stmt, 1, saveSlot);
+    sqlite3_bind_int(stmt, 2, floorNum);
+    bind_blob(stmt, 3, dungeonData);
+    bind_blob(stmt, 4, enemiesData);
+    bind_blob(stmt, 5, itemsData);
+    bind_blob(stmt, 6, trapsData);
+    sqlite3_bind_int(stmt, 7, floor.stairsUp.x);
+    sqlite3_bind_int(stmt, 8, floor.stairsUp.y);
+    sqlite3_bind_int(stmt, 9, floor.stairsDown.x);
+    sqlite3_bind_int(stmt, 10, floor.stairsDown.y);
+    sqlite3_bind_int(stmt, 11, floor.visited ? 1 : 0);
+    sqlite3_bind_int(stmt, 12, floor.cleared ? 1 : 0);
+    sqlite3_bind_int64(stmt, 13, floor.seed);
+    return step_done(stmt);
+}
+
+bool Database::load_floor(int saveSlot, int floorNum, FloorData& floor,
+                          std::vector<traps::Trap>* traps) {
+    sqlite3_stmt* stmt = prepare(
+        "SELECT dungeon_data, enemies_data, items_data, traps_data, stairs_up_x, stairs_up_y, "
+        "stairs_down_x, stairs_down_y, visited, cleared, seed "
+        "FROM floors WHERE save_slot = ? AND floor_num = ?");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    sqlite3_bind_int(stmt, 1, saveSlot);
+    sqlite3_bind_int(stmt, 2, floorNum);
+    
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return false;
     }
     
-    std::stringstream ss;
-    ss << "INSERT OR REPLACE INTO floors "
-       << "(save_slot, floor_num, dungeon_data, enemies_data) "
-       << "VALUES ("
-       << saveSlot << ", "
-       << floorNum << ", "
-       << "X'" << dungeonHex.str() << "', "
-       << "X'" << enemiesHex.str() << "')";
+    // Decode into locals first so a corrupt row leaves floor untouched
+    Dungeon dungeon;
+    std::vector<Enemy> enemies;
+    std::vector<Item> items;
+    std::vector<traps::Trap> loadedTraps;
+    auto dungeonBlob = column_blob(stmt, 0);
+    auto enemiesBlob = column_blob(stmt, 1);
+    auto itemsBlob = column_blob(stmt, 2);
+    auto trapsBlob = column_blob(stmt, 3);
+    if (!deserialize_dungeon(dungeonBlob.first, dungeonBlob.second, dungeon) ||
+        !deserialize_enemies(enemiesBlob.first, enemiesBlob.second, enemies) ||
+        !deserialize_items(itemsBlob.first, itemsBlob.second, items) ||
+        (traps && !deserialize_traps(trapsBlob.first, trapsBlob.second, loadedTraps))) {
+        lastError_ = "Corrupt floor data";
+        LOG_ERROR("Floor " + std::to_string(floorNum) + " in slot " + std::to_string(saveSlot) +
+                  ": " + lastError_);
+        return false;
+    }
     
-    return execute(ss.str());
-}
-
-bool Database::load_floor(int saveSlot, int floorNum, Dungeon& dungeon,
-                          std::vector<Enemy>& enemies) {
-    // Placeholder - would need proper blob handling
-    (void)saveSlot;
-    (void)floorNum;
-    (void)dungeon;
-    (void)enemies;
-    return false;
+    floor.dungeon = std::move(dungeon);
+    floor.enemies = std::move(enemies);
+    floor.items = std::move(items);
+    floor.stairsUp = {sqlite3_column_int(stmt, 4), sqlite3_column_int(stmt, 5)};
+    floor.stairsDown = {sqlite3_column_int(stmt, 6), sqlite3_column_int(stmt, 7)};
+    floor.visited = sqlite3_column_int(stmt, 8) != 0;
+    floor.cleared = sqlite3_column_int(stmt, 9) != 0;
+    floor.seed = static_cast<unsigned int>(sqlite3_column_int64(stmt, 10));
+    floor.occupancy.rebuild(floor.dungeon.width(), floor.dungeon.height(), floor.enemies);
+    if (traps) {
+        *traps = std::move(loadedTraps);
+    }
+    return true;
 }
 
 bool Database::delete_floor(int saveSlot, int floorNum) {
-    std::stringstream ss;
-    ss << "DELETE FROM floors WHERE save_slot = " << saveSlot 
-       << " AND floor_num = " << floorNum;
-    return execute(ss.str());
+    sqlite3_stmt* stmt = prepare("DELETE FROM floors WHERE save_slot = ? AND floor_num = ?");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    sqlite3_bind_int(stmt, 1, saveSlot);
+    sqlite3_bind_int(stmt, 2, floorNum);
+    return step_done(stmt);
 }
 
 bool Database::save_corpse(const CorpseData& corpse) {
-    std::stringstream ss;
-    ss << "INSERT INTO corpses (floor, x, y, death_cause, has_loot) VALUES ("
-       << corpse.floor << ", "
-       << corpse.position.x << ", "
-       << corpse.position.y << ", "
-       << static_cast<int>(corpse.cause) << ", "
-       << (corpse.hasLoot ? 1 : 0) << ")";
-    return execute(ss.str());
+    sqlite3_stmt* stmt = prepare(
+        "INSERT INTO corpses (floor, x, y, death_cause, has_loot) VALUES (?, ?, ?, ?, ?)");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    sqlite3_bind_int(stmt, 1, corpse.floor);
+    sqlite3_bind_int(stmt, 2, corpse.position.x);
+    sqlite3_bind_int(stmt, 3, corpse.position.y);
+    sqlite3_bind_int(stmt, 4, static_cast<int>(corpse.cause));
+    sqlite3_bind_int(stmt, 5, corpse.hasLoot ? 1 : 0);
+    return step_done(stmt);
 }
 
 std::vector<CorpseData> Database::load_corpses() {
     std::vector<CorpseData> corpses;
     
-    query("SELECT floor, x, y, death_cause, runs_since_death, has_loot FROM corpses ORDER BY id DESC LIMIT 10",
-          [&](int argc, char** argv, char**) {
-              if (argc >= 6 && argv[0]) {
-                  CorpseData corpse;
-                  corpse.floor = std::stoi(argv[0]);
-                  corpse.position.x = std::stoi(argv[1]);
-                  corpse.position.y = std::stoi(argv[2]);
-                  corpse.cause = static_cast<DeathCause>(std::stoi(argv[3]));
-                  corpse.runsSinceDeath = std::stoi(argv[4]);
-                  corpse.hasLoot = std::stoi(argv[5]) != 0;
-                  corpses.push_back(corpse);
-              }
-          });
+    sqlite3_stmt* stmt = prepare(
+        "SELECT floor, x, y, death_cause, runs_since_death, has_loot FROM corpses ORDER BY id DESC LIMIT 10");
+    if (!stmt) return corpses;
+    StatementReset reset(stmt);
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        CorpseData corpse;
+        corpse.floor = sqlite3_column_int(stmt, 0);
+        corpse.position.x = sqlite3_column_int(stmt, 1);
+        corpse.position.y = sqlite3_column_int(stmt, 2);
+        corpse.cause = static_cast<DeathCause>(sqlite3_column_int(stmt, 3));
+        corpse.runsSinceDeath = sqlite3_column_int(stmt, 4);
+        corpse.hasLoot = sqlite3_column_int(stmt, 5) != 0;
+        corpses.push_back(corpse);
+    }
     
     return corpses;
 }
 
 bool Database::age_corpses() {
-    return execute("UPDATE corpses SET runs_since_death = runs_since_death + 1");
+    sqlite3_stmt* stmt = prepare("UPDATE corpses SET runs_since_death = runs_since_death + 1");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    return step_done(stmt);
 }
 
 bool Database::delete_old_corpses(int maxAge) {
-    std::stringstream ss;
-    ss << "DELETE FROM corpses WHERE runs_since_death > " << maxAge;
-    return execute(ss.str());
+    sqlite3_stmt* stmt = prepare("DELETE FROM corpses WHERE runs_since_death > ?");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    sqlite3_bind_int(stmt, 1, maxAge);
+    return step_done(stmt);
 }
 
 bool Database::save_config(const std::string& key, const std::string& value) {
-    std::stringstream ss;
-    ss << "INSERT OR REPLACE INTO config (key, value) VALUES ('"
-       << key << "', '" << value << "')";
-    return execute(ss.str());
+    sqlite3_stmt* stmt = prepare("INSERT OR REPLACE INTO config (key, value) VALUES (?, ?)");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    bind_text(stmt, 1, key);
+    bind_text(stmt, 2, value);
+    return step_done(stmt);
 }
 
 std::string Database::load_config(const std::string& key, const std::string& defaultValue) {
-    std::string result = defaultValue;
-    
-    std::stringstream ss;
-    ss << "SELECT value FROM config WHERE key = '" << key << "'";
-    
-    query(ss.str(), [&](int argc, char** argv, char**) {
-        if (argc > 0 && argv[0]) {
-            result = argv[0];
+    sqlite3_stmt* stmt = prepare("SELECT value FROM config WHERE key = ?");
+    if (!stmt) return defaultValue;
+    StatementReset reset(stmt);
+    bind_text(stmt, 1, key);
+    
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* text = sqlite3_column_text(stmt, 0);
+        if (text) {
+            return std::string(reinterpret_cast<const char*>(text),
+                               static_cast<size_t>(sqlite3_column_bytes(stmt, 0)));
         }
-    });
-    
-    return result;
+    }
+    return defaultValue;
 }
 
 bool Database::save_stat(const std::string& key, int value) {
-    std::stringstream ss;
-    ss << "INSERT OR REPLACE INTO stats (key, value) VALUES ('"
-       << key << "', " << value << ")";
-    return execute(ss.str());
+    sqlite3_stmt* stmt = prepare("INSERT OR REPLACE INTO stats (key, value) VALUES (?, ?)");
+    if (!stmt) return false;
+    StatementReset reset(stmt);
+    bind_text(stmt, 1, key);
+    sqlite3_bind_int(stmt, 2, value);
+    return step_done(stmt);
 }
 
 int Database::load_stat(const std::string& key, int defaultValue) {
-    int result = defaultValue;
-    
-    std::stringstream ss;
-    ss << "SELECT value FROM stats WHERE key = '" << key << "'";
-    
-    query(ss.str(), [&](int argc, char** argv, char**) {
-        if (argc > 0 && argv[0]) {
-            result = std::stoi(argv[0]);
-        }
-    });
+    sqlite3_stmt* stmt = prepare("SELECT value FROM stats WHERE key = ?");
+    if (!stmt) return defaultValue;
+    StatementReset reset(stmt);
+    bind_text(stmt, 1, key);
     
-    return result;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        return sqlite3_column_int(stmt, 0);
+    }
+    return defaultValue;
 }
 
 std::vector<uint8_t> Database::serialize_dungeon(const Dungeon& dungeon) {
+    const auto& tiles = dungeon.tiles();
+    const auto& rooms = dungeon.rooms();
     std::vector<uint8_t> data;
+    data.reserve(8 + tiles.size() / 8 + rooms.size() * 17);
+    ByteWriter out(data);
+    out.u8(FLOOR_FORMAT_VERSION);
     
     // Header: width, height
-    int w = dungeon.width();
-    int h = dungeon.height();
-    data.push_back(static_cast<uint8_t>(w & 0xFF));
-    data.push_back(static_cast<uint8_t>((w >> 8) & 0xFF));
-    data.push_back(static_cast<uint8_t>(h & 0xFF));
-    data.push_back(static_cast<uint8_t>((h >> 8) & 0xFF));
-    
-    // Tiles
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            data.push_back(static_cast<uint8_t>(dungeon.get_tile(x, y)));
-        }
+    out.u16(static_cast<uint16_t>(dungeon.width()));
+    out.u16(static_cast<uint16_t>(dungeon.height()));
+    
+    // IMPROVED: Tiles run-length encoded straight from the tile array
+    tile_codec::encode(tiles.data(), tiles.size(), data);
+    
+    // Rooms: bounds and type
+    out.u16(static_cast<uint16_t>(rooms.size()));
+    for (const auto& room : rooms) {
+        out.i32(room.x);
+        out.i32(room.y);
+        out.i32(room.w);
+        out.i32(room.h);
+        out.u8(static_cast<uint8_t>(room.type));
     }
     
     return data;
 }
 
-bool Database::deserialize_dungeon(const std::vector<uint8_t>& data, Dungeon& dungeon) {
-    if (data.size() < 4) return false;
-    
-    int w = data[0] | (data[1] << 8);
-    int h = data[2] | (data[3] << 8);
-    
-    if (data.size() < 4 + static_cast<size_t>(w * h)) return false;
-    
+bool Database::deserialize_dungeon(const uint8_t* data, size_t size, Dungeon& dungeon) {
+    ByteReader in(data, size);
+    if (in.u8() != FLOOR_FORMAT_VERSION) return false;
+    int w = in.u16();
+    int h = in.u16();
+    if (!in.ok()) return false;
+    if (w < 1 || w > game_constants::MAX_MAP_WIDTH ||
+        h < 1 || h > game_constants::MAX_MAP_HEIGHT) return false;
+    
+    std::vector<TileType> tiles;
+    size_t used = tile_codec::decode(in.cursor(), in.remaining(),
+                                     static_cast<size_t>(w) * static_cast<size_t>(h), tiles);
+    if (used == 0) return false;
+    in.skip(used);
     dungeon = Dungeon(w, h);
-    
-    size_t idx = 4;
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            dungeon.set_tile(x, y, static_cast<TileType>(data[idx++]));
-        }
+    dungeon.set_tiles(std::move(tiles));
+    
+    std::vector<Room> rooms(in.count(17));
+    for (auto& room : rooms) {
+        room.x = in.i32();
+        room.y = in.i32();
+        room.w = in.i32();
+        room.h = in.i32();
+        room.type = static_cast<RoomType>(in.u8());
     }
+    dungeon.set_rooms(std::move(rooms));
     
-    return true;
+    return in.done();
 }
 
 std::vector<uint8_t> Database::serialize_enemies(const std::vector<Enemy>& enemies) {
     std::vector<uint8_t> data;
+    data.reserve(3 + enemies.size() * 160);
+    ByteWriter out(data);
+    out.u8(FLOOR_FORMAT_VERSION);
     
-    // Count
-    size_t count = enemies.size();
-    data.push_back(static_cast<uint8_t>(count & 0xFF));
-    data.push_back(static_cast<uint8_t>((count >> 8) & 0xFF));
-    
-    // Each enemy: type, x, y, hp
+    out.u16(static_cast<uint16_t>(enemies.size()));
     for (const auto& enemy : enemies) {
-        data.push_back(static_cast<uint8_t>(enemy.enemy_type()));
-        auto pos = enemy.get_position();
-        data.push_back(static_cast<uint8_t>(pos.x & 0xFF));
-        data.push_back(static_cast<uint8_t>((pos.x >> 8) & 0xFF));
-        data.push_back(static_cast<uint8_t>(pos.y & 0xFF));
-        data.push_back(static_cast<uint8_t>((pos.y >> 8) & 0xFF));
-        data.push_back(static_cast<uint8_t>(enemy.stats().hp & 0xFF));
-        data.push_back(static_cast<uint8_t>((enemy.stats().hp >> 8) & 0xFF));
+        out.u8(static_cast<uint8_t>(enemy.enemy_type()));
+        out.u8(static_cast<uint8_t>(enemy.archetype()));
+        out.i32(enemy.get_position().x);
+        out.i32(enemy.get_position().y);
+        out.u8(static_cast<uint8_t>(enemy.height()));
+        
+        const Stats& stats = enemy.stats();
+        out.i32(stats.maxHp);
+        out.i32(stats.hp);
+        out.i32(stats.attack);
+        out.i32(stats.defense);
+        out.i32(stats.speed);
+        
+        const EnemyTimers& timers = enemy.timers();
+        out.i32(timers.shotCooldown);
+        out.i32(timers.messageCooldown);
+        out.i32(timers.patternCounter);
+        
+        const EnemyKnowledge& knowledge = enemy.knowledge();
+        out.i32(knowledge.timesPlayerKited);
+        out.i32(knowledge.timesPlayerChoked);
+        out.i32(knowledge.timesPlayerRangedSpam);
+        out.i32(knowledge.timesPlayerMelee);
+        out.i32(knowledge.timesPlayerFled);
+        out.i32(knowledge.totalObservations);
+        for (int action : knowledge.actionHistory) {
+            out.u8(static_cast<uint8_t>(action));
+        }
+        out.u8(static_cast<uint8_t>(knowledge.historyIndex));
+        out.i32(knowledge.counterSuccesses);
+        out.i32(knowledge.counterAttempts);
+        out.u8(static_cast<uint8_t>(knowledge.tier));
+        
+        const auto& statuses = enemy.statuses();
+        out.u8(static_cast<uint8_t>(statuses.size()));
+        for (const auto& status : statuses) {
+            out.u8(static_cast<uint8_t>(status.type));
+            out.i32(status.remainingTurns);
+            out.i32(status.magnitude);
+        }
     }
     
     return data;
 }
 
-bool Database::deserialize_enemies(const std::vector<uint8_t>& data, std::vector<Enemy>& enemies) {
-    if (data.size() < 2) return false;
-    
-    size_t count = data[0] | (data[1] << 8);
-    size_t idx = 2;
+bool Database::deserialize_enemies(const uint8_t* data, size_t size, std::vector<Enemy>& enemies) {
+    ByteReader in(data, size);
+    if (in.u8() != FLOOR_FORMAT_VERSION) return false;
+    size_t count = in.count(88);
     
     enemies.clear();
-    for (size_t i = 0; i < count && idx + 7 <= data.size(); i++) {
-        EnemyType type = static_cast<EnemyType>(data[idx++]);
-        int x = data[idx] | (data[idx + 1] << 8); idx += 2;
-        int y = data[idx] | (data[idx + 1] << 8); idx += 2;
-        int hp = data[idx] | (data[idx + 1] << 8); idx += 2;
-        
-        Enemy enemy(type);
+    enemies.reserve(count);
+    for (size_t i = 0; i < count && in.ok(); i++) {
+        EnemyType type = static_cast<EnemyType>(in.u8());
+        EnemyArchetype archetype = static_cast<EnemyArchetype>(in.u8());
+        Enemy enemy(type, archetype);
+        int x = in.i32();
+        int y = in.i32();
         enemy.set_position(x, y);
-        enemy.stats().hp = hp;
-        enemies.push_back(enemy);
+        enemy.set_height(static_cast<HeightLevel>(in.u8()));
+        
+        Stats& stats = enemy.stats();
+        stats.maxHp = in.i32();
+        stats.hp = in.i32();
+        stats.attack = in.i32();
+        stats.defense = in.i32();
+        stats.speed = in.i32();
+        
+        EnemyTimers& timers = enemy.timers();
+        timers.shotCooldown = in.i32();
+        timers.messageCooldown = in.i32();
+        timers.patternCounter = in.i32();
+        
+        EnemyKnowledge& knowledge = enemy.knowledge();
+        knowledge.timesPlayerKited = in.i32();
+        knowledge.timesPlayerChoked = in.i32();
+        knowledge.timesPlayerRangedSpam = in.i32();
+        knowledge.timesPlayerMelee = in.i32();
+        knowledge.timesPlayerFled = in.i32();
+        knowledge.totalObservations = in.i32();
+        for (int& action : knowledge.actionHistory) {
+            action = in.u8();
+        }
+        knowledge.historyIndex = in.u8() % 10;
+        knowledge.counterSuccesses = in.i32();
+        knowledge.counterAttempts = in.i32();
+        knowledge.tier = static_cast<AITier>(in.u8());
+        
+        int statusCount = in.u8();
+        for (int s = 0; s < statusCount && in.ok(); s++) {
+            StatusEffect status;
+            status.type = static_cast<StatusType>(in.u8());
+            status.remainingTurns = in.i32();
+            status.magnitude = in.i32();
+            enemy.apply_status(status);
+        }
+        
+        enemies.push_back(std::move(enemy));
     }
     
-    return true;
+    return in.done();
 }
 
+std::vector<uint8_t> Database::serialize_items(const std::vector<Item>& items) {
+    std::vector<uint8_t> data;
+    data.reserve(3 + items.size() * 64);
+    ByteWriter out(data);
+    out.u8(FLOOR_FORMAT_VERSION);
+    
+    out.u16(static_cast<uint16_t>(items.size()));
+    for (const auto& item : items) {
+        out.str(item.name);
+        out.u8(static_cast<uint8_t>(item.type));
+        out.u8(static_cast<uint8_t>(item.rarity));
+        out.i32(item.attackBonus);
+        out.i32(item.defenseBonus);
+        out.i32(item.hpBonus);
+        out.u8(static_cast<uint8_t>((item.isEquippable ? 1 : 0) | (item.isConsumable ? 2 : 0)));
+        out.u8(static_cast<uint8_t>(item.slot));
+        out.i32(item.healAmount);
+        out.u8(static_cast<uint8_t>(item.onUseStatus));
+        out.i32(item.onUseMagnitude);
+        out.i32(item.onUseDuration);
+        out.u8(static_cast<uint8_t>(item.affix));
+        out.f32(item.affixStrength);
+    }
+    
+    return data;
+}
+
+bool Database::deserialize_items(const uint8_t* data, size_t size, std::vector<Item>& items) {
+    ByteReader in(data, size);
+    if (in.u8() != FLOOR_FORMAT_VERSION) return false;
+    size_t count = in.count(36);
+    
+    items.clear();
+    items.resize(count);
+    for (auto& item : items) {
+        item.name = in.str();
+        item.type = static_cast<ItemType>(in.u8());
+        item.rarity = static_cast<Rarity>(in.u8());
+        item.attackBonus = in.i32();
+        item.defenseBonus = in.i32();
+        item.hpBonus = in.i32();
+        uint8_t flags = in.u8();
+        item.isEquippable = (flags & 1) != 0;
+        item.isConsumable = (flags & 2) != 0;
+        item.slot = static_cast<EquipmentSlot>(in.u8());
+        item.healAmount = in.i32();
+        item.onUseStatus = static_cast<StatusType>(in.u8());
+        item.onUseMagnitude = in.i32();
+        item.onUseDuration = in.i32();
+        item.affix = static_cast<ItemAffix>(in.u8());
+        item.affixStrength = in.f32();
+    }
+    
+    return in.done();
+}
 
+std::vector<uint8_t> Database::serialize_traps(const std::vector<traps::Trap>& traps) {
+    std::vector<uint8_t> data;
+    data.reserve(3 + traps.size() * 10);
+    ByteWriter out(data);
+    out.u8(FLOOR_FORMAT_VERSION);
+    
+    out.u16(static_cast<uint16_t>(traps.size()));
+    for (const auto& trap : traps) {
+        out.i32(trap.position.x);
+        out.i32(trap.position.y);
+        out.u8(static_cast<uint8_t>(trap.type));
+        out.u8(static_cast<uint8_t>((trap.triggered ? 1 : 0) | (trap.detected ? 2 : 0)));
+    }
+    
+    return data;
+}
+
+bool Database::deserialize_traps(const uint8_t* data, size_t size, std::vector<traps::Trap>& traps) {
+    ByteReader in(data, size);
+    if (in.u8() != FLOOR_FORMAT_VERSION) return false;
+    size_t count = in.count(10);
+    
+    traps.clear();
+    traps.resize(count);
+    for (auto& trap : traps) {
+        trap.position.x = in.i32();
+        trap.position.y = in.i32();
+        trap.type = static_cast<TrapType>(in.u8());
+        uint8_t flags = in.u8();
+        trap.triggered = (flags & 1) != 0;
+        trap.detected = (flags & 2) != 0;
+    }
+    
+    return in.done();
+}
@@ -3,14 +3,17 @@
 #include <string>
 #include <vector>
 #include <memory>
-#include <functional>
+#include <unordered_map>
 #include "types.h"
 #include "player.h"
 #include "enemy.h"
 #include "dungeon.h"
+#include "floor_manager.h"
+#include "traps.h"
 
-// Forward declaration
+// Forward declarations
 struct sqlite3;
+struct sqlite3_stmt;
 
 // Database wrapper for game persistence
 class Database {
@@ -30,6 +33,14 @@ public:
     // Initialize schema (creates tables if needed)
     bool init_schema();
     
+    // === TRANSACTIONS ===
+    // Everything between begin and commit is written atomically with a single
+    // fsync (BEGIN IMMEDIATE takes the write lock up front, so commit cannot
+    // fail on a lock upgrade). Roll back after any failed write.
+    bool begin_transaction();
+    bool commit_transaction();
+    void rollback_transaction();
+    
     // === PLAYER OPERATIONS ===
     bool save_player(int saveSlot, const Player& player, int floor, unsigned int seed);
     bool load_player(int saveSlot, Player& player, int& floor, unsigned int& seed);
@@ -37,10 +48,14 @@ public:
     bool has_save(int saveSlot);
     
     // === FLOOR OPERATIONS ===
-    bool save_floor(int saveSlot, int floorNum, const Dungeon& dungeon, 
-                    const std::vector<Enemy>& enemies);
-    bool load_floor(int saveSlot, int floorNum, Dungeon& dungeon, 
-                    std::vector<Enemy>& enemies);
+    // Tiles and rooms, enemies (stats, knowledge, timers, statuses, height),
+    // ground items, traps, stairs and flags. Paths are caches and are not kept.
+    bool save_floor(int saveSlot, int floorNum, const FloorData& floor,
+                    const std::vector<traps::Trap>& traps = {});
+    // Replaces floor (and traps, if given) and rebuilds its occupancy grid
+    // Returns false if the slot has no such floor or its data is corrupt
+    bool load_floor(int saveSlot, int floorNum, FloorData& floor,
+                    std::vector<traps::Trap>* traps = nullptr);
     bool delete_floor(int saveSlot, int floorNum);
     
     // === CORPSE OPERATIONS ===
@@ -61,23 +76,42 @@ public:
     const std::string& last_error() const { return lastError_; }
     
 private:
-    // Execute SQL statement
+    // Execute SQL statement (schema setup; no parameters)
     bool execute(const std::string& sql);
     
-    // Execute SQL with callback for results
-    bool query(const std::string& sql, 
-               std::function<void(int argc, char** argv, char** colNames)> callback);
+    // Prepared statement for sql, compiled on first use and cached for the
+    // life of the connection. sql must be a string literal: the cache is keyed
+    // by its address, so a lookup hashes one pointer instead of the SQL text.
+    // Callers bind with sqlite3_bind_* and must let a StatementReset
+    // (database.cpp) reset it afterwards.
+    // Returns nullptr (and sets lastError_) if the SQL does not compile.
+    sqlite3_stmt* prepare(const char* sql);
+    
+    // Step a statement that returns no rows
+    bool step_done(sqlite3_stmt* stmt);
+    
+    // Record sqlite's current error message for last_error()
+    void set_error(const char* context);
     
-    // Serialize dungeon to blob
+    // Add any floors columns missing from a database made by an older build
+    bool upgrade_floors_table();
+    
+    // Floor blobs: little-endian, each led by a format version byte
     std::vector<uint8_t> serialize_dungeon(const Dungeon& dungeon);
-    bool deserialize_dungeon(const std::vector<uint8_t>& data, Dungeon& dungeon);
+    bool deserialize_dungeon(const uint8_t* data, size_t size, Dungeon& dungeon);
     
-    // Serialize enemies to blob
     std::vector<uint8_t> serialize_enemies(const std::vector<Enemy>& enemies);
-    bool deserialize_enemies(const std::vector<uint8_t>& data, std::vector<Enemy>& enemies);
+    bool deserialize_enemies(const uint8_t* data, size_t size, std::vector<Enemy>& enemies);
+    
+    std::vector<uint8_t> serialize_items(const std::vector<Item>& items);
+    bool deserialize_items(const uint8_t* data, size_t size, std::vector<Item>& items);
+    
+    std::vector<uint8_t> serialize_traps(const std::vector<traps::Trap>& traps);
+    bool deserialize_traps(const uint8_t* data, size_t size, std::vector<traps::Trap>& traps);
     
     sqlite3* db_ = nullptr;
     std::string lastError_;
+    std::unordered_map<const char*, sqlite3_stmt*> statements_;  // Keyed by SQL literal address
 };
 
 // Global database instance
@@ -12,6 +12,18 @@ Dungeon::Dungeon(int width, int height)
     : width_(width), height_(height), tiles_(static_cast<size_t>(width) * static_cast<size_t>(height), TileType::Wall) {
 }
 
+bool Dungeon::set_tiles(std::vector<TileType> tiles) {
+    if (tiles.size() != tiles_.size()) {
+        return false;
+    }
+    tiles_ = std::move(tiles);
+    distanceFieldValid_ = false;
+    fovValid_ = false;
+    // As in generate(): cached routes are replanned, not repaired
+    revision_ += TILE_CHANGE_LOG_SIZE + 1;
+    return true;
+}
+
 const Room* Dungeon::get_room_at(int x, int y) const {
     for (const auto& room : rooms_) {
         if (x >= room.x && x < room.x + room.w &&
@@ -60,11 +72,19 @@ void Dungeon::set_tile(int x, int y, TileType t) {
         LOG_ERROR("Dungeon::set_tile out-of-bounds access: idx=" + std::to_string(idx) + ", tiles_.size()=" + std::to_string(tiles_.size()));
         return;
     }
-    tiles_[idx] = t;
+    if (tiles_[idx] != t) {
+        tiles_[idx] = t;
+        distanceFieldValid_ = false;
+        ++revision_;
+        changeLog_[revision_ % TILE_CHANGE_LOG_SIZE] = static_cast<int>(idx);
+    }
 }
 
 bool Dungeon::is_walkable(int x, int y) const {
-    TileType t = get_tile(x, y);
+    return is_walkable_tile(get_tile(x, y));
+}
+
+bool Dungeon::is_walkable_tile(TileType t) {
     return t == TileType::Floor || t == TileType::Door || 
            t == TileType::StairsDown || t == TileType::StairsUp ||
            t == TileType::Trap || t == TileType::Shrine ||
@@ -242,6 +262,12 @@ void Dungeon::generate(unsigned int seed, Position& playerStart, Position& stair
 
     std::fill(tiles_.begin(), tiles_.end(), TileType::Wall);
     rooms_.clear();
+    distanceFieldValid_ = false;
+    // New layout: forget what was seen on the previous one
+    fovValid_ = false;
+    exploredBits_.assign((tiles_.size() + 63) / 64, 0);
+    // Push every cached route past the change log so it is replanned, not repaired
+    revision_ += TILE_CHANGE_LOG_SIZE + 1;
 
     std::vector<Rect> tempRooms;
     const int maxRooms = 12;
@@ -371,3 +397,175 @@ void Dungeon::generate(unsigned int seed, Position& playerStart, Position& stair
 }
 
 
+
+const std::vector<uint16_t>& Dungeon::distance_field(const Position& target) const {
+    if (!distance_field_current(target)) {
+        rebuild_distance_field(target);
+    }
+    return distanceField_;
+}
+
+bool Dungeon::distance_field_current(const Position& target) const {
+    return distanceFieldValid_ && target.x == distanceTarget_.x && target.y == distanceTarget_.y;
+}
+
+uint16_t Dungeon::distance_to(const Position& target, int x, int y) const {
+    if (!in_bounds(x, y)) {
+        return UNREACHABLE_DISTANCE;
+    }
+    const std::vector<uint16_t>& field = distance_field(target);
+    return field[static_cast<size_t>(y) * static_cast<size_t>(width_) + static_cast<size_t>(x)];
+}
+
+void Dungeon::rebuild_distance_field(const Position& target) const {
+    // All moves cost one step, so Dijkstra reduces to a breadth-first sweep
+    // over a flat index queue; both buffers keep their capacity between rebuilds.
+    distanceField_.assign(tiles_.size(), UNREACHABLE_DISTANCE);
+    distanceQueue_.clear();
+    distanceQueue_.reserve(tiles_.size());
+    distanceTarget_ = target;
+    distanceFieldValid_ = true;
+    ++distanceFieldBuilds_;
+
+    if (!in_bounds(target.x, target.y)) {
+        return;
+    }
+
+    int start = target.y * width_ + target.x;
+    distanceField_[static_cast<size_t>(start)] = 0;
+    distanceQueue_.push_back(start);
+
+    for (size_t head = 0; head < distanceQueue_.size(); ++head) {
+        int cur = distanceQueue_[head];
+        int cx = cur % width_;
+        int cy = cur / width_;
+        uint16_t next = static_cast<uint16_t>(distanceField_[static_cast<size_t>(cur)] + 1);
+        if (next == UNREACHABLE_DISTANCE) {
+            continue;
+        }
+        const int dirs[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
+        for (const auto& d : dirs) {
+            int nx = cx + d[0];
+            int ny = cy + d[1];
+            if (!in_bounds(nx, ny) || !is_walkable(nx, ny)) {
+                continue;
+            }
+            int nidx = ny * width_ + nx;
+            if (distanceField_[static_cast<size_t>(nidx)] != UNREACHABLE_DISTANCE) {
+                continue;
+            }
+            distanceField_[static_cast<size_t>(nidx)] = next;
+            distanceQueue_.push_back(nidx);
+        }
+    }
+
+    LOG_DEBUG("Rebuilt distance field toward (" + std::to_string(target.x) + "," +
+              std::to_string(target.y) + "), " + std::to_string(distanceQueue_.size()) + " tiles reached");
+}
+
+bool Dungeon::fov_current(const Position& origin, int radius) const {
+    return fovValid_ && fovRevision_ == revision_ && radius == fovRadius_ &&
+           origin.x == fovOrigin_.x && origin.y == fovOrigin_.y;
+}
+
+void Dungeon::compute_fov(const Position& origin, int radius) const {
+    if (fov_current(origin, radius)) {
+        return;
+    }
+    const size_t words = (tiles_.size() + 63) / 64;
+    visibleBits_.assign(words, 0);
+    if (exploredBits_.size() != words) {
+        exploredBits_.assign(words, 0);
+    }
+    fovOrigin_ = origin;
+    fovRadius_ = radius;
+    fovRevision_ = revision_;
+    fovValid_ = true;
+    ++fovBuilds_;
+
+    if (!in_bounds(origin.x, origin.y)) {
+        return;
+    }
+    mark_visible(origin.x, origin.y);
+
+    // Octant transforms: (xx, xy, yx, yy) map octant-local (col, row) to map deltas
+    static const int octants[8][4] = {
+        { 1,  0,  0,  1}, { 0,  1,  1,  0}, { 0, -1,  1,  0}, {-1,  0,  0,  1},
+        {-1,  0,  0, -1}, { 0, -1, -1,  0}, { 0,  1, -1,  0}, { 1,  0,  0, -1}
+    };
+    for (const auto& o : octants) {
+        cast_light(1, 1.0, 0.0, o[0], o[1], o[2], o[3]);
+    }
+}
+
+void Dungeon::cast_light(int row, double startSlope, double endSlope,
+                         int xx, int xy, int yx, int yy) const {
+    // Recursive shadowcasting: scan one octant row by row, narrowing the lit
+    // slope window at each opaque tile and recursing past the gap it leaves.
+    if (startSlope < endSlope) {
+        return;
+    }
+    const int radiusSq = fovRadius_ * fovRadius_;
+    double nextStart = startSlope;
+    for (int j = row; j <= fovRadius_; ++j) {
+        bool blocked = false;
+        int dy = -j;
+        for (int dx = -j; dx <= 0; ++dx) {
+            double leftSlope = (dx - 0.5) / (dy + 0.5);
+            double rightSlope = (dx + 0.5) / (dy - 0.5);
+            if (startSlope < rightSlope) {
+                continue;
+            }
+            if (endSlope > leftSlope) {
+                break;
+            }
+
+            int x = fovOrigin_.x + dx * xx + dy * xy;
+            int y = fovOrigin_.y + dx * yx + dy * yy;
+            bool inside = in_bounds(x, y);
+            if (inside && dx * dx + dy * dy <= radiusSq) {
+                mark_visible(x, y);
+            }
+
+            bool opaque = !inside || blocks_sight_tile(tiles_[static_cast<size_t>(y * width_ + x)]);
+            if (blocked) {
+                if (opaque) {
+                    nextStart = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                startSlope = nextStart;
+            } else if (opaque && j < fovRadius_) {
+                blocked = true;
+                cast_light(j + 1, startSlope, leftSlope, xx, xy, yx, yy);
+                nextStart = rightSlope;
+            }
+        }
+        if (blocked) {
+            break;
+        }
+    }
+}
+
+void Dungeon::mark_visible(int x, int y) const {
+    size_t idx = static_cast<size_t>(y) * static_cast<size_t>(width_) + static_cast<size_t>(x);
+    uint64_t bit = uint64_t{1} << (idx & 63);
+    visibleBits_[idx >> 6] |= bit;
+    exploredBits_[idx >> 6] |= bit;
+}
+
+bool Dungeon::is_visible(int x, int y) const {
+    if (!fovValid_ || !in_bounds(x, y)) {
+        return false;
+    }
+    size_t idx = static_cast<size_t>(y) * static_cast<size_t>(width_) + static_cast<size_t>(x);
+    return (visibleBits_[idx >> 6] >> (idx & 63)) & 1u;
+}
+
+bool Dungeon::is_explored(int x, int y) const {
+    if (!in_bounds(x, y)) {
+        return false;
+    }
+    size_t idx = static_cast<size_t>(y) * static_cast<size_t>(width_) + static_cast<size_t>(x);
+    return idx >> 6 < exploredBits_.size() && ((exploredBits_[idx >> 6] >> (idx & 63)) & 1u);
+}
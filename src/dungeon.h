@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <random>
+#include <cstdint>
+#include <utility>
 #include "types.h"
 
 
@@ -91,6 +94,23 @@ public:
      * @return True if walkable
      */
     bool is_walkable(int x, int y) const;
+    /**
+     * @brief Check if a tile type can be walked on.
+     * @param t Tile type
+     * @return True if walkable
+     */
+    static bool is_walkable_tile(TileType t);
+    /**
+     * @brief Get the raw row-major tile array (index = y * width + x).
+     * @return Tile storage
+     */
+    const std::vector<TileType>& tiles() const { return tiles_; }
+    /**
+     * @brief Replace every tile at once (used when loading a saved floor).
+     * @param tiles Row-major tiles; ignored unless it holds width * height entries
+     * @return True if the tiles were taken
+     */
+    bool set_tiles(std::vector<TileType> tiles);
     /**
      * @brief Check if a tile is hazardous (trap, lava, etc.).
      * @param x X coordinate
@@ -111,6 +131,11 @@ public:
      * @return Vector of rooms
      */
     const std::vector<Room>& rooms() const { return rooms_; }
+    /**
+     * @brief Replace the room list (used when loading a saved floor).
+     * @param rooms Rooms to keep
+     */
+    void set_rooms(std::vector<Room> rooms) { rooms_ = std::move(rooms); }
     /**
      * @brief Get the room at given coordinates.
      * @param x X coordinate
@@ -126,6 +151,113 @@ public:
      */
     RoomType get_room_type_at(int x, int y) const;
 
+    /// Distance value for tiles that cannot reach the distance field target.
+    static constexpr uint16_t UNREACHABLE_DISTANCE = 0xFFFF;
+
+    /**
+     * @brief Get the walking distance map toward a target tile (usually the player).
+     *
+     * The map is a flat width*height array of 4-way step counts computed by a
+     * breadth-first sweep from the target. It is cached and only rebuilt when the
+     * target moves or a tile changes through set_tile() / generate().
+     * @param target Tile the distances are measured to
+     * @return Distance per tile index (y * width + x), UNREACHABLE_DISTANCE if no path
+     */
+    const std::vector<uint16_t>& distance_field(const Position& target) const;
+    /**
+     * @brief Get the cached walking distance from a tile to the field target.
+     * @param target Tile the distances are measured to
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @return Step count, or UNREACHABLE_DISTANCE if out of bounds or unreachable
+     */
+    uint16_t distance_to(const Position& target, int x, int y) const;
+    /**
+     * @brief Check whether the cached distance field is current for a target.
+     * @param target Tile the distances are measured to
+     * @return True if distance_field(target) would not trigger a rebuild
+     */
+    bool distance_field_current(const Position& target) const;
+    /**
+     * @brief Get how many times the distance field has been rebuilt.
+     * @return Rebuild count
+     */
+    uint64_t distance_field_builds() const { return distanceFieldBuilds_; }
+    /**
+     * @brief Invalidate cached data derived from the tile layout.
+     */
+    void invalidate_distance_field() const { distanceFieldValid_ = false; }
+
+    /// Number of recent tile changes remembered for incremental path repair.
+    static constexpr uint32_t TILE_CHANGE_LOG_SIZE = 32;
+
+    /**
+     * @brief Get the tile revision, incremented by every set_tile() that changes a tile.
+     * @return Current revision
+     */
+    uint32_t revision() const { return revision_; }
+    /**
+     * @brief Check whether every change after a revision is still in the change log.
+     * @param since Revision a cached result was computed at
+     * @return True if changed_tile() can be queried for each revision in (since, revision()]
+     */
+    bool change_log_covers(uint32_t since) const { return revision_ - since <= TILE_CHANGE_LOG_SIZE; }
+    /**
+     * @brief Get the tile index modified by a given revision.
+     * @param rev Revision in (since, revision()] for a since accepted by change_log_covers()
+     * @return Tile index (y * width + x)
+     */
+    int changed_tile(uint32_t rev) const { return changeLog_[rev % TILE_CHANGE_LOG_SIZE]; }
+
+    /**
+     * @brief Check if a tile type blocks line of sight.
+     * @param t Tile type
+     * @return True if opaque (walls)
+     */
+    static bool blocks_sight_tile(TileType t) { return t == TileType::Wall; }
+
+    /**
+     * @brief Compute the field of view from an origin with recursive shadowcasting.
+     *
+     * The result is stored in a visibility bitset and merged into the persistent
+     * explored bitset. It is cached: the call is a no-op unless the origin or
+     * radius changed or a tile changed since the last computation.
+     * @param origin Viewer position (usually the player)
+     * @param radius Sight radius in tiles (circular)
+     */
+    void compute_fov(const Position& origin, int radius) const;
+    /**
+     * @brief Check whether the cached field of view is current for a viewer.
+     * @param origin Viewer position
+     * @param radius Sight radius in tiles
+     * @return True if compute_fov(origin, radius) would not recompute
+     */
+    bool fov_current(const Position& origin, int radius) const;
+    /**
+     * @brief Get the origin of the last computed field of view.
+     * @return Viewer position, (-1, -1) before the first computation
+     */
+    const Position& fov_origin() const { return fovOrigin_; }
+    /**
+     * @brief Check if a tile was visible in the last computed field of view.
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @return True if visible
+     */
+    bool is_visible(int x, int y) const;
+    /**
+     * @brief Check if a tile has ever been seen on this floor (fog-of-war memory).
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @return True if explored
+     */
+    bool is_explored(int x, int y) const;
+    /**
+     * @brief Get how many times the field of view has been recomputed.
+     * @return Recompute count
+     */
+    uint64_t fov_builds() const { return fovBuilds_; }
+
 private:
     struct Rect {
         int x;
@@ -139,11 +271,35 @@ private:
     void carve_v_corridor(int y1, int y2, int x);
     void assign_room_types(std::mt19937& rng, int depth);
     void populate_room(Room& room, std::mt19937& rng);
+    void rebuild_distance_field(const Position& target) const;
+    void cast_light(int row, double startSlope, double endSlope,
+                    int xx, int xy, int yx, int yy) const;
+    void mark_visible(int x, int y) const;
 
     int width_;
     int height_;
     std::vector<TileType> tiles_;
     std::vector<Room> rooms_;
+
+    // Player-centred distance field, rebuilt lazily by distance_field()
+    mutable std::vector<uint16_t> distanceField_;
+    mutable std::vector<int> distanceQueue_;
+    mutable Position distanceTarget_{-1, -1};
+    mutable bool distanceFieldValid_ = false;
+    mutable uint64_t distanceFieldBuilds_ = 0;
+
+    // Shadowcast field of view (one bit per tile), recomputed lazily by compute_fov()
+    mutable std::vector<uint64_t> visibleBits_;
+    mutable std::vector<uint64_t> exploredBits_;
+    mutable Position fovOrigin_{-1, -1};
+    mutable int fovRadius_ = 0;
+    mutable uint32_t fovRevision_ = 0;
+    mutable bool fovValid_ = false;
+    mutable uint64_t fovBuilds_ = 0;
+
+    // Ring of recently changed tile indices, slot = revision % TILE_CHANGE_LOG_SIZE
+    uint32_t revision_ = 0;
+    std::array<int, TILE_CHANGE_LOG_SIZE> changeLog_{};
 };
 
 
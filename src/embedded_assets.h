@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+// ASCII art compiled into the binary. The definitions are generated at build
+// time by src/tools/embed_assets.cpp from assets/ascii/**/*.txt.
+namespace assets::embedded {
+    struct Entry {
+        const char* name;     // Path relative to assets/ascii, without ".txt"
+        const char* text;     // Raw file bytes
+        size_t length;
+    };
+
+    const Entry* entries();
+    size_t count();
+}
@@ -24,13 +24,29 @@ const Position& Enemy::get_position() const {
 }
 
 void Enemy::set_position(int x, int y) {
+    Position from = position_;
     position_.x = x;
     position_.y = y;
+    if (occupancy_.grid) {
+        occupancy_.grid->move(occupancy_.slot, from, position_);
+    }
 }
 
 void Enemy::move_by(int dx, int dy) {
-    position_.x += dx;
-    position_.y += dy;
+    set_position(position_.x + dx, position_.y + dy);
+}
+
+void Enemy::attach_occupancy(OccupancyGrid* grid, int32_t slot) {
+    occupancy_.grid = grid;
+    occupancy_.slot = slot;
+}
+
+bool Enemy::can_enter(int x, int y) const {
+    if (!occupancy_.grid) {
+        return true;
+    }
+    int32_t occupant = occupancy_.grid->at(x, y);
+    return occupant == OccupancyGrid::EMPTY || occupant == occupancy_.slot;
 }
 
 EnemyArchetype Enemy::archetype() const {
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "types.h"
 #include "entity.h"
+#include "occupancy_grid.h"
 
 class MessageLog;
 
@@ -79,6 +81,39 @@ struct EnemyKnowledge {
     }
 };
 
+// Route cached between turns so the AI only replans when the target drifts
+struct EnemyPath {
+    static constexpr int MAX_STEPS = 24;
+
+    enum class Purpose {
+        Chase,      // Heading for the player
+        Retreat     // Opening distance from the player
+    };
+
+    Position steps[MAX_STEPS] = {};
+    int length = 0;
+    int cursor = 0;                 // Index of the next step to take
+    Purpose purpose = Purpose::Chase;
+    Position target{-1, -1};        // Player position the route was planned for
+    uint32_t tileRevision = 0;      // Dungeon::revision() when planned or last repaired
+
+    int remaining() const { return length - cursor; }
+    void clear() { length = 0; cursor = 0; }
+};
+
+// Per-enemy AI timers, counted in the enemy's own turns
+struct EnemyTimers {
+    int shotCooldown = 0;        // Archer: turns until it may shoot again
+    int messageCooldown = 0;     // Boss: turns until it announces a pattern again
+    int patternCounter = 0;      // Boss: actions taken, selects the pattern step
+
+    // Called once at the start of each of the enemy's turns
+    void tick() {
+        if (shotCooldown > 0) --shotCooldown;
+        if (messageCooldown > 0) --messageCooldown;
+    }
+};
+
 class Enemy {
 public:
     // Legacy constructor (for backward compatibility)
@@ -90,12 +125,21 @@ public:
     void set_position(int x, int y);
     void move_by(int dx, int dy);
 
+    // Occupancy tracking: set_position/move_by keep the attached grid current
+    void attach_occupancy(OccupancyGrid* grid, int32_t slot);
+    // True if the tile is free of other enemies (always true when detached)
+    bool can_enter(int x, int y) const;
+
     EnemyArchetype archetype() const;
     EnemyType enemy_type() const;
     Stats& stats();
     const Stats& stats() const;
     EnemyKnowledge& knowledge();
     const EnemyKnowledge& knowledge() const;
+    EnemyPath& path() { return path_; }
+    const EnemyPath& path() const { return path_; }
+    EnemyTimers& timers() { return timers_; }
+    const EnemyTimers& timers() const { return timers_; }
     
     void apply_status(const StatusEffect& effect);
     void tick_statuses(MessageLog& log);
@@ -125,6 +169,9 @@ private:
     EnemyArchetype archetype_;
     EnemyType enemyType_ = EnemyType::Goblin;
     EnemyKnowledge knowledge_{};
+    EnemyPath path_{};
+    EnemyTimers timers_{};
+    OccupancyLink occupancy_{};
     HeightLevel height_ = HeightLevel::Ground;
     char glyph_;
     std::string color_;
@@ -1,18 +1,78 @@
 #include "fileio.h"
 #include "constants.h" // IMPROVED: Include for game_constants namespace
+#include "profiler.h"
+#include "byte_io.h"
 
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
+#include <array>
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+// Undefine Windows macros that conflict with our code
+#ifdef ERROR
+#undef ERROR
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace {
     const char* kSavesDir = "saves";
     const uint32_t kMagic = 0x52444744; // 'RDGD'
-    const uint32_t kVersion = 3; // v3: added player class
+    const uint32_t kVersion = 4; // v4: chunked container with CRC32C (v1-v3 still load)
     
     // FIXED: Maximum string length to prevent memory exhaustion from corrupted files
     constexpr uint32_t kMaxStringLength = 1024 * 1024; // 1MB max string length
 
+    // v4 layout: header {magic, version, payload size, CRC32C of payload}, then
+    // a payload of chunks {tag, size, body}. Readers skip tags they do not know,
+    // so new chunks can be added without breaking older builds.
+    constexpr size_t kHeaderSize = 16;
+    constexpr size_t kMaxSaveSize = 64 * 1024 * 1024;
+
+    constexpr uint32_t chunk_tag(const char (&name)[5]) {
+        return static_cast<uint32_t>(static_cast<unsigned char>(name[0])) |
+               static_cast<uint32_t>(static_cast<unsigned char>(name[1])) << 8 |
+               static_cast<uint32_t>(static_cast<unsigned char>(name[2])) << 16 |
+               static_cast<uint32_t>(static_cast<unsigned char>(name[3])) << 24;
+    }
+    constexpr uint32_t kChunkGame = chunk_tag("GAME");        // Difficulty, depth, seed, stairs
+    constexpr uint32_t kChunkPlayer = chunk_tag("PLYR");      // Position, stats, class
+    constexpr uint32_t kChunkInventory = chunk_tag("INVT");
+    constexpr uint32_t kChunkEquipment = chunk_tag("EQUP");
+    constexpr uint32_t kChunkStatuses = chunk_tag("STAT");
+    constexpr uint32_t kChunkEnemies = chunk_tag("ENMY");
+
+    // CRC32C (Castagnoli), table-driven
+    constexpr std::array<uint32_t, 256> make_crc32c_table() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1u) ? 0x82F63B78u : 0u);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+    constexpr std::array<uint32_t, 256> kCrc32cTable = make_crc32c_table();
+
+    uint32_t crc32c(const uint8_t* data, size_t size) {
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) {
+            crc = kCrc32cTable[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
     template <typename T>
     void write_pod(std::ofstream& out, const T& v) {
         out.write(reinterpret_cast<const char*>(&v), sizeof(T));
@@ -24,12 +84,6 @@ namespace {
         return in.gcount() == sizeof(T);
     }
 
-    void write_string(std::ofstream& out, const std::string& s) {
-        uint32_t len = static_cast<uint32_t>(s.size());
-        write_pod(out, len);
-        if (len) out.write(s.data(), len);
-    }
-    
     // FIXED: Add corruption protection - validate string length and verify read success
     std::string read_string(std::ifstream& in) {
         uint32_t len = 0;
@@ -59,22 +113,7 @@ namespace {
         return s;
     }
 
-    void write_item(std::ofstream& out, const Item& it) {
-        write_string(out, it.name);
-        write_pod(out, it.type);
-        write_pod(out, it.rarity);
-        write_pod(out, it.attackBonus);
-        write_pod(out, it.defenseBonus);
-        write_pod(out, it.hpBonus);
-        write_pod(out, it.isEquippable);
-        write_pod(out, it.isConsumable);
-        write_pod(out, it.slot);
-        write_pod(out, it.healAmount);
-        write_pod(out, it.onUseStatus);
-        write_pod(out, it.onUseMagnitude);
-        write_pod(out, it.onUseDuration);
-    }
-
+    // v2/v3 item layout (no affix)
     Item read_item(std::ifstream& in) {
         Item it;
         it.name = read_string(in);
@@ -92,263 +131,567 @@ namespace {
         read_pod(in, it.onUseDuration);
         return it;
     }
-}
 
-namespace fileio {
-    // Add file corruption protection: write checksum at end of file
-    bool save_to_slot(const GameState& state, int slot) {
-        try {
-            if (slot < 1 || slot > 3) {
-                return false;
-            }
-            std::filesystem::create_directories(kSavesDir);
-            std::string path = std::string(kSavesDir) + "/slot" + std::to_string(slot) + ".bin";
-            std::string tmpPath = path + ".tmp";
-            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
-            if (!out) {
-                return false;
-            }
-            std::vector<char> buffer;
-            auto append = [&](const void* data, size_t size) {
-                const char* c = reinterpret_cast<const char*>(data);
-                buffer.insert(buffer.end(), c, c + size);
-            };
-            auto write_and_append = [&](auto v) {
-                write_pod(out, v);
-                append(&v, sizeof(v));
-            };
-
-            write_and_append(kMagic);
-            write_and_append(kVersion);
-            uint32_t diff = static_cast<uint32_t>(state.difficulty);
-            write_and_append(diff);
-            write_and_append(state.depth);
-            write_and_append(state.seed);
-            write_and_append(state.stairsDown.x);
-            write_and_append(state.stairsDown.y);
-
-            // Player basic
+    // v4 item layout; FIXED: affix and affixStrength are kept
+    void write_item(ByteWriter& out, const Item& it) {
+        out.str(it.name);
+        out.u8(static_cast<uint8_t>(it.type));
+        out.u8(static_cast<uint8_t>(it.rarity));
+        out.i32(it.attackBonus);
+        out.i32(it.defenseBonus);
+        out.i32(it.hpBonus);
+        out.u8(static_cast<uint8_t>((it.isEquippable ? 1 : 0) | (it.isConsumable ? 2 : 0)));
+        out.u8(static_cast<uint8_t>(it.slot));
+        out.i32(it.healAmount);
+        out.u8(static_cast<uint8_t>(it.onUseStatus));
+        out.i32(it.onUseMagnitude);
+        out.i32(it.onUseDuration);
+        out.u8(static_cast<uint8_t>(it.affix));
+        out.f32(it.affixStrength);
+    }
+
+    Item read_item(ByteReader& in) {
+        Item it;
+        it.name = in.str();
+        it.type = static_cast<ItemType>(in.u8());
+        it.rarity = static_cast<Rarity>(in.u8());
+        it.attackBonus = in.i32();
+        it.defenseBonus = in.i32();
+        it.hpBonus = in.i32();
+        uint8_t flags = in.u8();
+        it.isEquippable = (flags & 1) != 0;
+        it.isConsumable = (flags & 2) != 0;
+        it.slot = static_cast<EquipmentSlot>(in.u8());
+        it.healAmount = in.i32();
+        it.onUseStatus = static_cast<StatusType>(in.u8());
+        it.onUseMagnitude = in.i32();
+        it.onUseDuration = in.i32();
+        it.affix = static_cast<ItemAffix>(in.u8());
+        it.affixStrength = in.f32();
+        return it;
+    }
+
+    std::string slot_path(int slot) {
+        return std::string(kSavesDir) + "/slot" + std::to_string(slot) + ".bin";
+    }
+
+    // Appends a chunk header, then patches its size when the chunk goes out of scope
+    class ChunkScope {
+    public:
+        ChunkScope(ByteWriter& out, uint32_t tag) : out_(out) {
+            out_.u32(tag);
+            sizeAt_ = out_.position();
+            out_.u32(0);
+        }
+        ~ChunkScope() {
+            out_.patch_u32(sizeAt_, static_cast<uint32_t>(out_.position() - sizeAt_ - 4));
+        }
+        ChunkScope(const ChunkScope&) = delete;
+        ChunkScope& operator=(const ChunkScope&) = delete;
+
+    private:
+        ByteWriter& out_;
+        size_t sizeAt_;
+    };
+
+    // Whole save image: header plus chunks, built in one buffer
+    std::vector<uint8_t> build_save(const GameState& state) {
+        std::vector<uint8_t> image;
+        image.reserve(1024 + 64 * state.player.inventory().size() + 40 * state.enemies.size());
+        ByteWriter out(image);
+        out.u32(kMagic);
+        out.u32(kVersion);
+        out.u32(0);   // Payload size, patched below
+        out.u32(0);   // CRC32C, patched below
+
+        {
+            ChunkScope chunk(out, kChunkGame);
+            out.u8(static_cast<uint8_t>(state.difficulty));
+            out.i32(state.depth);
+            out.u32(state.seed);
+            out.i32(state.stairsDown.x);
+            out.i32(state.stairsDown.y);
+        }
+        {
+            ChunkScope chunk(out, kChunkPlayer);
             const Position& ppos = state.player.get_position();
-            write_and_append(ppos.x);
-            write_and_append(ppos.y);
+            out.i32(ppos.x);
+            out.i32(ppos.y);
             const Stats& pst = state.player.get_stats();
-            write_and_append(pst.maxHp);
-            write_and_append(pst.hp);
-            write_and_append(pst.attack);
-            write_and_append(pst.defense);
-            write_and_append(pst.speed);
-            // Player class (v3+)
-            uint32_t pclass = static_cast<uint32_t>(state.player.player_class());
-            write_and_append(pclass);
-
-            // Inventory
-            const auto& inv = const_cast<Player&>(state.player).inventory();
-            uint32_t invCount = static_cast<uint32_t>(inv.size());
-            write_and_append(invCount);
+            out.i32(pst.maxHp);
+            out.i32(pst.hp);
+            out.i32(pst.attack);
+            out.i32(pst.defense);
+            out.i32(pst.speed);
+            out.u8(static_cast<uint8_t>(state.player.player_class()));
+        }
+        {
+            ChunkScope chunk(out, kChunkInventory);
+            const auto& inv = state.player.inventory();
+            out.u16(static_cast<uint16_t>(inv.size()));
             for (const auto& it : inv) {
                 write_item(out, it);
-                // Not included in checksum for simplicity
             }
-            // Equipment
+        }
+        {
+            ChunkScope chunk(out, kChunkEquipment);
             const auto& eq = state.player.equipment();
-            uint32_t eqCount = static_cast<uint32_t>(eq.size());
-            write_and_append(eqCount);
+            out.u16(static_cast<uint16_t>(eq.size()));
             for (const auto& kv : eq) {
-                write_and_append(kv.first);
+                out.u8(static_cast<uint8_t>(kv.first));
                 write_item(out, kv.second);
             }
-            // Statuses
+        }
+        {
+            ChunkScope chunk(out, kChunkStatuses);
             const auto& sts = state.player.statuses();
-            uint32_t stCount = static_cast<uint32_t>(sts.size());
-            write_and_append(stCount);
-            for (const auto& s : sts) {
-                write_and_append(s.type);
-                write_and_append(s.remainingTurns);
-                write_and_append(s.magnitude);
+            out.u16(static_cast<uint16_t>(sts.size()));
+            for (const auto& st : sts) {
+                out.u8(static_cast<uint8_t>(st.type));
+                out.i32(st.remainingTurns);
+                out.i32(st.magnitude);
             }
-
-            // Enemies (minimal)
-            uint32_t enemyCount = static_cast<uint32_t>(state.enemies.size());
-            write_and_append(enemyCount);
+        }
+        {
+            ChunkScope chunk(out, kChunkEnemies);
+            out.u16(static_cast<uint16_t>(state.enemies.size()));
             for (const auto& e : state.enemies) {
-                const Position& epos = e.get_position();
-                write_and_append(epos.x);
-                write_and_append(epos.y);
+                out.u8(static_cast<uint8_t>(e.enemy_type()));
+                out.u8(static_cast<uint8_t>(e.archetype()));
+                out.i32(e.get_position().x);
+                out.i32(e.get_position().y);
+                out.u8(static_cast<uint8_t>(e.height()));
                 const Stats& est = e.stats();
-                write_and_append(est.maxHp);
-                write_and_append(est.hp);
-                write_and_append(est.attack);
-                write_and_append(est.defense);
-                write_and_append(est.speed);
-                uint32_t arch = static_cast<uint32_t>(e.archetype());
-                write_and_append(arch);
+                out.i32(est.maxHp);
+                out.i32(est.hp);
+                out.i32(est.attack);
+                out.i32(est.defense);
+                out.i32(est.speed);
             }
-            // Compute checksum (simple sum)
-            uint32_t checksum = 0;
-            for (char c : buffer) checksum += static_cast<unsigned char>(c);
-            write_pod(out, checksum);
-            out.close();
-            std::filesystem::rename(tmpPath, path);
-            return true;
-        } catch (...) {
+        }
+
+        const size_t payloadSize = image.size() - kHeaderSize;
+        out.patch_u32(8, static_cast<uint32_t>(payloadSize));
+        out.patch_u32(12, crc32c(image.data() + kHeaderSize, payloadSize));
+        return image;
+    }
+
+    // Write to path.tmp, flush it to disk, then rename over path, so a crash
+    // leaves either the old save or the new one
+    bool write_atomically(const std::string& path, const std::vector<uint8_t>& bytes) {
+        const std::string tmpPath = path + ".tmp";
+        std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() &&
+                  std::fflush(file) == 0;
+#ifndef _WIN32
+        ok = ok && ::fsync(::fileno(file)) == 0;
+#endif
+        ok = (std::fclose(file) == 0) && ok;
+        std::error_code ec;
+        if (ok) {
+            std::filesystem::rename(tmpPath, path, ec);
+        }
+        if (!ok || ec) {
+            std::filesystem::remove(tmpPath, ec);
             return false;
         }
+        return true;
     }
 
-    // Add file corruption protection: verify checksum at end of file
-    bool load_from_slot(GameState& outState, int slot) {
-        try {
-            if (slot < 1 || slot > 3) {
-                return false;
-            }
-            std::string path = std::string(kSavesDir) + "/slot" + std::to_string(slot) + ".bin";
-            std::ifstream in(path, std::ios::binary);
-            if (!in) {
-                return false;
+    // Read-only view of a whole file; the parse below reads straight from the mapping
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return;
+            LARGE_INTEGER size{};
+            if (GetFileSizeEx(file, &size) && size.QuadPart > 0 &&
+                static_cast<unsigned long long>(size.QuadPart) <= kMaxSaveSize) {
+                HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    size_ = data_ ? static_cast<size_t>(size.QuadPart) : 0;
+                    CloseHandle(mapping);   // The view keeps the mapping alive
+                }
             }
-            std::vector<char> buffer;
-            // FIXED: Update read_and_append to check for read failures
-            auto read_and_append = [&](auto& v) -> bool {
-                if (!read_pod(in, v)) {
-                    return false; // Read failed
+            CloseHandle(file);
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            struct stat info{};
+            if (::fstat(fd, &info) == 0 && info.st_size > 0 &&
+                static_cast<unsigned long long>(info.st_size) <= kMaxSaveSize) {
+                void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    data_ = static_cast<const uint8_t*>(mapped);
+                    size_ = static_cast<size_t>(info.st_size);
                 }
-                const char* c = reinterpret_cast<const char*>(&v);
-                buffer.insert(buffer.end(), c, c + sizeof(v));
-                return true;
-            };
-            uint32_t magic = 0;
-            uint32_t version = 0;
-            // FIXED: Check that magic and version reads succeeded
-            if (!read_pod(in, magic) || !read_pod(in, version)) {
-                return false; // File too short or corrupted
             }
-            if (magic != kMagic || (version != 1 && version != 2 && version != 3)) {
+            ::close(fd);   // The mapping outlives the descriptor
+#endif
+        }
+
+        ~MappedFile() {
+            if (!data_) return;
+#ifdef _WIN32
+            UnmapViewOfFile(data_);
+#else
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Parse a v4 image. GAME and PLYR are required; the rest default to empty.
+    bool parse_save(const uint8_t* data, size_t size, GameState& outState) {
+        ByteReader header(data, size);
+        header.u32();   // Magic and version, checked by the caller
+        header.u32();
+        const uint32_t payloadSize = header.u32();
+        const uint32_t storedCrc = header.u32();
+        if (!header.ok() || payloadSize != header.remaining()) {
+            return false; // Truncated or padded
+        }
+        const uint8_t* payload = header.cursor();
+        if (crc32c(payload, payloadSize) != storedCrc) {
+            return false; // Corrupt file - checksum mismatch
+        }
+
+        bool hasGame = false;
+        bool hasPlayer = false;
+        Position ppos{};
+        Stats pst{};
+        PlayerClass pclass = PlayerClass::Warrior;
+        std::vector<Item> inv;
+        std::unordered_map<EquipmentSlot, Item> eq;
+        std::vector<StatusEffect> sts;
+        std::vector<Enemy> enemies;
+
+        ByteReader chunks(payload, payloadSize);
+        while (chunks.remaining() > 0) {
+            const uint32_t tag = chunks.u32();
+            const uint32_t chunkSize = chunks.u32();
+            if (!chunks.ok() || chunkSize > chunks.remaining()) {
                 return false;
             }
-            // FIXED: Add error checking for all read operations
-            uint32_t diff = 0;
-            if (!read_and_append(diff)) return false;
-            outState.difficulty = static_cast<Difficulty>(diff);
-            if (!read_and_append(outState.depth)) return false;
-            if (!read_and_append(outState.seed)) return false;
-            if (!read_and_append(outState.stairsDown.x)) return false;
-            if (!read_and_append(outState.stairsDown.y)) return false;
-
-            // Player
-            int px = 0, py = 0;
-            if (!read_and_append(px)) return false;
-            if (!read_and_append(py)) return false;
-            outState.player.set_position(px, py);
-            Stats pst{};
-            if (!read_and_append(pst.maxHp)) return false;
-            if (!read_and_append(pst.hp)) return false;
-            if (!read_and_append(pst.attack)) return false;
-            if (!read_and_append(pst.defense)) return false;
-            if (!read_and_append(pst.speed)) return false;
-
-            // Player class (v3+)
-            PlayerClass pclass = PlayerClass::Warrior;
-            if (version >= 3) {
-                uint32_t pclassVal = 0;
-                if (!read_and_append(pclassVal)) return false;
-                pclass = static_cast<PlayerClass>(pclassVal);
-            }
+            ByteReader in(chunks.cursor(), chunkSize);
+            chunks.skip(chunkSize);
 
-            std::vector<Item> inv;
-            std::unordered_map<EquipmentSlot, Item> eq;
-            std::vector<StatusEffect> sts;
-            if (version >= 2) {
-                uint32_t invCount = 0;
-                if (!read_and_append(invCount)) return false;
-                // FIXED: Validate inventory count to prevent excessive memory allocation
-                if (invCount > 1000) return false; // Unreasonably large inventory
-                inv.reserve(invCount);
-                for (uint32_t i = 0; i < invCount; ++i) {
-                    Item item = read_item(in);
-                    if (item.name.empty() && invCount > 0) {
-                        // Item read may have failed - skip it to prevent corruption
-                        continue;
+            switch (tag) {
+                case kChunkGame:
+                    outState.difficulty = static_cast<Difficulty>(in.u8());
+                    outState.depth = in.i32();
+                    outState.seed = in.u32();
+                    outState.stairsDown.x = in.i32();
+                    outState.stairsDown.y = in.i32();
+                    hasGame = true;
+                    break;
+                case kChunkPlayer:
+                    ppos.x = in.i32();
+                    ppos.y = in.i32();
+                    pst.maxHp = in.i32();
+                    pst.hp = in.i32();
+                    pst.attack = in.i32();
+                    pst.defense = in.i32();
+                    pst.speed = in.i32();
+                    pclass = static_cast<PlayerClass>(in.u8());
+                    hasPlayer = true;
+                    break;
+                case kChunkInventory: {
+                    size_t count = in.count(36);
+                    inv.reserve(count);
+                    for (size_t i = 0; i < count && in.ok(); ++i) {
+                        inv.push_back(read_item(in));
                     }
-                    inv.push_back(item);
+                    break;
                 }
-                uint32_t eqCount = 0;
-                if (!read_and_append(eqCount)) return false;
-                // FIXED: Validate equipment count
-                // IMPROVED: Use named constant for max equipment slots
-                if (eqCount > game_constants::MAX_EQUIPMENT_SLOTS) return false; // Max equipment slots
-                for (uint32_t i = 0; i < eqCount; ++i) {
-                    EquipmentSlot slot{};
-                    if (!read_and_append(slot)) return false;
-                    Item it = read_item(in);
-                    if (it.name.empty()) continue; // Skip invalid items
-                    eq[slot] = it;
+                case kChunkEquipment: {
+                    size_t count = in.count(37);
+                    if (count > static_cast<size_t>(game_constants::MAX_EQUIPMENT_SLOTS)) return false;
+                    for (size_t i = 0; i < count && in.ok(); ++i) {
+                        EquipmentSlot slot = static_cast<EquipmentSlot>(in.u8());
+                        eq[slot] = read_item(in);
+                    }
+                    break;
                 }
-                uint32_t stCount = 0;
-                if (!read_and_append(stCount)) return false;
-                // FIXED: Validate status count
-                // IMPROVED: Use named constant for max status effects
-                if (stCount > game_constants::MAX_STATUS_EFFECTS) return false; // Unreasonably many status effects
-                sts.reserve(stCount);
-                for (uint32_t i = 0; i < stCount; ++i) {
-                    StatusEffect s{};
-                    if (!read_and_append(s.type)) return false;
-                    if (!read_and_append(s.remainingTurns)) return false;
-                    if (!read_and_append(s.magnitude)) return false;
-                    sts.push_back(s);
+                case kChunkStatuses: {
+                    size_t count = in.count(9);
+                    if (count > static_cast<size_t>(game_constants::MAX_STATUS_EFFECTS)) return false;
+                    sts.reserve(count);
+                    for (size_t i = 0; i < count && in.ok(); ++i) {
+                        StatusEffect st;
+                        st.type = static_cast<StatusType>(in.u8());
+                        st.remainingTurns = in.i32();
+                        st.magnitude = in.i32();
+                        sts.push_back(st);
+                    }
+                    break;
+                }
+                case kChunkEnemies: {
+                    size_t count = in.count(31);
+                    if (count > static_cast<size_t>(game_constants::MAX_ENEMIES_PER_FLOOR)) return false;
+                    enemies.reserve(count);
+                    for (size_t i = 0; i < count && in.ok(); ++i) {
+                        EnemyType type = static_cast<EnemyType>(in.u8());
+                        EnemyArchetype arch = static_cast<EnemyArchetype>(in.u8());
+                        Enemy e(type, arch);
+                        int ex = in.i32();
+                        int ey = in.i32();
+                        e.set_position(ex, ey);
+                        e.set_height(static_cast<HeightLevel>(in.u8()));
+                        Stats& est = e.stats();
+                        est.maxHp = in.i32();
+                        est.hp = in.i32();
+                        est.attack = in.i32();
+                        est.defense = in.i32();
+                        est.speed = in.i32();
+                        enemies.push_back(std::move(e));
+                    }
+                    break;
                 }
-                outState.player.load_from_persisted(pst, inv, eq, sts, pclass);
-            } else {
-                // v1 compatibility: no inventory/equipment/statuses
-                outState.player.get_stats() = pst;
+                default:
+                    // Written by a newer build: skip it
+                    break;
+            }
+            // Chunks may grow fields at the end; reading past one is corruption
+            if (!in.ok()) {
+                return false;
             }
+        }
+        if (!chunks.ok() || !hasGame || !hasPlayer) {
+            return false;
+        }
 
-            // Enemies
-            uint32_t enemyCount = 0;
-            if (!read_and_append(enemyCount)) return false;
-            // FIXED: Validate enemy count to prevent excessive memory allocation
-            // IMPROVED: Use named constant for max enemies
-            if (enemyCount > game_constants::MAX_ENEMIES_PER_FLOOR) return false; // Unreasonably many enemies
-            outState.enemies.clear();
-            outState.enemies.reserve(enemyCount);
-            for (uint32_t i = 0; i < enemyCount; ++i) {
-                int ex = 0, ey = 0;
-                Stats est{};
-                uint32_t arch = 0;
-                if (!read_and_append(ex)) return false;
-                if (!read_and_append(ey)) return false;
-                if (!read_and_append(est.maxHp)) return false;
-                if (!read_and_append(est.hp)) return false;
-                if (!read_and_append(est.attack)) return false;
-                if (!read_and_append(est.defense)) return false;
-                if (!read_and_append(est.speed)) return false;
-                if (!read_and_append(arch)) return false;
-                Enemy e(static_cast<EnemyArchetype>(arch), 'e', "\033[38;5;160m");
-                e.set_position(ex, ey);
-                e.stats() = est;
-                outState.enemies.push_back(e);
+        outState.player.set_position(ppos.x, ppos.y);
+        outState.player.load_from_persisted(pst, inv, eq, sts, pclass);
+        outState.enemies = std::move(enemies);
+        return true;
+    }
+
+    // Loader for v1-v3 files (flat stream, byte-sum checksum)
+    bool load_legacy(const std::string& path, GameState& outState) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        std::vector<char> buffer;
+        // FIXED: Update read_and_append to check for read failures
+        auto read_and_append = [&](auto& v) -> bool {
+            if (!read_pod(in, v)) {
+                return false; // Read failed
             }
-            // FIXED: Read and verify checksum with error checking
-            uint32_t fileChecksum = 0;
-            if (!read_pod(in, fileChecksum)) {
-                return false; // Checksum read failed - file truncated
+            const char* c = reinterpret_cast<const char*>(&v);
+            buffer.insert(buffer.end(), c, c + sizeof(v));
+            return true;
+        };
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        // FIXED: Check that magic and version reads succeeded
+        if (!read_pod(in, magic) || !read_pod(in, version)) {
+            return false; // File too short or corrupted
+        }
+        if (magic != kMagic || (version != 1 && version != 2 && version != 3)) {
+            return false;
+        }
+        // FIXED: Add error checking for all read operations
+        uint32_t diff = 0;
+        if (!read_and_append(diff)) return false;
+        outState.difficulty = static_cast<Difficulty>(diff);
+        if (!read_and_append(outState.depth)) return false;
+        if (!read_and_append(outState.seed)) return false;
+        if (!read_and_append(outState.stairsDown.x)) return false;
+        if (!read_and_append(outState.stairsDown.y)) return false;
+
+        // Player
+        int px = 0, py = 0;
+        if (!read_and_append(px)) return false;
+        if (!read_and_append(py)) return false;
+        outState.player.set_position(px, py);
+        Stats pst{};
+        if (!read_and_append(pst.maxHp)) return false;
+        if (!read_and_append(pst.hp)) return false;
+        if (!read_and_append(pst.attack)) return false;
+        if (!read_and_append(pst.defense)) return false;
+        if (!read_and_append(pst.speed)) return false;
+
+        // Player class (v3+)
+        PlayerClass pclass = PlayerClass::Warrior;
+        if (version >= 3) {
+            uint32_t pclassVal = 0;
+            if (!read_and_append(pclassVal)) return false;
+            pclass = static_cast<PlayerClass>(pclassVal);
+        }
+
+        std::vector<Item> inv;
+        std::unordered_map<EquipmentSlot, Item> eq;
+        std::vector<StatusEffect> sts;
+        if (version >= 2) {
+            uint32_t invCount = 0;
+            if (!read_and_append(invCount)) return false;
+            // FIXED: Validate inventory count to prevent excessive memory allocation
+            if (invCount > 1000) return false; // Unreasonably large inventory
+            inv.reserve(invCount);
+            for (uint32_t i = 0; i < invCount; ++i) {
+                Item item = read_item(in);
+                if (item.name.empty() && invCount > 0) {
+                    // Item read may have failed - skip it to prevent corruption
+                    continue;
+                }
+                inv.push_back(item);
             }
-            uint32_t calcChecksum = 0;
-            for (char c : buffer) calcChecksum += static_cast<unsigned char>(c);
-            if (fileChecksum != calcChecksum) {
-                return false; // Corrupt file - checksum mismatch
+            uint32_t eqCount = 0;
+            if (!read_and_append(eqCount)) return false;
+            // FIXED: Validate equipment count
+            // IMPROVED: Use named constant for max equipment slots
+            if (eqCount > game_constants::MAX_EQUIPMENT_SLOTS) return false; // Max equipment slots
+            for (uint32_t i = 0; i < eqCount; ++i) {
+                EquipmentSlot slot{};
+                if (!read_and_append(slot)) return false;
+                Item it = read_item(in);
+                if (it.name.empty()) continue; // Skip invalid items
+                eq[slot] = it;
             }
-            return true;
+            uint32_t stCount = 0;
+            if (!read_and_append(stCount)) return false;
+            // FIXED: Validate status count
+            // IMPROVED: Use named constant for max status effects
+            if (stCount > game_constants::MAX_STATUS_EFFECTS) return false; // Unreasonably many status effects
+            sts.reserve(stCount);
+            for (uint32_t i = 0; i < stCount; ++i) {
+                StatusEffect s{};
+                if (!read_and_append(s.type)) return false;
+                if (!read_and_append(s.remainingTurns)) return false;
+                if (!read_and_append(s.magnitude)) return false;
+                sts.push_back(s);
+            }
+            outState.player.load_from_persisted(pst, inv, eq, sts, pclass);
+        } else {
+            // v1 compatibility: no inventory/equipment/statuses
+            outState.player.get_stats() = pst;
+        }
+
+        // Enemies
+        uint32_t enemyCount = 0;
+        if (!read_and_append(enemyCount)) return false;
+        // FIXED: Validate enemy count to prevent excessive memory allocation
+        // IMPROVED: Use named constant for max enemies
+        if (enemyCount > game_constants::MAX_ENEMIES_PER_FLOOR) return false; // Unreasonably many enemies
+        outState.enemies.clear();
+        outState.enemies.reserve(enemyCount);
+        for (uint32_t i = 0; i < enemyCount; ++i) {
+            int ex = 0, ey = 0;
+            Stats est{};
+            uint32_t arch = 0;
+            if (!read_and_append(ex)) return false;
+            if (!read_and_append(ey)) return false;
+            if (!read_and_append(est.maxHp)) return false;
+            if (!read_and_append(est.hp)) return false;
+            if (!read_and_append(est.attack)) return false;
+            if (!read_and_append(est.defense)) return false;
+            if (!read_and_append(est.speed)) return false;
+            if (!read_and_append(arch)) return false;
+            Enemy e(static_cast<EnemyArchetype>(arch), 'e', "\033[38;5;160m");
+            e.set_position(ex, ey);
+            e.stats() = est;
+            outState.enemies.push_back(e);
+        }
+        // FIXED: Read and verify checksum with error checking
+        uint32_t fileChecksum = 0;
+        if (!read_pod(in, fileChecksum)) {
+            return false; // Checksum read failed - file truncated
+        }
+        uint32_t calcChecksum = 0;
+        for (char c : buffer) calcChecksum += static_cast<unsigned char>(c);
+        // FIXED: The v3 writer also summed magic and version, which this
+        // loader skipped, so its own files never verified; accept both sums
+        uint32_t withHeader = calcChecksum;
+        for (uint32_t word : {magic, version}) {
+            for (int i = 0; i < 4; ++i) withHeader += (word >> (8 * i)) & 0xFFu;
+        }
+        if (fileChecksum != calcChecksum && fileChecksum != withHeader) {
+            return false; // Corrupt file - checksum mismatch
+        }
+        return true;
+    }
+}
+
+namespace fileio {
+    // IMPROVED: v4 chunked save - built in one buffer, written with a single
+    // write and an atomic rename
+    bool save_to_slot(const GameState& state, int slot) {
+        PROF_ZONE("save_slot");
+        try {
+            return write_slot_image(build_save(state), slot);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> encode_save(const GameState& state) {
+        return build_save(state);
+    }
+
+    bool write_slot_image(const std::vector<uint8_t>& image, int slot) {
+        try {
+            if (slot < 1 || slot > 3) {
+                return false;
+            }
+            std::filesystem::create_directories(kSavesDir);
+            return write_atomically(slot_path(slot), image);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    // IMPROVED: v4 saves are parsed in place from a memory-mapped file
+    bool load_from_slot(GameState& outState, int slot) {
+        PROF_ZONE("load_slot");
+        try {
+            if (slot < 1 || slot > 3) {
+                return false;
+            }
+            std::string path = slot_path(slot);
+            uint32_t version = 0;
+            {
+                MappedFile file(path);
+                ByteReader header(file.data(), file.size());
+                if (header.u32() != kMagic) {
+                    return false;
+                }
+                version = header.u32();
+                if (version == kVersion) {
+                    return parse_save(file.data(), file.size(), outState);
+                }
+            }
+            if (version >= 1 && version <= 3) {
+                return load_legacy(path, outState);
+            }
+            return false;
         } catch (...) {
             return false;
         }
     }
 
     bool delete_slot(int slot) {
+        PROF_ZONE("delete_slot");
         if (slot < 1 || slot > 3) {
             return false;
         }
-        std::string path = std::string(kSavesDir) + "/slot" + std::to_string(slot) + ".bin";
-        return std::filesystem::remove(path);
+        return std::filesystem::remove(slot_path(slot));
     }
 
     // Corpse management
@@ -47,6 +47,22 @@ namespace fileio {
      */
     bool save_to_slot(const GameState& state, int slot);
 
+    /**
+     * @brief Encode a game state as a complete save image (what save_to_slot writes).
+     * @param state The GameState to encode.
+     * @return Header and chunks, ready for write_slot_image.
+     */
+    std::vector<uint8_t> encode_save(const GameState& state);
+
+    /**
+     * @brief Write a save image to a slot atomically (temp file, fsync, rename).
+     * Safe to call from a worker thread; touches only the slot's files.
+     * @param image Image from encode_save.
+     * @param slot The save slot index.
+     * @return True if the slot now holds the image.
+     */
+    bool write_slot_image(const std::vector<uint8_t>& image, int slot);
+
     /**
      * @brief Load a game state from a save slot.
      * @param outState Output parameter for loaded GameState.
@@ -1,6 +1,6 @@
 #include "floor_manager.h"
 #include "logger.h"
-#include <random>
+#include "rng.h"
 #include <algorithm>
 
 // Global instance
@@ -86,15 +86,19 @@ void FloorManager::generate_floor(int floorNum) {
     // Populate with enemies
     populate_enemies(floor, floorNum);
     
-    // Store in cache
-    floors_[floorNum] = std::move(floor);
+    // Store in cache (the grid is rebuilt in place: moving the vector would
+    // leave the enemies pointing at the temporary's grid)
+    FloorData& stored = floors_[floorNum];
+    stored = std::move(floor);
+    stored.occupancy.rebuild(stored.dungeon.width(), stored.dungeon.height(), stored.enemies);
     
     LOG_INFO("Floor " + std::to_string(floorNum) + " generated with " + 
              std::to_string(floors_[floorNum].enemies.size()) + " enemies");
 }
 
 void FloorManager::populate_enemies(FloorData& floor, int depth) {
-    std::mt19937 rng(floor.seed + 12345);
+    // IMPROVED: Per-floor world stream derived from the floor seed
+    Rng spawnRng(rngs::derive_seed(floor.seed, rngs::Stream::World, depth));
     
     // Number of enemies scales with depth
     int baseEnemies = 3;
@@ -109,8 +113,8 @@ void FloorManager::populate_enemies(FloorData& floor, int depth) {
         int x, y;
         int attempts = 0;
         do {
-            x = xDist(rng);
-            y = yDist(rng);
+            x = xDist(spawnRng);
+            y = yDist(spawnRng);
             attempts++;
         } while (!floor.dungeon.is_walkable(x, y) && attempts < 100);
         
@@ -118,7 +122,7 @@ void FloorManager::populate_enemies(FloorData& floor, int depth) {
         
         // Determine enemy type based on depth
         EnemyType type;
-        int roll = typeDist(rng);
+        int roll = typeDist(spawnRng);
         
         if (depth <= 2) {
             // Early floors: rats, spiders, goblins
@@ -195,19 +199,3 @@ int FloorManager::floors_visited() const {
     }
     return count;
 }
-
-void FloorManager::save_floor(int floorNum, std::ostream& out) const {
-    // Placeholder for serialization
-    // Would serialize dungeon, enemies, items, etc.
-    (void)floorNum;
-    (void)out;
-}
-
-bool FloorManager::load_floor(int floorNum, std::istream& in) {
-    // Placeholder for deserialization
-    (void)floorNum;
-    (void)in;
-    return false;
-}
-
-
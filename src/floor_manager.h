@@ -5,6 +5,7 @@
 #include <memory>
 #include "dungeon.h"
 #include "enemy.h"
+#include "occupancy_grid.h"
 #include "types.h"
 
 // Data for a single floor
@@ -12,6 +13,7 @@ struct FloorData {
     Dungeon dungeon;
     std::vector<Enemy> enemies;
     std::vector<Item> items;  // Items on ground
+    OccupancyGrid occupancy;  // Tile -> index into enemies; rebuild after adding/removing enemies
     Position stairsUp;
     Position stairsDown;
     bool visited = false;
@@ -58,12 +60,6 @@ public:
     // Get total floors visited
     int floors_visited() const;
     
-    // Serialize floor data for saving
-    void save_floor(int floorNum, std::ostream& out) const;
-    
-    // Load floor data
-    bool load_floor(int floorNum, std::istream& in);
-    
 private:
     // Generate a new floor
     void generate_floor(int floorNum);
@@ -0,0 +1,148 @@
+#include "game_session.h"
+#include "glyphs.h"
+#include "logger.h"
+#include <algorithm>
+
+GameSession::GameSession(unsigned int seed, Difficulty difficulty) {
+    reset(seed, difficulty);
+}
+
+void GameSession::reset(unsigned int newSeed, Difficulty newDifficulty) {
+    seed = newSeed;
+    difficulty = newDifficulty;
+    params = get_difficulty_params(newDifficulty);
+    streams.reseed(newSeed);
+    floors.init(newSeed);
+}
+
+void GameSession::create_player(PlayerClass playerClass) {
+    player = Player(playerClass);
+    player.get_stats().maxHp += params.playerHpBoost;
+    player.get_stats().hp = player.get_stats().maxHp;
+    player.set_depth(depth);  // Set initial depth for attack bonus
+
+    // All classes get a starter sword
+    Item starterWeapon;
+    starterWeapon.type = ItemType::Weapon;
+    starterWeapon.isEquippable = true;
+    starterWeapon.slot = EquipmentSlot::Weapon;
+    starterWeapon.rarity = Rarity::Common;
+    starterWeapon.attackBonus = 2;  // Small starter bonus
+    starterWeapon.name = "Starter Sword";
+    player.inventory().push_back(starterWeapon);
+    LOG_INFO("Added starter weapon: " + starterWeapon.name);
+
+    // Add 5 healing potions to starting inventory
+    for (int i = 0; i < 5; ++i) {
+        Item healingPotion;
+        healingPotion.name = "Healing Potion";
+        healingPotion.type = ItemType::Consumable;
+        healingPotion.isConsumable = true;
+        healingPotion.healAmount = 20;  // Heals 20 HP
+        healingPotion.rarity = Rarity::Common;
+        player.inventory().push_back(healingPotion);
+    }
+    LOG_INFO("Added 5 healing potions to starting inventory");
+}
+
+void GameSession::enter_cached_floor(int floorNum) {
+    floors.set_current_floor(floorNum);
+    floor = floors.current();
+    depth = floorNum;
+    for (auto& e : floor.enemies) {
+        e.stats().maxHp = std::max(1, static_cast<int>(e.stats().maxHp * params.enemyHpMultiplier));
+        e.stats().hp = e.stats().maxHp;
+        e.stats().attack = static_cast<int>(e.stats().attack * params.enemyDamageMultiplier);
+    }
+    // The copy's enemies still point at the cached floor's grid
+    floor.occupancy.rebuild(floor.dungeon.width(), floor.dungeon.height(), floor.enemies);
+    initialize_traps();
+    player.set_position(floor.stairsUp.x, floor.stairsUp.y);
+    player.set_depth(depth);
+}
+
+void GameSession::initialize_traps() {
+    const Dungeon& dungeon = floor.dungeon;
+    Rng floorRng = streams.for_floor(rngs::Stream::World, depth);
+    traps.clear();
+    for (int y = 0; y < dungeon.height(); ++y) {
+        for (int x = 0; x < dungeon.width(); ++x) {
+            if (dungeon.get_tile(x, y) == TileType::Trap) {
+                TrapType type = traps::get_random_trap_type(floorRng);
+                traps.push_back(traps::create_trap(x, y, type));
+            }
+        }
+    }
+    LOG_DEBUG("Initialized " + std::to_string(traps.size()) + " traps on floor");
+}
+
+void GameSession::check_trap_at_player() {
+    Position pos = player.get_position();
+
+    for (auto& trap : traps) {
+        if (trap.position.x == pos.x && trap.position.y == pos.y && !trap.triggered) {
+            // Check if player detects it first
+            if (!trap.detected && traps::player_detects_trap(player, trap, rng(rngs::Stream::World))) {
+                trap.detected = true;
+                log.add(MessageType::Warning, "\033[93m" + std::string(glyphs::warning()) + " You spot a " +
+                        traps::get_trap_description(trap.type) + "!\033[0m");
+                return;  // Don't trigger if just detected
+            }
+
+            // Trigger the trap
+            traps::trigger_trap(trap, player, floor.dungeon, log, rng(rngs::Stream::World));
+            return;
+        }
+    }
+}
+
+void GameSession::apply_tile_effects() {
+    Dungeon& dungeon = floor.dungeon;
+    Position playerPos = player.get_position();
+    TileType currentTile = dungeon.get_tile(playerPos.x, playerPos.y);
+    if (currentTile == TileType::Trap) {
+        // Trap: deal damage and convert to floor
+        int trapDamage = 2 + depth;
+        player.get_stats().hp -= trapDamage;
+        // Clamp HP to 0 minimum (player dies if HP <= 0, checked elsewhere)
+        if (player.get_stats().hp < 0) {
+            player.get_stats().hp = 0;
+        }
+        log.add(MessageType::Damage, "You triggered a trap! (-" + std::to_string(trapDamage) + " HP)");
+        dungeon.set_tile(playerPos.x, playerPos.y, TileType::Floor);
+    } else if (currentTile == TileType::Shrine) {
+        // Shrine: heal or buff
+        std::uniform_int_distribution<int> shrineRoll(0, 100);
+        int roll = shrineRoll(rng(rngs::Stream::World));
+        if (roll < 50) {
+            // Heal
+            int healAmt = 5 + depth;
+            player.get_stats().hp = std::min(player.get_stats().hp + healAmt, player.get_stats().maxHp);
+            log.add(MessageType::Heal, "The shrine heals you! (+" + std::to_string(healAmt) + " HP)");
+        } else {
+            // Haste buff
+            player.apply_status(StatusEffect{StatusType::Haste, 10, 3});
+            log.add(MessageType::Heal, "The shrine hastens you! (+3 SPD for 10 turns)");
+        }
+        dungeon.set_tile(playerPos.x, playerPos.y, TileType::Floor);
+    } else if (currentTile == TileType::Water) {
+        // Water: slows movement (message only, actual slow would need turn system)
+        if (!waterMessageShown_) {
+            log.add(MessageType::Info, "You wade through the water...");
+            waterMessageShown_ = true;
+        }
+    } else if (currentTile == TileType::Lava) {
+        // Lava: massive damage (shouldn't be walkable, but just in case)
+        int lavaDamage = 20 + depth * 2;
+        player.get_stats().hp -= lavaDamage;
+        // Clamp HP to 0 minimum (player dies if HP <= 0, checked elsewhere)
+        if (player.get_stats().hp < 0) {
+            player.get_stats().hp = 0;
+        }
+        log.add(MessageType::Damage, "You step into LAVA! (-" + std::to_string(lavaDamage) + " HP)");
+    } else if (currentTile == TileType::Chasm) {
+        // Chasm: instant death (shouldn't be walkable)
+        player.get_stats().hp = 0;
+        log.add(MessageType::Death, "You fall into the endless chasm!");
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "types.h"
+#include "globals.h"
+#include "rng.h"
+#include "player.h"
+#include "floor_manager.h"
+#include "traps.h"
+#include "ui.h"
+
+// Everything one game mutates: the player, the live floor and its traps, a
+// floor cache, the RNG streams and the message log. Nothing here is global, so any
+// number of sessions can run side by side in one process (interactive game,
+// headless bot runs, batch simulation workers).
+struct GameSession {
+    unsigned int seed = 0;
+    Difficulty difficulty = Difficulty::Adventurer;
+    DifficultyParams params;
+    int depth = 1;                        // Current floor depth
+
+    Player player;
+    FloorData floor;                      // Live floor: dungeon, enemies, occupancy grid
+    FloorManager floors;                  // Seeded floor cache for runs that use FloorManager floors
+    std::vector<traps::Trap> traps;       // Traps on the live floor
+    rngs::Streams streams;                // Per-subsystem RNG streams derived from seed
+    MessageLog log;
+
+    // Run statistics
+    int turns = 0;
+    int kills = 0;
+    std::string lastAttacker = "Unknown"; // Last enemy that hit the player (cause of death)
+
+    GameSession() = default;
+    GameSession(unsigned int seed, Difficulty difficulty);
+    // Enemies on the live floor point at its occupancy grid, so sessions stay put
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    // Re-seed the RNG streams and floor cache and pick up difficulty params
+    void reset(unsigned int newSeed, Difficulty newDifficulty);
+
+    // New-game player: class stats, difficulty HP boost and the starter kit
+    // (starter sword and five healing potions)
+    void create_player(PlayerClass playerClass);
+
+    // Make a floor from the session's FloorManager cache the live floor:
+    // difficulty scaling, traps, player at the stairs up
+    void enter_cached_floor(int floorNum);
+
+    // Shorthand for one of the session's RNG streams
+    Rng& rng(rngs::Stream stream) { return streams.get(stream); }
+
+    // Rebuild the trap list from the live floor's trap tiles (trap types come
+    // from the floor's own world stream, so they depend only on seed and depth)
+    void initialize_traps();
+
+    // Detect or trigger a trap under the player
+    void check_trap_at_player();
+
+    // Tile effects after the player moves (trap, shrine, water, lava, chasm)
+    void apply_tile_effects();
+
+private:
+    bool waterMessageShown_ = false;
+};
@@ -0,0 +1,327 @@
+#include "headless.h"
+#include "ai.h"
+#include "combat.h"
+#include "constants.h"
+#include "game_session.h"
+#include "globals.h"
+#include "logger.h"
+#include "loot.h"
+#include "pathfinding.h"
+#include "player.h"
+#include "ui.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    // The bot drinks a healing potion below this share of max HP
+    constexpr int POTION_HP_PERCENT = 35;
+
+    // Upper bound on seeds per pool task
+    constexpr uint32_t SEED_CHUNK = 64;
+
+    // One simulated run: its own game session plus the bot's scratch state
+    struct Run {
+        GameSession session;
+        Player& player = session.player;
+        std::vector<Position> path;
+        headless::RunResult result;
+    };
+
+    int find_healing_potion(const Player& player) {
+        const auto& inv = player.inventory();
+        for (size_t i = 0; i < inv.size(); ++i) {
+            if (inv[i].isConsumable && inv[i].healAmount > 0) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool hp_is_low(const Player& player) {
+        const auto& stats = player.get_stats();
+        return stats.hp * 100 < stats.maxHp * POTION_HP_PERCENT;
+    }
+
+    // Damaging actions in the order the bot prefers them (SKILL is a no-op for Rogues)
+    constexpr CombatAction ATTACK_PRIORITY[] = {
+        CombatAction::POWER_STRIKE, CombatAction::FIREBALL, CombatAction::SNIPE,
+        CombatAction::SLASH, CombatAction::FROST_BOLT, CombatAction::SHOOT, CombatAction::SKILL
+    };
+
+    // Combat policy: heal when low, otherwise the strongest attack that is off cooldown
+    CombatAction choose_combat_action(const Player& player, const Enemy& /*enemy*/,
+                                      CombatDistance distance, int& consumableIndex) {
+        if (hp_is_low(player)) {
+            int potion = find_healing_potion(player);
+            if (potion >= 0) {
+                consumableIndex = potion;
+                return CombatAction::CONSUMABLE;
+            }
+        }
+        auto available = combat::get_available_actions(player, distance);
+        for (CombatAction action : ATTACK_PRIORITY) {
+            if ((action != CombatAction::SKILL || player.player_class() != PlayerClass::Rogue) &&
+                std::find(available.begin(), available.end(), action) != available.end()) {
+                return action;
+            }
+        }
+        return CombatAction::WAIT;
+    }
+
+    // Equip anything that beats what is worn in the same slot
+    void equip_if_better(Player& player, size_t inventoryIndex) {
+        const Item& item = player.inventory()[inventoryIndex];
+        if (!item.isEquippable) {
+            return;
+        }
+        int score = item.attackBonus + item.defenseBonus + item.hpBonus;
+        auto worn = player.get_equipment().find(item.slot);
+        if (worn == player.get_equipment().end() ||
+            worn->second.attackBonus + worn->second.defenseBonus + worn->second.hpBonus < score) {
+            player.equip_item(inventoryIndex);
+        }
+    }
+
+    // Place the player on a cached floor and record the deepest floor reached
+    void enter_floor(Run& run, int floorNum) {
+        run.session.enter_cached_floor(floorNum);
+        run.result.depth = std::max(run.result.depth, floorNum);
+    }
+
+    bool player_dead(const Run& run) {
+        return run.player.get_stats().hp <= 0;
+    }
+
+    void fight(Run& run, FloorData& floor, Enemy& enemy) {
+        combat::auto_resolve_combat(run.player, enemy, floor.dungeon, run.session.log, choose_combat_action);
+        if (player_dead(run)) {
+            run.result.killer = enemy.name();
+        }
+    }
+
+    // Remove dead enemies, award loot like the interactive game, and count kills
+    void collect_dead(Run& run, FloorData& floor) {
+        int depth = run.session.depth;
+        Rng& rng = run.session.rng(rngs::Stream::Loot);
+        auto& enemies = floor.enemies;
+        size_t before = enemies.size();
+        for (auto it = enemies.begin(); it != enemies.end();) {
+            if (it->stats().hp > 0) {
+                ++it;
+                continue;
+            }
+            int roll = std::uniform_int_distribution<int>(0, 100)(rng);
+            int itemCount = roll >= 90 ? 3 : roll >= 70 ? 2 : 1;
+            for (int i = 0; i < itemCount; ++i) {
+                int typeRoll = std::uniform_int_distribution<int>(0, 100)(rng);
+                Item drop = typeRoll < 40 ? loot::generate_weapon(depth, rng)
+                          : typeRoll < 70 ? loot::generate_armor(depth, rng)
+                                          : loot::generate_consumable(depth, rng);
+                run.player.inventory().push_back(drop);
+                equip_if_better(run.player, run.player.inventory().size() - 1);
+            }
+            ++run.result.kills;
+            it = enemies.erase(it);
+        }
+        if (enemies.size() != before) {
+            floor.occupancy.rebuild(floor.dungeon.width(), floor.dungeon.height(), enemies);
+        }
+    }
+
+    const char* outcome_name(headless::Outcome outcome) {
+        switch (outcome) {
+            case headless::Outcome::Victory: return "victory";
+            case headless::Outcome::Death: return "death";
+            case headless::Outcome::Stalled: return "stalled";
+        }
+        return "?";
+    }
+}
+
+namespace headless {
+
+RunResult run_one(uint32_t seed, const Options& options) {
+    Run run;
+    run.session.reset(seed, options.difficulty);
+    rngs::Bind bindStreams(run.session.streams);  // Combat and AI draw from this run's streams
+    run.result.seed = seed;
+    run.session.create_player(options.playerClass);
+    equip_if_better(run.player, 0);  // Starter sword
+    enter_floor(run, 1);
+
+    ai::PathEngine& engine = ai::path_engine();
+    for (int turn = 0; turn < options.maxTurns; ++turn) {
+        run.result.turns = turn + 1;
+        FloorData& floor = run.session.floor;
+        Dungeon& dungeon = floor.dungeon;
+        Position pos = run.player.get_position();
+
+        // Player turn: heal, take the stairs, or step along the route to them
+        int potion = hp_is_low(run.player) ? find_healing_potion(run.player) : -1;
+        if (potion >= 0) {
+            run.player.use_consumable(static_cast<size_t>(potion));
+        } else if (dungeon.get_tile(pos.x, pos.y) == TileType::StairsDown) {
+            if (run.session.depth >= game_constants::BOSS_FLOOR_3) {
+                run.result.outcome = Outcome::Victory;
+                return run.result;
+            }
+            enter_floor(run, run.session.depth + 1);
+            continue;
+        } else {
+            int budget = dungeon.width() * dungeon.height();
+            if (!engine.find_path(dungeon, pos, floor.stairsDown, run.path, budget) || run.path.empty()) {
+                run.result.outcome = Outcome::Stalled;
+                return run.result;
+            }
+            const Position next = run.path.front();
+            int32_t slot = floor.occupancy.at(next.x, next.y);
+            if (slot != OccupancyGrid::EMPTY && static_cast<size_t>(slot) < floor.enemies.size()) {
+                fight(run, floor, floor.enemies[static_cast<size_t>(slot)]);
+            } else {
+                run.player.set_position(next.x, next.y);
+                run.session.check_trap_at_player();
+                run.session.apply_tile_effects();
+                if (player_dead(run)) {
+                    run.result.killer = "the dungeon";
+                }
+            }
+        }
+        if (player_dead(run)) {
+            run.result.outcome = Outcome::Death;
+            return run.result;
+        }
+
+        // Enemy turns; anything that ends up adjacent starts a fight
+        dungeon.compute_fov(run.player.get_position(), constants::fov_radius);
+        for (auto& enemy : floor.enemies) {
+            if (enemy.stats().hp <= 0) {
+                continue;
+            }
+            ai::take_turn(enemy, run.player, dungeon, run.session.log);
+            Position ep = enemy.get_position();
+            Position pp = run.player.get_position();
+            if (std::abs(ep.x - pp.x) + std::abs(ep.y - pp.y) == 1) {
+                fight(run, floor, enemy);
+                if (player_dead(run)) {
+                    break;
+                }
+            }
+        }
+        collect_dead(run, floor);
+
+        run.player.tick_statuses();
+        run.player.tick_cooldowns();
+        if (player_dead(run)) {
+            run.result.outcome = Outcome::Death;
+            if (run.result.killer.empty()) {
+                run.result.killer = "status effects";
+            }
+            return run.result;
+        }
+    }
+    run.result.outcome = Outcome::Stalled;
+    return run.result;
+}
+
+std::vector<RunResult> run_seeds(const Options& options) {
+    const uint32_t runs = static_cast<uint32_t>(std::max(0, options.runs));
+    std::vector<RunResult> results;
+    results.reserve(runs);
+    if (options.threads == 1) {
+        for (uint32_t i = 0; i < runs; ++i) {
+            results.push_back(run_one(options.firstSeed + i, options));
+        }
+        return results;
+    }
+
+    // Seeds go out in small chunks (several per worker) so stealing can even
+    // out runs of very different lengths. Each worker appends to its own
+    // buffer; buffers are merged once everything has finished.
+    WorkStealingPool pool(options.threads);
+    struct alignas(64) WorkerResults {
+        std::vector<RunResult> results;
+    };
+    std::vector<WorkerResults> buffers(pool.size());
+    const uint32_t chunk = std::max<uint32_t>(1, std::min<uint32_t>(SEED_CHUNK, runs / (pool.size() * 4) + 1));
+    for (uint32_t first = 0; first < runs; first += chunk) {
+        const uint32_t last = std::min(runs, first + chunk);
+        pool.submit([&options, &buffers, first, last](unsigned worker) {
+            for (uint32_t i = first; i < last; ++i) {
+                buffers[worker].results.push_back(run_one(options.firstSeed + i, options));
+            }
+        });
+    }
+    pool.wait();
+
+    for (auto& buffer : buffers) {
+        results.insert(results.end(), buffer.results.begin(), buffer.results.end());
+    }
+    std::sort(results.begin(), results.end(),
+              [](const RunResult& a, const RunResult& b) { return a.seed < b.seed; });
+    return results;
+}
+
+int run_batch(const Options& options) {
+    ui::set_headless(true);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<RunResult> results = run_seeds(options);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ui::set_headless(false);
+    for (const auto& r : results) {
+        LOG_DEBUG("Headless run seed " + std::to_string(r.seed) + ": " +
+                  outcome_name(r.outcome) + " at depth " + std::to_string(r.depth));
+    }
+
+    int victories = 0, deaths = 0, stalled = 0, maxDepth = 0;
+    long long depthSum = 0, turnSum = 0, killSum = 0;
+    std::map<std::string, int> killers;
+    for (const auto& r : results) {
+        switch (r.outcome) {
+            case Outcome::Victory: ++victories; break;
+            case Outcome::Death: ++deaths; ++killers[r.killer]; break;
+            case Outcome::Stalled: ++stalled; break;
+        }
+        maxDepth = std::max(maxDepth, r.depth);
+        depthSum += r.depth;
+        turnSum += r.turns;
+        killSum += r.kills;
+    }
+
+    const double n = results.empty() ? 1.0 : static_cast<double>(results.size());
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Headless: " << results.size() << " runs, seeds " << options.firstSeed << ".."
+              << (options.firstSeed + static_cast<uint32_t>(std::max(0, options.runs - 1)))
+              << ", " << Player::class_name(options.playerClass) << ", max " << options.maxTurns << " turns, "
+              << (options.threads == 0 ? std::thread::hardware_concurrency() : options.threads) << " thread(s)\n";
+    std::cout << "  time:      " << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(1) << (seconds > 0.0 ? results.size() / seconds : 0.0) << " runs/sec)\n";
+    std::cout << "  victories: " << victories << " (" << 100.0 * victories / n << "%)"
+              << "  deaths: " << deaths << " (" << 100.0 * deaths / n << "%)"
+              << "  stalled: " << stalled << "\n";
+    std::cout << "  depth:     avg " << depthSum / n << ", max " << maxDepth << "\n";
+    std::cout << "  turns:     avg " << turnSum / n << "\n";
+    std::cout << "  kills:     avg " << killSum / n << "\n";
+    if (!killers.empty()) {
+        std::vector<std::pair<std::string, int>> ranked(killers.begin(), killers.end());
+        std::sort(ranked.begin(), ranked.end(),
+                  [](const auto& a, const auto& b) { return a.second > b.second; });
+        std::cout << "  killers:  ";
+        for (size_t i = 0; i < ranked.size() && i < 5; ++i) {
+            std::cout << " " << ranked[i].first << " (" << ranked[i].second << ")";
+        }
+        std::cout << "\n";
+    }
+    std::cout.flush();
+    return 0;
+}
+
+} // namespace headless
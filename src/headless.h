@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "types.h"
+
+// Headless batch simulation: plays full seeded runs with a bot instead of a
+// terminal, for balance testing. Rendering is switched off via ui::set_headless.
+// Every run owns its GameSession, so runs can play on several threads at once.
+namespace headless {
+    // Batch configuration (filled from the command line)
+    struct Options {
+        uint32_t firstSeed = 1;          // Seeds firstSeed .. firstSeed + runs - 1
+        int runs = 100;
+        int maxTurns = 5000;             // Per run; a run that hits this is "stalled"
+        PlayerClass playerClass = PlayerClass::Warrior;
+        Difficulty difficulty = Difficulty::Adventurer;
+        unsigned threads = 1;            // Worker threads; 0 = one per hardware thread
+    };
+
+    // How a single run ended
+    enum class Outcome {
+        Victory,   // Took the stairs down on the final floor
+        Death,
+        Stalled    // Turn limit reached or no route to the stairs
+    };
+
+    // Result of a single run
+    struct RunResult {
+        uint32_t seed = 0;
+        Outcome outcome = Outcome::Stalled;
+        int depth = 1;                   // Deepest floor reached
+        int turns = 0;
+        int kills = 0;
+        std::string killer;              // Enemy name when outcome == Death
+    };
+
+    // Play one complete run with the bot
+    RunResult run_one(uint32_t seed, const Options& options);
+
+    // Play every seed in the range (on a work-stealing pool when threads != 1)
+    // Returns: results ordered by seed
+    std::vector<RunResult> run_seeds(const Options& options);
+
+    // Play options.runs runs and print runs/sec plus outcome statistics to stdout
+    // Returns: process exit code
+    int run_batch(const Options& options);
+}
@@ -1,5 +1,8 @@
 #include "input.h"
 #include "logger.h"
+#include "profiler.h"
+#include "replay.h"
+#include "ui.h"
 
 #include <iostream>
 #include <algorithm>
@@ -71,7 +74,7 @@ static int parse_escape_sequence() {
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
         if (elapsed.count() > timeoutMs) {
             // Timeout - incomplete escape sequence
-            Logger::instance().log(LogLevel::WARN, "Escape sequence timeout after " + std::to_string(elapsed.count()) + "ms");
+            LOG_WARN("Escape sequence timeout after " + std::to_string(elapsed.count()) + "ms");
             return '\033';
         }
         
@@ -81,7 +84,7 @@ static int parse_escape_sequence() {
     
     // Safety check: if we hit iteration limit, return escape
     if (iterations >= maxIterations) {
-        Logger::instance().log(LogLevel::WARN, "Escape sequence hit iteration limit - possible terminal issue");
+        LOG_WARN("Escape sequence hit iteration limit - possible terminal issue");
         return '\033';
     }
     
@@ -96,18 +99,17 @@ static int parse_escape_sequence() {
     return '\033'; // Unknown escape sequence
 }
 
-int input::read_key_nonblocking() {
+static int terminal_read_key_nonblocking() {
     char c;
     ssize_t n = read(STDIN_FILENO, &c, 1);
     if (n == 1) {
         // Check for escape sequence (arrow keys)
         if (c == '\033') {
-            LOG_OP_START("parse_escape_sequence");
+            PROF_ZONE("parse_escape_sequence");
             auto parseStart = std::chrono::steady_clock::now();
             int result = parse_escape_sequence();
             auto parseEnd = std::chrono::steady_clock::now();
             auto parseDuration = std::chrono::duration_cast<std::chrono::milliseconds>(parseEnd - parseStart);
-            LOG_OP_END("parse_escape_sequence");
             
             // Warn if escape sequence parsing takes too long
             if (parseDuration.count() > 100) {
@@ -120,10 +122,13 @@ int input::read_key_nonblocking() {
     return -1;
 }
 
-int input::read_key_blocking() {
-    LOG_OP_START("read_key_blocking");
+static int terminal_read_key_blocking() {
+    PROF_ZONE("read_key_blocking");
     auto startTime = std::chrono::steady_clock::now();
     
+    // Present anything drawn since the last flush before waiting on the player
+    std::cout.flush();
+    
     char c;
     int attempts = 0;
     constexpr int MAX_ATTEMPTS = 100000;  // Safety limit
@@ -147,10 +152,8 @@ int input::read_key_blocking() {
         if (n == 1) {
             // Check for escape sequence (arrow keys)
             if (c == '\033') {
-                LOG_OP_END("read_key_blocking");
                 return parse_escape_sequence();
             }
-            LOG_OP_END("read_key_blocking");
             return static_cast<unsigned char>(c);
         }
         
@@ -159,11 +162,10 @@ int input::read_key_blocking() {
     }
     
     LOG_WARN("read_key_blocking: hit attempt limit, returning -1");
-    LOG_OP_END("read_key_blocking");
     return -1;
 }
 
-input::TerminalSize input::get_terminal_size() {
+static input::TerminalSize terminal_size() {
     struct winsize ws;
     if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0) {
         // Fallback to default
@@ -202,16 +204,16 @@ bool input::enable_raw_mode() {
 void input::disable_raw_mode() {
 }
 
-int input::read_key_nonblocking() {
+static int terminal_read_key_nonblocking() {
     return -1;
 }
 
-int input::read_key_blocking() {
+static int terminal_read_key_blocking() {
     int c = std::cin.get();
     return c;
 }
 
-input::TerminalSize input::get_terminal_size() {
+static input::TerminalSize terminal_size() {
     CONSOLE_SCREEN_BUFFER_INFO csbi;
     HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
     if (hOut != INVALID_HANDLE_VALUE && GetConsoleScreenBufferInfo(hOut, &csbi)) {
@@ -235,4 +237,71 @@ input::ViewportSize input::calculate_viewport(int term_width, int term_height) {
 }
 #endif
 
+// IMPROVED: All key reads go through replay, so a run can be recorded and
+// fed back exactly (see replay.h). Playback falls back to the terminal once
+// the recording runs out, with animation delays restored.
+// Key taken from the terminal by key_available() and not read yet
+static int g_pendingKey = -1;
+
+static int take_pending_key() {
+    int key = g_pendingKey;
+    g_pendingKey = -1;
+    return key;
+}
+
+static bool replay_key(int& key) {
+    if (!replay::playing()) {
+        return false;
+    }
+    if (replay::next_key(key)) {
+        return true;
+    }
+    ui::set_skip_delays(false);
+    return false;
+}
 
+int input::read_key_nonblocking() {
+    PROF_ZONE("read_key_nonblocking");
+    int key;
+    if (replay_key(key)) {
+        return key;
+    }
+    key = (g_pendingKey != -1) ? take_pending_key() : terminal_read_key_nonblocking();
+    replay::record_key(key);
+    return key;
+}
+
+int input::read_key_blocking() {
+    int key;
+    if (replay_key(key)) {
+        std::cout.flush();
+        return key;
+    }
+    if (g_pendingKey != -1) {
+        std::cout.flush();
+        key = take_pending_key();
+    } else {
+        key = terminal_read_key_blocking();
+    }
+    replay::record_key(key);
+    return key;
+}
+
+bool input::key_available() {
+    // A replay's keys belong to its recorded reads, not to animation skipping
+    if (replay::playing()) {
+        return false;
+    }
+    if (g_pendingKey == -1) {
+        g_pendingKey = terminal_read_key_nonblocking();
+    }
+    return g_pendingKey != -1;
+}
+
+input::TerminalSize input::get_terminal_size() {
+    // Layout during playback follows the recorded terminal, not the current one
+    if (replay::playing()) {
+        return {replay::header().termWidth, replay::header().termHeight};
+    }
+    return terminal_size();
+}
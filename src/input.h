@@ -10,6 +10,10 @@ namespace input {
     // Blocks until a key is read
     int read_key_blocking();
 
+    // True if a key is waiting; the key is kept for the next read_key_* call
+    // (used to skip animations without swallowing the key)
+    bool key_available();
+
     // Special key codes for arrow keys (returned by read_key_*)
     constexpr int KEY_UP    = 1000;
     constexpr int KEY_DOWN  = 1001;
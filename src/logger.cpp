@@ -1,5 +1,7 @@
 #include "logger.h"
 #include <iostream>
+#include <csignal>
+#include <cstdio>
 
 Logger& Logger::instance() {
     static Logger logger;
@@ -20,6 +22,27 @@ void Logger::init(const std::string& filePath) {
     file_.open(filePath, std::ios::out | std::ios::trunc);
     
     if (file_.is_open()) {
+        if (!records_) {
+            records_.reset(new Record[QUEUE_CAPACITY]);
+            for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+                records_[i].message.reserve(RECORD_RESERVE);
+            }
+            batch_.reserve(QUEUE_CAPACITY * RECORD_RESERVE / 4);
+        }
+        for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+            records_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos_.store(0);
+        dequeuePos_ = 0;
+        written_.store(0);
+        
+        running_ = true;
+        writer_ = std::thread(&Logger::writer_loop, this);
+        std::signal(SIGSEGV, &Logger::on_fatal_signal);
+        std::signal(SIGABRT, &Logger::on_fatal_signal);
+        std::signal(SIGFPE, &Logger::on_fatal_signal);
+        std::signal(SIGILL, &Logger::on_fatal_signal);
+        
         enabled_ = true;
         info("=== Rogue Depths Log Started ===");
         info("Log file: " + filePath);
@@ -32,11 +55,26 @@ void Logger::init(const std::string& filePath) {
 void Logger::shutdown() {
     if (enabled_ && file_.is_open()) {
         info("=== Rogue Depths Log Ended ===");
+        enabled_ = false;
+        running_ = false;
+        wake_.notify_one();
+        if (writer_.joinable()) {
+            writer_.join();   // The writer drains the queue before it exits
+        }
         file_.close();
     }
     enabled_ = false;
 }
 
+void Logger::flush() {
+    if (!enabled_) return;
+    size_t target = enqueuePos_.load(std::memory_order_acquire);
+    wake_.notify_one();
+    while (written_.load(std::memory_order_acquire) < target && running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
 std::string Logger::timestamp() const {
     auto now = std::chrono::system_clock::now();
     auto time = std::chrono::system_clock::to_time_t(now);
@@ -63,20 +101,126 @@ const char* Logger::level_str(LogLevel level) const {
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
-    if (!enabled_ || !file_.is_open()) return;
+    if (!should_log(level)) return;
     
-    file_ << "[" << timestamp() << "] [" << level_str(level) << "] " << message << "\n";
-    file_.flush();  // Ensure immediate write for debugging
+    // Claim a ticket; when the queue is full, wait for the writer to free a slot
+    // rather than drop the line
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Record* record = nullptr;
+    while (true) {
+        record = &records_[pos & (QUEUE_CAPACITY - 1)];
+        size_t seq = record->seq.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            wake_.notify_one();
+            std::this_thread::yield();
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
     
-    // stderr output disabled - all logs still written to file for debugging
-    // if (level == LogLevel::ERROR || level == LogLevel::WARN || level == LogLevel::DEBUG) {
-    //     std::cerr << "[" << timestamp() << "] [" << level_str(level) << "] " << message << "\n";
-    //     std::cerr.flush();
-    // }
-    // if (level == LogLevel::INFO) {
-    //     std::cerr << "[" << timestamp() << "] [" << level_str(level) << "] " << message << "\n";
-    //     std::cerr.flush();
-    // }
+    record->level = level;
+    record->time = std::chrono::system_clock::now();
+    record->message.assign(message);   // Fits the reserved buffer for typical lines
+    record->seq.store(pos + 1, std::memory_order_release);
+    
+    if (level == LogLevel::WARN || level == LogLevel::ERROR) {
+        wake_.notify_one();
+    }
+}
+
+void Logger::writer_loop() {
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+        }
+        drain();
+    }
+    // Lines logged up to shutdown
+    drain();
+}
+
+size_t Logger::drain() {
+    std::lock_guard<std::mutex> lock(consumerMutex_);
+    return drain_locked();
+}
+
+size_t Logger::drain_locked() {
+    size_t count = 0;
+    batch_.clear();
+    while (true) {
+        Record& record = records_[dequeuePos_ & (QUEUE_CAPACITY - 1)];
+        if (record.seq.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+            break;
+        }
+        format_record(record.level, record.time, record.message);
+        record.seq.store(dequeuePos_ + QUEUE_CAPACITY, std::memory_order_release);
+        ++dequeuePos_;
+        ++count;
+    }
+    if (count > 0 && file_.is_open()) {
+        // One write for the whole batch
+        file_.write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+        file_.flush();
+        written_.fetch_add(count, std::memory_order_release);
+    }
+    return count;
+}
+
+void Logger::format_record(LogLevel level, std::chrono::system_clock::time_point time, const std::string& message) {
+    auto sinceEpoch = time.time_since_epoch();
+    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count();
+    long long us = std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count() % 1000;
+    
+    // Calendar formatting only when the second changes; the milliseconds only
+    // when the millisecond does
+    if (ms != cachedMs_) {
+        std::time_t second = static_cast<std::time_t>(ms / 1000);
+        if (second != cachedSecond_) {
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &second);
+#else
+            localtime_r(&second, &local);
+#endif
+            cachedStampLen_ = std::strftime(cachedStamp_, sizeof(cachedStamp_), "%Y-%m-%d %H:%M:%S", &local);
+            cachedSecond_ = second;
+        }
+        std::snprintf(cachedStamp_ + cachedStampLen_, sizeof(cachedStamp_) - cachedStampLen_,
+                      ".%03d", static_cast<int>(ms % 1000));
+        cachedMs_ = ms;
+    }
+    
+    char micros[8];
+    std::snprintf(micros, sizeof(micros), ".%03d", static_cast<int>(us));
+    batch_ += '[';
+    batch_.append(cachedStamp_, cachedStampLen_ + 4);
+    batch_.append(micros, 4);
+    batch_ += "] [";
+    batch_ += level_str(level);
+    batch_ += "] ";
+    batch_ += message;
+    batch_ += '\n';
+}
+
+void Logger::on_fatal_signal(int sig) {
+    // Best effort: nothing here is async-signal-safe, but the process is going
+    // down anyway and the last lines before a crash are the ones that matter.
+    // Skipped if the writer is mid-batch, in which case at most that batch and
+    // FLUSH_INTERVAL_MS of lines are lost.
+    Logger& logger = instance();
+    if (logger.enabled_ && logger.consumerMutex_.try_lock()) {
+        logger.drain_locked();
+        logger.consumerMutex_.unlock();
+    }
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
 }
 
 void Logger::log_timing(const std::string& operation, long long milliseconds) {
@@ -100,74 +244,3 @@ void Logger::log_timing(const std::string& operation, long long milliseconds) {
     // std::cerr << msg << std::endl;
     // std::cerr.flush();
 }
-
-void Logger::log_operation_start(const std::string& operation) {
-    auto startTime = std::chrono::steady_clock::now();
-    operation_starts_[operation] = startTime;
-    // IMPROVED: Optimize string building with timestamp
-    std::string msg;
-    msg.reserve(operation.size() + 50);
-    msg = "[";
-    msg += timestamp();
-    msg += "] >>> START: ";
-    msg += operation;
-    debug(msg);
-    // stderr output disabled - logs still written to file for debugging
-    // std::cerr << msg << std::endl;
-    // std::cerr.flush();
-}
-
-void Logger::log_operation_end(const std::string& operation) {
-    auto it = operation_starts_.find(operation);
-    if (it != operation_starts_.end()) {
-        auto end = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - it->second);
-        long long ms = duration.count();
-        
-        // IMPROVED: Optimize string building - use reserve and append with timestamp
-        std::string msg;
-        msg.reserve(operation.size() + 50);
-        msg = "[";
-        msg += timestamp();
-        msg += "] <<< END: ";
-        msg += operation;
-        msg += " (took ";
-        msg += std::to_string(ms);
-        msg += "ms)";
-        debug(msg);
-        // stderr output disabled - logs still written to file for debugging
-        // std::cerr << msg << std::endl;
-        // std::cerr.flush();
-        
-        if (ms > 500) {
-            // IMPROVED: Optimize string building for freeze detection
-            std::string freezeMsg;
-            freezeMsg.reserve(operation.size() + 70);
-            freezeMsg = "[";
-            freezeMsg += timestamp();
-            freezeMsg += "] FREEZE DETECTED: ";
-            freezeMsg += operation;
-            freezeMsg += " took ";
-            freezeMsg += std::to_string(ms);
-            freezeMsg += "ms (>500ms threshold)";
-            warn(freezeMsg);
-        }
-        
-        operation_starts_.erase(it);
-    } else {
-        // IMPROVED: Optimize string building with timestamp
-        std::string msg;
-        msg.reserve(operation.size() + 55);
-        msg = "[";
-        msg += timestamp();
-        msg += "] <<< END: ";
-        msg += operation;
-        msg += " (no start time recorded)";
-        debug(msg);
-        // stderr output disabled - logs still written to file for debugging
-        // std::cerr << msg << std::endl;
-        // std::cerr.flush();
-    }
-}
-
-
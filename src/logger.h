@@ -6,6 +6,12 @@
 #include <chrono>
 #include <iomanip>
 #include <map>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <thread>
+#include <memory>
 
 enum class LogLevel {
     DEBUG,
@@ -14,6 +20,13 @@ enum class LogLevel {
     ERROR
 };
 
+// Lowest level compiled in (0 = DEBUG .. 3 = ERROR). LOG_* calls below it are
+// removed entirely, message expression included; build with
+// -DROGUE_MIN_LOG_LEVEL=1 (make MIN_LOG_LEVEL=1) to strip DEBUG from release builds.
+#ifndef ROGUE_MIN_LOG_LEVEL
+#define ROGUE_MIN_LOG_LEVEL 0
+#endif
+
 class Logger {
 public:
     // Singleton access
@@ -22,13 +35,28 @@ public:
     // Initialize logger with file path (empty = disabled)
     void init(const std::string& filePath);
     
-    // Shutdown and close file
+    // Shutdown and close file (writes out everything still queued)
     void shutdown();
     
+    // Block until every line logged so far is in the file
+    void flush();
+    
     // Check if logging is enabled
-    bool is_enabled() const { return enabled_; }
+    bool is_enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    
+    // Lowest level written at runtime (--log-level); default DEBUG
+    void set_level(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    LogLevel level() const { return level_.load(std::memory_order_relaxed); }
+    
+    // Whether a message at this level would be written. The LOG_* macros
+    // check this before evaluating their message.
+    bool should_log(LogLevel level) const {
+        return is_enabled() && level >= level_.load(std::memory_order_relaxed);
+    }
     
-    // Log a message at the specified level
+    // Log a message at the specified level. Lines are queued and written by a
+    // background thread; they reach the file within FLUSH_INTERVAL_MS, and at
+    // once for WARN and ERROR.
     void log(LogLevel level, const std::string& message);
     
     // Convenience methods
@@ -37,30 +65,28 @@ public:
     void warn(const std::string& message) { log(LogLevel::WARN, message); }
     void error(const std::string& message) { log(LogLevel::ERROR, message); }
     
-    // Performance timing helpers
+    // Performance timing helper (zone timing lives in profiler.h)
     void log_timing(const std::string& operation, long long milliseconds);
-    void log_operation_start(const std::string& operation);
-    void log_operation_end(const std::string& operation);
     
     // Format helpers for logging with context
     template<typename... Args>
     void debug_fmt(const char* fmt, Args... args) {
-        if (enabled_) debug(format(fmt, args...));
+        if (should_log(LogLevel::DEBUG)) debug(format(fmt, args...));
     }
     
     template<typename... Args>
     void info_fmt(const char* fmt, Args... args) {
-        if (enabled_) info(format(fmt, args...));
+        if (should_log(LogLevel::INFO)) info(format(fmt, args...));
     }
     
     template<typename... Args>
     void warn_fmt(const char* fmt, Args... args) {
-        if (enabled_) warn(format(fmt, args...));
+        if (should_log(LogLevel::WARN)) warn(format(fmt, args...));
     }
     
     template<typename... Args>
     void error_fmt(const char* fmt, Args... args) {
-        if (enabled_) error(format(fmt, args...));
+        if (should_log(LogLevel::ERROR)) error(format(fmt, args...));
     }
 
 private:
@@ -74,6 +100,21 @@ private:
     // Get timestamp string
     std::string timestamp() const;
     
+    // Writer thread: drains the queue into the file in batches
+    void writer_loop();
+    
+    // Move every ready record into batch_ and write it out; returns records written.
+    // Only one thread may drain at a time: drain() takes consumerMutex_,
+    // drain_locked() expects the caller to hold it.
+    size_t drain();
+    size_t drain_locked();
+    
+    // Append "[timestamp] [LEVEL] message\n" for one record to batch_
+    void format_record(LogLevel level, std::chrono::system_clock::time_point time, const std::string& message);
+    
+    // Fatal signal handler: writes out what is queued, then re-raises
+    static void on_fatal_signal(int sig);
+    
     // Get level string
     const char* level_str(LogLevel level) const;
     
@@ -112,23 +153,60 @@ private:
         return std::string(fmt);
     }
     
-    bool enabled_ = false;
+    // Queue slots (power of two) and the bytes reserved in each slot's
+    // message, so steady-state logging copies into existing buffers
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr size_t RECORD_RESERVE = 128;
+    static constexpr int FLUSH_INTERVAL_MS = 10;
+    
+    // One queued line. seq implements the bounded MPSC queue (Vyukov): a slot
+    // is free for ticket t when seq == t and ready for the writer when seq == t + 1.
+    struct Record {
+        std::atomic<size_t> seq{0};
+        LogLevel level = LogLevel::INFO;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+    };
+    
+    std::atomic<bool> enabled_{false};
+    std::atomic<LogLevel> level_{LogLevel::DEBUG};
     std::ofstream file_;
     std::string filePath_;
     
-    // Timing tracking for freeze detection
-    std::map<std::string, std::chrono::steady_clock::time_point> operation_starts_;
+    std::unique_ptr<Record[]> records_;
+    std::atomic<size_t> enqueuePos_{0};    // Next ticket handed to a producer
+    size_t dequeuePos_ = 0;                // Next ticket the writer reads (consumerMutex_)
+    std::atomic<size_t> written_{0};       // Records written to the file so far
+    std::mutex consumerMutex_;
+    std::string batch_;                    // Formatted lines of the batch being written
+    
+    // Timestamp cache, per millisecond (consumerMutex_)
+    long long cachedMs_ = -1;
+    std::time_t cachedSecond_ = -1;
+    char cachedStamp_[32] = {};            // "YYYY-mm-dd HH:MM:SS.mmm"
+    size_t cachedStampLen_ = 0;
+    
+    std::thread writer_;
+    std::atomic<bool> running_{false};
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
 };
 
-// Convenience macro for logging with file/line info in debug builds
-#define LOG_DEBUG(msg) Logger::instance().debug(msg)
-#define LOG_INFO(msg) Logger::instance().info(msg)
-#define LOG_WARN(msg) Logger::instance().warn(msg)
-#define LOG_ERROR(msg) Logger::instance().error(msg)
+// Logging macros. The message argument is only evaluated when the line will
+// actually be written, so string building costs nothing with logging off, and
+// levels below ROGUE_MIN_LOG_LEVEL compile to nothing.
+#define ROGUE_LOG_AT(level, msg) \
+    do { \
+        if (static_cast<int>(level) >= ROGUE_MIN_LOG_LEVEL && Logger::instance().should_log(level)) \
+            Logger::instance().log(level, msg); \
+    } while (0)
 
-// Performance and timing macros
-#define LOG_TIMING(op, ms) Logger::instance().log_timing(op, ms)
-#define LOG_OP_START(op) Logger::instance().log_operation_start(op)
-#define LOG_OP_END(op) Logger::instance().log_operation_end(op)
+#define LOG_DEBUG(msg) ROGUE_LOG_AT(LogLevel::DEBUG, msg)
+#define LOG_INFO(msg) ROGUE_LOG_AT(LogLevel::INFO, msg)
+#define LOG_WARN(msg) ROGUE_LOG_AT(LogLevel::WARN, msg)
+#define LOG_ERROR(msg) ROGUE_LOG_AT(LogLevel::ERROR, msg)
 
+// Performance timing macro (skipped, arguments included, with logging off)
+#define LOG_TIMING(op, ms) \
+    do { if (Logger::instance().is_enabled()) Logger::instance().log_timing(op, ms); } while (0)
 
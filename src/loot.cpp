@@ -49,7 +49,7 @@ namespace loot {
     };
     
     // Roll rarity based on depth
-    Rarity roll_rarity(int depth, std::mt19937& rng) {
+    Rarity roll_rarity(int depth, Rng& rng) {
         std::uniform_int_distribution<int> roll(0, 100);
         int r = roll(rng);
         
@@ -67,7 +67,7 @@ namespace loot {
     }
     
     // Roll affix based on rarity and item type
-    ItemAffix roll_affix(Rarity rarity, ItemType type, std::mt19937& rng) {
+    ItemAffix roll_affix(Rarity rarity, ItemType type, Rng& rng) {
         std::uniform_int_distribution<int> roll(0, 100);
         int r = roll(rng);
         
@@ -125,7 +125,7 @@ namespace loot {
     }
     
     // Get affix strength based on rarity
-    float get_affix_strength(Rarity rarity, std::mt19937& rng) {
+    float get_affix_strength(Rarity rarity, Rng& rng) {
         std::uniform_real_distribution<float> roll(0.0f, 1.0f);
         float base = roll(rng);
         
@@ -149,8 +149,7 @@ namespace loot {
         }
         
         // Add base name
-        std::random_device rd;
-        std::mt19937 rng(rd());
+        Rng& rng = rngs::stream(rngs::Stream::Loot);
         std::uniform_int_distribution<int> roll(0, 3);
         
         switch (rarity) {
@@ -174,8 +173,7 @@ namespace loot {
         }
         
         // Add base name
-        std::random_device rd;
-        std::mt19937 rng(rd());
+        Rng& rng = rngs::stream(rngs::Stream::Loot);
         std::uniform_int_distribution<int> roll(0, 2);
         
         switch (rarity) {
@@ -193,7 +191,7 @@ namespace loot {
     }
     
     // Generate a weapon
-    Item generate_weapon(int depth, std::mt19937& rng) {
+    Item generate_weapon(int depth, Rng& rng) {
         Item weapon;
         weapon.type = ItemType::Weapon;
         weapon.isEquippable = true;
@@ -224,7 +222,7 @@ namespace loot {
     }
     
     // Generate armor
-    Item generate_armor(int depth, std::mt19937& rng) {
+    Item generate_armor(int depth, Rng& rng) {
         Item armor;
         armor.type = ItemType::Armor;
         armor.isEquippable = true;
@@ -262,7 +260,7 @@ namespace loot {
     }
     
     // Generate consumable
-    Item generate_consumable(int depth, std::mt19937& rng) {
+    Item generate_consumable(int depth, Rng& rng) {
         Item consumable;
         consumable.type = ItemType::Consumable;
         consumable.isConsumable = true;
@@ -301,7 +299,7 @@ namespace loot {
     }
     
     // Generate a random item
-    Item generate_item(int depth, std::mt19937& rng) {
+    Item generate_item(int depth, Rng& rng) {
         std::uniform_int_distribution<int> typeRoll(0, 100);
         int r = typeRoll(rng);
         
@@ -315,7 +313,7 @@ namespace loot {
     }
     
     // Generate enemy drops
-    std::vector<Item> generate_enemy_drops(EnemyType enemy, int depth, std::mt19937& rng) {
+    std::vector<Item> generate_enemy_drops(EnemyType enemy, int depth, Rng& rng) {
         std::vector<Item> drops;
         std::uniform_int_distribution<int> dropRoll(0, 100);
         
@@ -346,7 +344,7 @@ namespace loot {
     }
     
     // Generate treasure room loot
-    std::vector<Item> generate_treasure_room_loot(int depth, std::mt19937& rng) {
+    std::vector<Item> generate_treasure_room_loot(int depth, Rng& rng) {
         std::vector<Item> loot;
         
         // Treasure rooms have 3x items with better rarity
@@ -358,7 +356,7 @@ namespace loot {
     }
     
     // Generate boss loot
-    std::vector<Item> generate_boss_loot(EnemyType boss, int depth, std::mt19937& rng) {
+    std::vector<Item> generate_boss_loot(EnemyType boss, int depth, Rng& rng) {
         std::vector<Item> loot;
         
         // Bosses drop guaranteed legendary
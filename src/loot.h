@@ -1,40 +1,40 @@
 #pragma once
 
 #include <vector>
-#include <random>
+#include "rng.h"
 #include "entity.h"
 #include "types.h"
 
 namespace loot {
     // Generate a random item based on floor depth
-    Item generate_item(int depth, std::mt19937& rng);
+    Item generate_item(int depth, Rng& rng);
     
     // Generate a weapon with potential affixes
-    Item generate_weapon(int depth, std::mt19937& rng);
+    Item generate_weapon(int depth, Rng& rng);
     
     // Generate armor with potential affixes
-    Item generate_armor(int depth, std::mt19937& rng);
+    Item generate_armor(int depth, Rng& rng);
     
     // Generate a consumable
-    Item generate_consumable(int depth, std::mt19937& rng);
+    Item generate_consumable(int depth, Rng& rng);
     
     // Determine rarity based on depth
-    Rarity roll_rarity(int depth, std::mt19937& rng);
+    Rarity roll_rarity(int depth, Rng& rng);
     
     // Roll for an affix based on rarity
-    ItemAffix roll_affix(Rarity rarity, ItemType type, std::mt19937& rng);
+    ItemAffix roll_affix(Rarity rarity, ItemType type, Rng& rng);
     
     // Get affix strength multiplier based on rarity
-    float get_affix_strength(Rarity rarity, std::mt19937& rng);
+    float get_affix_strength(Rarity rarity, Rng& rng);
     
     // Generate loot drop from enemy death
-    std::vector<Item> generate_enemy_drops(EnemyType enemy, int depth, std::mt19937& rng);
+    std::vector<Item> generate_enemy_drops(EnemyType enemy, int depth, Rng& rng);
     
     // Generate treasure room loot
-    std::vector<Item> generate_treasure_room_loot(int depth, std::mt19937& rng);
+    std::vector<Item> generate_treasure_room_loot(int depth, Rng& rng);
     
     // Generate boss loot (guaranteed legendary)
-    std::vector<Item> generate_boss_loot(EnemyType boss, int depth, std::mt19937& rng);
+    std::vector<Item> generate_boss_loot(EnemyType boss, int depth, Rng& rng);
     
     // Item name generation
     std::string generate_weapon_name(Rarity rarity, ItemAffix affix);
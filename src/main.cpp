@@ -1,10 +1,10 @@
 #include <iostream>
 #include <chrono>
-#include <thread>
 #include <random>
 #include <vector>
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <filesystem>
 #include <cmath>
 
@@ -29,6 +29,14 @@
 #include "leaderboard.h"
 #include "tutorial.h"
 #include "viewport.h"
+#include "floor_manager.h"
+#include "headless.h"
+#include "game_session.h"
+#include "replay.h"
+#include "animation.h"
+#include "assets.h"
+#include "profiler.h"
+#include "autosave.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -54,6 +62,10 @@ static bool delete_all_saves() {
             deleted = true;
         }
     }
+    // Floors saved with the slots (WAL mode keeps two side files)
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::filesystem::remove(std::string(game_constants::FLOOR_DATABASE_PATH) + suffix);
+    }
     return deleted;
 }
 
@@ -122,7 +134,7 @@ static void save_corpse_state(const Player& player, Difficulty difficulty, int d
 }
 
 // Get a random enemy type appropriate for the given depth
-static EnemyType get_enemy_type_for_depth(int depth, std::mt19937& rng) {
+static EnemyType get_enemy_type_for_depth(int depth, Rng& rng) {
     std::uniform_int_distribution<int> roll(0, 100);
     int r = roll(rng);
     
@@ -162,7 +174,7 @@ static EnemyType get_enemy_type_for_depth(int depth, std::mt19937& rng) {
 
 // Spawn a boss enemy for the current floor
 static void spawn_boss(std::vector<Enemy>& enemies, const Dungeon& dungeon, MessageLog& log, 
-                       int depth, std::mt19937& /* rng */, const DifficultyParams& params) {
+                       int depth, Rng& /* rng */, const DifficultyParams& params) {
     EnemyType bossType = get_boss_for_depth(depth);
     Enemy boss(bossType);
     
@@ -206,7 +218,7 @@ static void spawn_boss(std::vector<Enemy>& enemies, const Dungeon& dungeon, Mess
 }
 
 // Spawn a new enemy near the player with difficulty scaling
-static void spawn_enemy_near_player(std::vector<Enemy>& enemies, const Player& player, const Dungeon& dungeon, MessageLog& log, int depth, std::mt19937& rng, const DifficultyParams& params) {
+static void spawn_enemy_near_player(std::vector<Enemy>& enemies, const Player& player, const Dungeon& dungeon, MessageLog& log, int depth, Rng& rng, const DifficultyParams& params) {
     Position pp = player.get_position();
     // IMPROVED: Use named constant for spawn search radius
     // Try to find a walkable spot within search radius
@@ -238,72 +250,33 @@ static void spawn_enemy_near_player(std::vector<Enemy>& enemies, const Player& p
 // in_simple_fov moved to viewport.cpp
 
 // Find enemy at position, returns nullptr if none
-static Enemy* find_enemy_at(std::vector<Enemy>& enemies, int x, int y) {
-    for (auto& e : enemies) {
-        if (e.get_position().x == x && e.get_position().y == y) {
-            return &e;
-        }
-    }
-    return nullptr;
-}
-
-// Global trap tracking for the current floor
-static std::vector<traps::Trap> floorTraps;
-
-// Initialize traps for a floor based on dungeon tiles
-static void initialize_floor_traps(const Dungeon& dungeon, std::mt19937& rng) {
-    floorTraps.clear();
-    for (int y = 0; y < dungeon.height(); ++y) {
-        for (int x = 0; x < dungeon.width(); ++x) {
-            if (dungeon.get_tile(x, y) == TileType::Trap) {
-                TrapType type = traps::get_random_trap_type(rng);
-                floorTraps.push_back(traps::create_trap(x, y, type));
-            }
-        }
-    }
-    LOG_DEBUG("Initialized " + std::to_string(floorTraps.size()) + " traps on floor");
-}
-
-// Check if player steps on a trap and trigger it
-static void check_trap_at_player(Player& player, Dungeon& dungeon, MessageLog& log, std::mt19937& rng) {
-    Position pos = player.get_position();
-    
-    for (auto& trap : floorTraps) {
-        if (trap.position.x == pos.x && trap.position.y == pos.y && !trap.triggered) {
-            // Check if player detects it first
-            if (!trap.detected && traps::player_detects_trap(player, trap, rng)) {
-                trap.detected = true;
-                log.add(MessageType::Warning, "\033[93m" + std::string(glyphs::warning()) + " You spot a " + 
-                        traps::get_trap_description(trap.type) + "!\033[0m");
-                return;  // Don't trigger if just detected
-            }
-            
-            // Trigger the trap
-            traps::trigger_trap(trap, player, dungeon, log, rng);
-            return;
-        }
+// IMPROVED: O(1) lookup through the floor's occupancy grid
+static Enemy* find_enemy_at(std::vector<Enemy>& enemies, const OccupancyGrid& occupancy, int x, int y) {
+    int32_t slot = occupancy.at(x, y);
+    if (slot == OccupancyGrid::EMPTY || static_cast<size_t>(slot) >= enemies.size()) {
+        return nullptr;
     }
+    return &enemies[static_cast<size_t>(slot)];
 }
 
 // Try to move player, or attack if enemy is in the way (bump-to-attack)
 // Returns true if the player took an action (moved or attacked)
-static bool try_move_or_attack(Player& player, std::vector<Enemy>& enemies, 
-                                Dungeon& dungeon, MessageLog& log,
-                                int dx, int dy, std::mt19937& rng) {
+static bool try_move_or_attack(GameSession& session, int dx, int dy) {
+    Player& player = session.player;
+    Dungeon& dungeon = session.floor.dungeon;
+    MessageLog& log = session.log;
     Position p = player.get_position();
     int newX = p.x + dx;
     int newY = p.y + dy;
     
     // Check for enemy at target position (bump-to-attack)
-    Enemy* target = find_enemy_at(enemies, newX, newY);
+    Enemy* target = find_enemy_at(session.floor.enemies, session.floor.occupancy, newX, newY);
     if (target) {
         LOG_DEBUG("Player bumping into enemy " + target->name() + " at (" + 
                   std::to_string(newX) + "," + std::to_string(newY) + ")");
         
         // Enter tactical combat mode with full 3D combat system
-        LOG_OP_START("enter_combat_mode");
         bool playerWon = combat::enter_combat_mode(player, *target, dungeon, log);
-        LOG_OP_END("enter_combat_mode");
         (void)playerWon;  // Result handled by main loop (death check)
         
         // If player died in combat, the main loop will handle it
@@ -316,7 +289,7 @@ static bool try_move_or_attack(Player& player, std::vector<Enemy>& enemies,
         player.move_by(dx, dy);
         
         // Check for traps at new position
-        check_trap_at_player(player, dungeon, log, rng);
+        session.check_trap_at_player();
         
         return true;
     }
@@ -324,12 +297,13 @@ static bool try_move_or_attack(Player& player, std::vector<Enemy>& enemies,
     return false;
 }
 
-static void show_ascii_screen(const std::string& path) {
-    std::ifstream in(path);
-    if (!in) {
+static void show_ascii_screen(const std::string& name) {
+    const assets::Sprite* screen = assets::find(name);
+    if (!screen) {
         return;
     }
     ui::clear();
+    std::istringstream in{std::string(screen->text)};
     std::string line;
     int row = 2;
     while (std::getline(in, line)) {
@@ -471,8 +445,9 @@ static void show_congratulations_page() {
     
     std::cout.flush();
     
-    // Wait 5 seconds
-    std::this_thread::sleep_for(std::chrono::seconds(5));
+    // Wait 5 seconds (any key skips)
+    anim::pause(5000);
+    anim::finish();
 }
 
 // Game over screen with stats (centered)
@@ -544,6 +519,7 @@ static void show_gameover_screen(int floorReached, int enemiesKilled, const std:
     ui::reset_color();
     
     std::cout.flush();
+    anim::finish();  // Let the death bells ring out (a key skips them)
     input::read_key_blocking();
 }
 
@@ -563,8 +539,8 @@ static const std::vector<std::string> title_colors = {
 static int show_animated_title(unsigned int seed = 0) {
     // Load title ASCII art
     std::vector<std::string> titleLines;
-    std::ifstream in("assets/ascii/title.txt");
-    if (in) {
+    if (const assets::Sprite* title = assets::find("title")) {
+        std::istringstream in{std::string(title->text)};
         std::string line;
         while (std::getline(in, line)) {
             titleLines.push_back(line);
@@ -692,7 +668,7 @@ static int show_animated_title(unsigned int seed = 0) {
         // Non-blocking input check for animation
         int key = input::read_key_nonblocking();
         if (key == -1) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            ui::delay(50);
             continue;
         }
         
@@ -854,7 +830,7 @@ static PlayerClass show_class_selection() {
     }
 }
 
-static Item generate_loot(std::mt19937& rng, const DifficultyParams& params) {
+static Item generate_loot(Rng& rng, const DifficultyParams& params) {
     std::uniform_int_distribution<int> rarityDist(0, 100);
     int roll = rarityDist(rng);
     float lootBias = std::clamp(params.lootMultiplier, 0.5f, 2.0f);
@@ -917,8 +893,9 @@ static std::string get_item_color(Rarity rarity) {
 // Viewport functions moved to viewport.cpp
 
 // Legacy draw_map for compatibility (not used with new viewport)
-static void draw_map(const Dungeon& dungeon, const Player& player, const std::vector<Enemy>& enemies) {
-    draw_map_viewport(dungeon, player, enemies, 1, 1, constants::viewport_width, constants::viewport_height);
+static void draw_map(const Dungeon& dungeon, const Player& player, const std::vector<Enemy>& enemies,
+                     const OccupancyGrid& occupancy) {
+    draw_map_viewport(dungeon, player, enemies, occupancy, 1, 1, constants::viewport_width, constants::viewport_height);
 }
 
 // Check terminal size and ensure it's large enough for the game
@@ -1020,14 +997,8 @@ int main(int argc, char* argv[]) {
     }
 #endif
 
-    // Initialize UI and input before checking terminal size
-    ui::init();
-    input::enable_raw_mode();
-    
-    // Check terminal size before proceeding
-    check_terminal_size();
-
-    // Parse command-line arguments
+    // Parse command-line arguments (before the terminal is touched, so help,
+    // version and headless runs work without a TTY)
     CLIConfig cliConfig = cli::parse(argc, argv);
     cli::set_config(cliConfig);
     
@@ -1046,23 +1017,91 @@ int main(int argc, char* argv[]) {
     
     // Initialize logger if log file specified
     if (!cliConfig.logFile.empty()) {
+        Logger::instance().set_level(static_cast<LogLevel>(cliConfig.logLevel));
         Logger::instance().init(cliConfig.logFile);
         LOG_INFO("Command-line arguments parsed successfully");
         if (cliConfig.debug) LOG_INFO("Debug mode enabled");
         if (cliConfig.noColor) LOG_INFO("Color output disabled");
         if (cliConfig.noUnicode) LOG_INFO("Unicode output disabled");
+        prof::watch_freezes();
+    }
+    
+    if (!cliConfig.profileFile.empty()) {
+        prof::start(cliConfig.profileFile);
+    }
+    
+    // Headless simulation: bot runs with rendering off, no terminal needed
+    if (cliConfig.headless) {
+        headless::Options options;
+        options.firstSeed = (cliConfig.seed != 0) ? cliConfig.seed : 1;
+        options.runs = cliConfig.runs;
+        options.maxTurns = cliConfig.maxTurns;
+        options.playerClass = static_cast<PlayerClass>(cliConfig.playerClass);
+        options.difficulty = static_cast<Difficulty>(cliConfig.difficulty);
+        options.threads = static_cast<unsigned>(cliConfig.threads);
+        int exitCode = headless::run_batch(options);
+        std::cout << prof::stop();
+        Logger::instance().shutdown();
+        return exitCode;
+    }
+    
+    // Seed - use CLI seed if provided, otherwise random
+    std::random_device rd;
+    unsigned int runSeed = (cliConfig.seed != 0) ? cliConfig.seed : rd();
+    
+    // Input replay: play a recording back with its seed and settings, or
+    // record this run's keys so it can be reproduced later
+    if (!cliConfig.replayFile.empty()) {
+        replay::Header header;
+        if (!replay::load(cliConfig.replayFile, header)) {
+            std::cerr << "Error: cannot play replay '" << cliConfig.replayFile << "'\n";
+            return 1;
+        }
+        runSeed = header.seed;
+        cliConfig.difficulty = header.difficulty;
+        cliConfig.noColor = header.noColor;
+        cliConfig.noUnicode = header.noUnicode;
+        cli::set_config(cliConfig);
+        ui::set_skip_delays(cliConfig.replayMaxSpeed);
+    } else if (!cliConfig.recordFile.empty()) {
+        auto termSize = input::get_terminal_size();
+        replay::Header header;
+        header.seed = runSeed;
+        header.difficulty = static_cast<uint8_t>(cliConfig.difficulty);
+        header.noColor = cliConfig.noColor;
+        header.noUnicode = cliConfig.noUnicode;
+        header.termWidth = static_cast<uint16_t>(termSize.width);
+        header.termHeight = static_cast<uint16_t>(termSize.height);
+        // Keys are held in memory until the run turns out to be a fresh one
+        replay::start_recording(cliConfig.recordFile, header);
     }
+    // Playback starts a fresh run (only fresh runs are recorded) and leaves saves,
+    // corpses and the leaderboard alone, even once live input takes over
+    const bool replaySession = replay::playing();
+    
+    // Register the built-in ASCII art (plus any --asset-dir overrides) up
+    // front; nothing reads asset files after this
+    assets::load(cliConfig.assetDir);
+    
+    // Initialize UI and input before checking terminal size
+    ui::init();
+    input::enable_raw_mode();
+    
+    // Check terminal size before proceeding
+    check_terminal_size();
     
     // Initialize glyph system based on CLI settings
     glyphs::init(!cliConfig.noUnicode, !cliConfig.noColor);
+    anim::set_enabled(!cliConfig.noAnimations);
     
     // Initialize keybindings from config file
     keybinds::init("config/controls.json");
     
-    // Seed - use CLI seed if provided, otherwise random
-    std::random_device rd;
-    unsigned int seed = (cliConfig.seed != 0) ? cliConfig.seed : rd();
-    std::mt19937 rng(seed);
+    GameSession session(runSeed, Difficulty::Adventurer);
+    unsigned int& seed = session.seed;
+    rngs::Bind bindStreams(session.streams);  // Combat and AI draw from the session's streams
+    Rng& lootRng = session.rng(rngs::Stream::Loot);
+    Rng& rng = session.rng(rngs::Stream::World);
     
     LOG_INFO("Random seed: " + std::to_string(seed));
 
@@ -1074,9 +1113,11 @@ int main(int argc, char* argv[]) {
         if (menuChoice == 5) {
             // Quit selected
             LOG_INFO("User quit from title screen");
+            std::string profile = prof::stop();
             Logger::instance().shutdown();
             input::disable_raw_mode();
             ui::shutdown();
+            std::cout << profile;
             return 0;
         }
         // Tutorial temporarily disabled: hide option by treating choice 2 as "Start Game"
@@ -1124,7 +1165,12 @@ int main(int argc, char* argv[]) {
 
     // Try to load existing game (slot 1)
     GameState loaded{};
-    bool hasSave = fileio::load_from_slot(loaded, 1);
+    bool hasSave = !replaySession && fileio::load_from_slot(loaded, 1);
+    if (hasSave) {
+        // Keep the save this run starts from in slot 3 (slot 2 reserved for corpse
+        // runs); slot 1 is rewritten by autosaves from here on
+        fileio::save_to_slot(loaded, 3);
+    }
     
     // If Load Game selected but no save exists, treat as new game
     if (menuChoice == 1 && !hasSave) {
@@ -1137,20 +1183,28 @@ int main(int argc, char* argv[]) {
     }
 
     Difficulty difficulty = hasSave ? loaded.difficulty : Difficulty::Adventurer;
-    DifficultyParams params = get_difficulty_params(difficulty);
+    session.difficulty = difficulty;
+    session.params = get_difficulty_params(difficulty);
+    const DifficultyParams& params = session.params;
 
     // Current floor depth (needed for dungeon generation)
-    int currentDepth = hasSave ? loaded.depth : 1;
+    int& currentDepth = session.depth;
+    currentDepth = hasSave ? loaded.depth : 1;
 
     // Build dungeon and player
     // Dynamic map sizing based on depth: width = 30 + depth*10, height = 15 + depth*5
     int mapWidth = 30 + currentDepth * 10;
     int mapHeight = 15 + currentDepth * 5;
-    Dungeon dungeon(mapWidth, mapHeight);
+    // The live floor: dungeon, enemies and their occupancy grid
+    FloorData& floor = session.floor;
+    floor.dungeon = Dungeon(mapWidth, mapHeight);
+    Dungeon& dungeon = floor.dungeon;
+    floor.seed = seed;  // Tags saved floors with the run they belong to
     Position start{};
     Position stairsDown{};
     if (hasSave) {
         seed = loaded.seed;
+        floor.seed = seed;
         dungeon.generate(seed, start, stairsDown, currentDepth);
         // Use saved positions
         stairsDown = loaded.stairsDown;
@@ -1161,10 +1215,10 @@ int main(int argc, char* argv[]) {
     }
     
     // Initialize traps for the floor
-    initialize_floor_traps(dungeon, rng);
+    session.initialize_traps();
 
     // Player creation: load from save or create new with class selection
-    Player player;
+    Player& player = session.player;
     std::string selectedClassName;
     if (hasSave) {
         player = loaded.player;
@@ -1172,47 +1226,25 @@ int main(int argc, char* argv[]) {
         // Show class selection for new game
         PlayerClass chosenClass = show_class_selection();
         selectedClassName = Player::class_name(chosenClass);
-        player = Player(chosenClass);
+        session.create_player(chosenClass);
         player.set_position(start.x, start.y);
-        player.get_stats().maxHp += params.playerHpBoost;
-        player.get_stats().hp = player.get_stats().maxHp;
-        player.set_depth(currentDepth);  // Set initial depth for attack bonus
         LOG_INFO("Class selected: " + selectedClassName);
-        
-        // Add starter weapon based on class
-        Item starterWeapon;
-        starterWeapon.type = ItemType::Weapon;
-        starterWeapon.isEquippable = true;
-        starterWeapon.slot = EquipmentSlot::Weapon;
-        starterWeapon.rarity = Rarity::Common;
-        starterWeapon.attackBonus = 2;  // Small starter bonus
-        
-        // All classes get a starter sword
-        starterWeapon.name = "Starter Sword";
-        player.inventory().push_back(starterWeapon);
-        LOG_INFO("Added starter weapon: " + starterWeapon.name);
-        
-        // Add 5 healing potions to starting inventory
-        for (int i = 0; i < 5; ++i) {
-            Item healingPotion;
-            healingPotion.name = "Healing Potion";
-            healingPotion.type = ItemType::Consumable;
-            healingPotion.isConsumable = true;
-            healingPotion.healAmount = 20;  // Heals 20 HP
-            healingPotion.rarity = Rarity::Common;
-            player.inventory().push_back(healingPotion);
-        }
-        LOG_INFO("Added 5 healing potions to starting inventory");
     }
 
-    MessageLog log;
+    MessageLog& log = session.log;
     if (!hasSave && !selectedClassName.empty()) {
         log.add(MessageType::Info, "You embark as the " + selectedClassName + ".");
     }
     log.add(MessageType::Info, "Welcome to Rogue Depths. Press 'q' to quit.");
+    if (hasSave && replay::recording()) {
+        // A replay carries only the seed and keys, not the save this run continues
+        replay::cancel_recording();
+        LOG_INFO("Replay: not recording a continued run");
+        log.add(MessageType::Info, "Replay recording is off for continued games.");
+    }
 
     // Spawn enemies (with difficulty scaling)
-    std::vector<Enemy> enemies;
+    std::vector<Enemy>& enemies = floor.enemies;
     if (hasSave) {
         enemies = loaded.enemies;
     } else {
@@ -1231,7 +1263,7 @@ int main(int argc, char* argv[]) {
 
         // Corpse run: if previous save exists in slot 2, spawn a tougher enemy at its former position
         GameState corpse{};
-        if (fileio::load_from_slot(corpse, 2)) {
+        if (!replaySession && fileio::load_from_slot(corpse, 2)) {
             Enemy c(EnemyType::CorpseEnemy);
             c.set_position(corpse.player.get_position().x, corpse.player.get_position().y);
             c.stats().maxHp = std::max(8, corpse.player.get_stats().maxHp / 2);
@@ -1239,15 +1271,59 @@ int main(int argc, char* argv[]) {
             c.stats().attack = std::max(4, corpse.player.get_stats().attack);
             enemies.push_back(c);
             log.add(MessageType::Warning, "You sense the presence of your past demise...");
+            if (replay::recording()) {
+                // The spirit and its loot come from slot 2, which a replay does not carry
+                replay::cancel_recording();
+                LOG_INFO("Replay: not recording a corpse run");
+                log.add(MessageType::Info, "Replay recording is off while your past self lingers.");
+            }
+        }
+    }
+    if (hasSave) {
+        // IMPROVED: Restore the live floor as last autosaved (tiles, enemies with
+        // their AI knowledge and statuses, traps) instead of a fresh generation
+        Database floorDb;
+        FloorData saved;
+        std::vector<traps::Trap> savedTraps;
+        if (floorDb.open(game_constants::FLOOR_DATABASE_PATH) &&
+            floorDb.load_floor(1, currentDepth, saved, &savedTraps) && saved.seed == seed &&
+            saved.dungeon.width() == dungeon.width() && saved.dungeon.height() == dungeon.height()) {
+            dungeon = std::move(saved.dungeon);
+            enemies = std::move(saved.enemies);
+            session.traps = std::move(savedTraps);
+            LOG_INFO("Restored floor " + std::to_string(currentDepth) + " from the autosave");
         }
     }
+    floor.occupancy.rebuild(dungeon.width(), dungeon.height(), enemies);
+    if (replay::recording()) {
+        replay::commit_recording();   // A fresh run: the seed and keys reproduce it
+    }
+
+    // IMPROVED: Saves are written by a background thread; the game thread only
+    // takes a snapshot, so autosaving every few turns costs no frame time
+    Autosaver autosaver;
+    if (!replaySession) {
+        autosaver.start(1, game_constants::FLOOR_DATABASE_PATH);
+    }
+    const int autosaveTurns = cliConfig.autosaveTurns;
+    int turnsSinceAutosave = 0;
+    auto current_state = [&]() {
+        GameState state;
+        state.difficulty = difficulty;
+        state.player = player;
+        state.enemies = enemies;
+        state.depth = currentDepth;
+        state.seed = seed;
+        state.stairsDown = stairsDown;
+        return state;
+    };
 
     // Main loop
     bool running = true;
     bool corpseSaved = false;
     bool shrinePromptActive = false;  // Track if we're waiting for Y/N at a shrine
     int shrineMessageStage = -1;      // 0 = intro, 1 = prompt, 2 = warning, 3 = done
-    auto shrineStageTime = std::chrono::steady_clock::now();
+    int shrineStageFrame = 0;         // Frame the current stage started on
     Position prevPlayerPos = player.get_position();
     
     // Dynamic viewport sizing based on terminal
@@ -1258,13 +1334,31 @@ int main(int argc, char* argv[]) {
     
     LOG_INFO("Entering main game loop");
     int frameCount = 0;
-    int totalKillCount = 0;  // Track total enemies killed for stats
-    std::string lastEnemyAttacker = "Unknown";  // Track what killed the player
+    int& totalKillCount = session.kills;  // Track total enemies killed for stats
+    std::string& lastEnemyAttacker = session.lastAttacker;  // Track what killed the player
     
     auto lastHeartbeat = std::chrono::steady_clock::now();
     
     while (running) {
-        LOG_OP_START("game_loop_iteration");
+        // IMPROVED: Animations queued by the last action (floor transition,
+        // flashes) play on the timeline between frames instead of blocking it.
+        // The map is not redrawn over them, and a key press skips to the end
+        // and is then handled as normal input.
+        if (anim::active()) {
+            int waitMs = anim::advance();
+            if (waitMs >= 0 && input::key_available()) {
+                anim::skip();
+                waitMs = -1;
+            }
+            if (waitMs >= 0) {
+                ui::delay(std::min(waitMs, 16));
+                continue;
+            }
+            ui::invalidate_screen();
+        }
+        
+        prof::frame();
+        PROF_ZONE("game_loop_iteration");
         auto frameStart = std::chrono::steady_clock::now();
         
         // IMPROVED: Use named constant for heartbeat interval
@@ -1291,20 +1385,21 @@ int main(int argc, char* argv[]) {
 
         // Timed shrine prompt messages: show them one by one so player can read
         if (shrinePromptActive) {
-            using namespace std::chrono;
+            // IMPROVED: Stages advance on frame count instead of wall-clock time,
+            // so recorded input replays to the same log at any speed
             if (shrineMessageStage == 0) {
                 // First message appears immediately when shrine prompt becomes active
                 log.add(MessageType::Info, std::string(glyphs::shrine()) + " A mystical shrine pulses with energy.");
                 shrineMessageStage = 1;
-                shrineStageTime = now;
+                shrineStageFrame = frameCount;
             } else if (shrineMessageStage == 1 &&
-                       duration_cast<milliseconds>(now - shrineStageTime).count() >= 1000) {
+                       frameCount - shrineStageFrame >= game_constants::UI_SHRINE_MESSAGE_FRAMES) {
                 // Second message (Y/N prompt) after ~1 second
                 log.add(MessageType::Info, "Pray at the shrine? (Y/N)");
                 shrineMessageStage = 2;
-                shrineStageTime = now;
+                shrineStageFrame = frameCount;
             } else if (shrineMessageStage == 2 &&
-                       duration_cast<milliseconds>(now - shrineStageTime).count() >= 1000) {
+                       frameCount - shrineStageFrame >= game_constants::UI_SHRINE_MESSAGE_FRAMES) {
                 // Third message (warning about negative results) after another ~1 second
                 log.add(MessageType::Warning,
                         "Tip: Shrines can bless or curse you. There's a chance of a negative effect.");
@@ -1326,19 +1421,20 @@ int main(int argc, char* argv[]) {
         }
         
         // Recalculate viewport on each frame (handles terminal resize)
-        LOG_OP_START("get_terminal_size");
-        termSize = input::get_terminal_size();
-        LOG_OP_END("get_terminal_size");
+        {
+            PROF_ZONE("get_terminal_size");
+            termSize = input::get_terminal_size();
+        }
         
-        LOG_OP_START("calculate_viewport");
-        vpSize = input::calculate_viewport(termSize.width, termSize.height);
-        LOG_OP_END("calculate_viewport");
+        {
+            PROF_ZONE("calculate_viewport");
+            vpSize = input::calculate_viewport(termSize.width, termSize.height);
+        }
         viewport_w = vpSize.width;
         viewport_h = vpSize.height;
         
         // IMPROVED: Use named constants for UI frame dimensions
         // Calculate centered UI layout (professional approach)
-        LOG_OP_START("ui_layout_calculation");
         int mapFrameHeight = viewport_h + game_constants::UI_BORDER_WIDTH;      // map + top/bottom borders
         int statusFrameHeight = game_constants::UI_STATUS_FRAME_HEIGHT;                 // status bar frame
         int messageFrameHeight = game_constants::UI_MESSAGE_FRAME_HEIGHT;                // message log frame
@@ -1351,7 +1447,6 @@ int main(int argc, char* argv[]) {
         
         int statusRow = mapStartRow + mapFrameHeight + 1;
         int msgRow = statusRow + statusFrameHeight + 1;
-        LOG_OP_END("ui_layout_calculation");
         
         // Tab-based UI view system (declare before rendering)
         static UIView currentView = UIView::MAP;
@@ -1361,29 +1456,35 @@ int main(int argc, char* argv[]) {
         // Legacy inventory open state (for backward compatibility)
         bool invOpen = (currentView == UIView::INVENTORY);
 
-        LOG_OP_START("ui_clear");
-        ui::clear();
-        LOG_OP_END("ui_clear");
+        // IMPROVED: Draw into the diffing screen buffer; only changed cells reach the terminal
+        ui::begin_frame();
+        {
+            PROF_ZONE("ui_clear");
+            ui::clear();
+        }
         
         // Only draw map when in MAP view (prevents flicker)
         if (currentView == UIView::MAP) {
-            LOG_OP_START("draw_map_viewport");
-            // Draw main game viewport (camera-centered, dynamic size)
-            draw_map_viewport(dungeon, player, enemies, mapStartRow, mapStartCol, viewport_w, viewport_h);
-            LOG_OP_END("draw_map_viewport");
+            {
+                PROF_ZONE("draw_map_viewport");
+                // Draw main game viewport (camera-centered, dynamic size)
+                draw_map_viewport(dungeon, player, enemies, floor.occupancy, mapStartRow, mapStartCol, viewport_w, viewport_h);
+            }
             
-            LOG_OP_START("draw_status_bar");
-            // Draw framed status bar below map
-            ui::draw_status_bar_framed(statusRow, mapStartCol, viewport_w + 2, player, currentDepth);
-            LOG_OP_END("draw_status_bar");
+            {
+                PROF_ZONE("draw_status_bar");
+                // Draw framed status bar below map
+                ui::draw_status_bar_framed(statusRow, mapStartCol, viewport_w + 2, player, currentDepth);
+            }
             
-            LOG_OP_START("draw_message_log");
-            // Draw framed message log (increased from 4 to 8 lines)
-            log.render_framed(msgRow, mapStartCol, viewport_w + 2, 8);
-            LOG_OP_END("draw_message_log");
+            {
+                PROF_ZONE("draw_message_log");
+                // Draw framed message log (increased from 4 to 8 lines)
+                log.render_framed(msgRow, mapStartCol, viewport_w + 2, 8);
+            }
             
         } else {
-            LOG_OP_START("draw_menu_view");
+            PROF_ZONE("draw_menu_view");
             // Draw menu view overlay (full screen, no map behind)
             int viewWidth = std::min(70, termSize.width - 4);
             int viewHeight = std::min(25, termSize.height - 4);
@@ -1409,7 +1510,6 @@ int main(int argc, char* argv[]) {
                 default:
                     break;
             }
-            LOG_OP_END("draw_menu_view");
         }
         
         // Draw contextual tips box (always visible, based on current view and context)
@@ -1557,25 +1657,24 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        LOG_OP_START("cout_flush");
-        // PHASE 3: Check output stream health before flush
-        if (!std::cout.good()) {
-            LOG_WARN("Main loop: std::cout is in bad state before flush - attempting to clear");
-            std::cout.clear();
+        {
+            PROF_ZONE("cout_flush");
+            // PHASE 3: Check output stream health before flush
             if (!std::cout.good()) {
-                LOG_ERROR("Main loop: Failed to recover std::cout state");
+                LOG_WARN("Main loop: std::cout is in bad state before flush - attempting to clear");
+                std::cout.clear();
+                if (!std::cout.good()) {
+                    LOG_ERROR("Main loop: Failed to recover std::cout state");
+                }
             }
+            ui::end_frame();
         }
-        std::cout.flush();
-        LOG_OP_END("cout_flush");
 
         LOG_DEBUG("Waiting for input...");
-        LOG_OP_START("read_key_nonblocking");
         auto inputStart = std::chrono::steady_clock::now();
         int key = input::read_key_nonblocking();
         auto inputEnd = std::chrono::steady_clock::now();
         auto inputDuration = std::chrono::duration_cast<std::chrono::milliseconds>(inputEnd - inputStart);
-        LOG_OP_END("read_key_nonblocking");
         
         // Warn if input reading takes suspiciously long (non-blocking should be fast)
         if (inputDuration.count() > 50) {
@@ -1583,7 +1682,7 @@ int main(int argc, char* argv[]) {
         }
         
         if (key == -1) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            ui::delay(16);
             continue;
         }
         LOG_DEBUG("Key pressed: " + std::to_string(key) + " ('" + (key >= 32 && key < 127 ? std::string(1, static_cast<char>(key)) : "ctrl") + "')");
@@ -1649,7 +1748,6 @@ int main(int argc, char* argv[]) {
                             // Activate staged shrine prompt; messages are shown over time in the main loop
                             shrinePromptActive = true;
                             shrineMessageStage = 0;
-                            shrineStageTime = std::chrono::steady_clock::now();
                         }
                     } else {
                         log.add(MessageType::Info, "Nothing to interact with here.");
@@ -1681,7 +1779,7 @@ int main(int argc, char* argv[]) {
                         if (invSel < 0) invSel = 0;
                     }
                 } else if (currentView == UIView::MAP) {
-                    try_move_or_attack(player, enemies, dungeon, log, 1, 0, rng);
+                    try_move_or_attack(session, 1, 0);
                 }
                 break;
             }
@@ -1710,7 +1808,7 @@ int main(int argc, char* argv[]) {
                     break; 
                 }
                 if (currentView != UIView::MAP) break;  // Ignore in other views
-                try_move_or_attack(player, enemies, dungeon, log, 0, -1, rng);
+                try_move_or_attack(session, 0, -1);
                 break;
             }
             case 's':
@@ -1721,14 +1819,14 @@ int main(int argc, char* argv[]) {
                     break; 
                 }
                 if (currentView != UIView::MAP) break;  // Ignore in other views
-                try_move_or_attack(player, enemies, dungeon, log, 0, 1, rng);
+                try_move_or_attack(session, 0, 1);
                 break;
             }
             case 'a':
             case 'A':
             case input::KEY_LEFT: {
                 if (currentView != UIView::MAP) break;
-                try_move_or_attack(player, enemies, dungeon, log, -1, 0, rng);
+                try_move_or_attack(session, -1, 0);
                 break;
             }
             case input::KEY_UP: {
@@ -1738,7 +1836,7 @@ int main(int argc, char* argv[]) {
                     break; 
                 }
                 if (currentView != UIView::MAP) break;
-                try_move_or_attack(player, enemies, dungeon, log, 0, -1, rng);
+                try_move_or_attack(session, 0, -1);
                 break;
             }
             case input::KEY_DOWN: {
@@ -1748,12 +1846,12 @@ int main(int argc, char* argv[]) {
                     break; 
                 }
                 if (currentView != UIView::MAP) break;
-                try_move_or_attack(player, enemies, dungeon, log, 0, 1, rng);
+                try_move_or_attack(session, 0, 1);
                 break;
             }
             case input::KEY_RIGHT: {
                 if (currentView != UIView::MAP) break;
-                try_move_or_attack(player, enemies, dungeon, log, 1, 0, rng);
+                try_move_or_attack(session, 1, 0);
                 break;
             }
             case 'r':
@@ -1806,12 +1904,16 @@ int main(int argc, char* argv[]) {
                 // Wait for confirmation input
                 int confirm = input::read_key_blocking();
                 if (confirm == 'y' || confirm == 'Y') {
-                    delete_all_saves();
+                    autosaver.stop();  // Nothing queued may bring a slot back
+                    if (!replaySession) {
+                        delete_all_saves();
+                    }
                     // Show success message
                     std::cout << "\033[" << (confirmBoxRow + 3) << ";" << (confirmBoxCol + 2) << "H";
                     std::cout << "\033[1;32m" << "  OK Saves deleted! Restart to begin." << "\033[0m";
                     std::cout.flush();
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+                    anim::pause(1500);
+                    anim::finish();
                     running = false;
                 } else {
                     log.add(MessageType::Info, "Reset cancelled.");
@@ -1845,6 +1947,7 @@ int main(int argc, char* argv[]) {
                             e.stats().hp = e.stats().maxHp;
                             e.stats().attack = static_cast<int>(baseAtk * params.enemyDamageMultiplier);
                             enemies.push_back(e);
+                            floor.occupancy.rebuild(dungeon.width(), dungeon.height(), enemies);
                             log.add(MessageType::Warning, "A " + e.name() + " appears!");
                             spawned = true;
                         }
@@ -1905,7 +2008,7 @@ int main(int argc, char* argv[]) {
                         dungeon.generate(newSeed, start, stairsDown, currentDepth);
                         
                         // Initialize traps for the new floor
-                        initialize_floor_traps(dungeon, rng);
+                        session.initialize_traps();
                         
                         // Tick shrine blessings when descending
                         shrine::tick_blessings(player, log);
@@ -1965,6 +2068,7 @@ int main(int argc, char* argv[]) {
                                 }
                             }
                         }
+                        floor.occupancy.rebuild(dungeon.width(), dungeon.height(), enemies);
                     }
                 } else {
                     log.add(MessageType::Info, "There are no stairs here.");
@@ -1983,54 +2087,7 @@ int main(int argc, char* argv[]) {
         }
         
         // Check for special tile events after movement
-        Position playerPos = player.get_position();
-        TileType currentTile = dungeon.get_tile(playerPos.x, playerPos.y);
-        if (currentTile == TileType::Trap) {
-            // Trap: deal damage and convert to floor
-            int trapDamage = 2 + currentDepth;
-            player.get_stats().hp -= trapDamage;
-            // Clamp HP to 0 minimum (player dies if HP <= 0, checked elsewhere)
-            if (player.get_stats().hp < 0) {
-                player.get_stats().hp = 0;
-            }
-            log.add(MessageType::Damage, "You triggered a trap! (-" + std::to_string(trapDamage) + " HP)");
-            dungeon.set_tile(playerPos.x, playerPos.y, TileType::Floor);
-        } else if (currentTile == TileType::Shrine) {
-            // Shrine: heal or buff
-            std::uniform_int_distribution<int> shrineRoll(0, 100);
-            int roll = shrineRoll(rng);
-            if (roll < 50) {
-                // Heal
-                int healAmt = 5 + currentDepth;
-                player.get_stats().hp = std::min(player.get_stats().hp + healAmt, player.get_stats().maxHp);
-                log.add(MessageType::Heal, "The shrine heals you! (+" + std::to_string(healAmt) + " HP)");
-            } else {
-                // Haste buff
-                player.apply_status(StatusEffect{StatusType::Haste, 10, 3});
-                log.add(MessageType::Heal, "The shrine hastens you! (+3 SPD for 10 turns)");
-            }
-            dungeon.set_tile(playerPos.x, playerPos.y, TileType::Floor);
-        } else if (currentTile == TileType::Water) {
-            // Water: slows movement (message only, actual slow would need turn system)
-            static bool waterMsgShown = false;
-            if (!waterMsgShown) {
-                log.add(MessageType::Info, "You wade through the water...");
-                waterMsgShown = true;
-            }
-        } else if (currentTile == TileType::Lava) {
-            // Lava: massive damage (shouldn't be walkable, but just in case)
-            int lavaDamage = 20 + currentDepth * 2;
-            player.get_stats().hp -= lavaDamage;
-            // Clamp HP to 0 minimum (player dies if HP <= 0, checked elsewhere)
-            if (player.get_stats().hp < 0) {
-                player.get_stats().hp = 0;
-            }
-            log.add(MessageType::Damage, "You step into LAVA! (-" + std::to_string(lavaDamage) + " HP)");
-        } else if (currentTile == TileType::Chasm) {
-            // Chasm: instant death (shouldn't be walkable)
-            player.get_stats().hp = 0;
-            log.add(MessageType::Death, "You fall into the endless chasm!");
-        }
+        session.apply_tile_effects();
         
         // Skip game logic when in menu views (only process when on MAP)
         if (currentView != UIView::MAP) {
@@ -2055,13 +2112,14 @@ int main(int argc, char* argv[]) {
         LOG_DEBUG("Processing " + std::to_string(enemies.size()) + " enemy turns");
         // IMPROVED: Use range-based for loop with index tracking where needed
         size_t enemyIndex = 0;
+        const ai::PathStats pathStatsBefore = ai::path_stats();
+        // IMPROVED: FOV is shadowcast once per player move; sight checks near the player read it
+        dungeon.compute_fov(player.get_position(), constants::fov_radius);
         for (auto& en : enemies) {
             LOG_DEBUG("Enemy " + std::to_string(enemyIndex) + " (" + en.name() + ") at (" + 
                       std::to_string(en.get_position().x) + "," + 
                       std::to_string(en.get_position().y) + ") taking turn");
-            LOG_OP_START("ai_take_turn_" + std::to_string(enemyIndex));
             ai::take_turn(en, player, dungeon, log);
-            LOG_OP_END("ai_take_turn_" + std::to_string(enemyIndex));
             
             // Check if enemy moved adjacent to player - enter tactical combat mode
             const Position ep = en.get_position(); // IMPROVED: Use const for read-only position
@@ -2071,13 +2129,15 @@ int main(int argc, char* argv[]) {
                 lastEnemyAttacker = en.name();  // Track for death message
                 
                 // Enter tactical combat mode (replaces old automatic melee system)
-                LOG_OP_START("enter_combat_mode_from_enemy_turn");
                 bool playerWon = combat::enter_combat_mode(player, en, dungeon, log);
-                LOG_OP_END("enter_combat_mode_from_enemy_turn");
                 (void)playerWon;  // Result handled by main loop (death check)
             }
             enemyIndex++; // IMPROVED: Increment index after processing each enemy
         }
+        LOG_DEBUG("Pathfinding this turn: " +
+                  std::to_string(ai::path_stats().searches - pathStatsBefore.searches) + " searches, " +
+                  std::to_string(ai::path_stats().repairs - pathStatsBefore.repairs) + " repairs, " +
+                  std::to_string(ai::path_stats().cachedSteps - pathStatsBefore.cachedSteps) + " cached steps");
 
         // Remove dead enemies
         LOG_DEBUG("Checking for dead enemies");
@@ -2089,10 +2149,8 @@ int main(int argc, char* argv[]) {
                 if (it->enemy_type() == EnemyType::CorpseEnemy) {
                     // Recover items from previous death
                     // FIXED: Add timing to detect slow file I/O
-                    LOG_OP_START("load_corpse_save");
                     GameState corpse{};
                     bool loadSuccess = fileio::load_from_slot(corpse, 2);
-                    LOG_OP_END("load_corpse_save");
                     
                     if (loadSuccess) {
                         int recoveredCount = 0;
@@ -2104,9 +2162,7 @@ int main(int argc, char* argv[]) {
                             log.add(MessageType::Loot, "Recovered " + std::to_string(recoveredCount) + " items from your past self!");
                         }
                         // Clear the corpse save after recovery
-                        LOG_OP_START("delete_corpse_save");
                         fileio::delete_slot(2);
-                        LOG_OP_END("delete_corpse_save");
                         log.add(MessageType::Info, "Your spirit is at peace.");
                     } else {
                         LOG_WARN("Failed to load corpse save - file may be missing or corrupted");
@@ -2114,7 +2170,7 @@ int main(int argc, char* argv[]) {
                 } else {
                     // Normal enemy loot - drop 1-3 items per enemy
                     std::uniform_int_distribution<int> itemCountRoll(0, 100);
-                    int roll = itemCountRoll(rng);
+                    int roll = itemCountRoll(lootRng);
                     int itemCount = 1;  // 70% chance for 1 item
                     if (roll >= 70 && roll < 90) {
                         itemCount = 2;  // 20% chance for 2 items
@@ -2128,18 +2184,18 @@ int main(int argc, char* argv[]) {
                     for (int i = 0; i < itemCount; ++i) {
                         // Use loot:: functions for better item generation
                         std::uniform_int_distribution<int> itemTypeRoll(0, 100);
-                        int typeRoll = itemTypeRoll(rng);
+                        int typeRoll = itemTypeRoll(lootRng);
                         Item loot;
                         
                         if (typeRoll < 40) {
                             // 40% chance for weapon
-                            loot = loot::generate_weapon(currentDepth, rng);
+                            loot = loot::generate_weapon(currentDepth, lootRng);
                         } else if (typeRoll < 70) {
                             // 30% chance for armor
-                            loot = loot::generate_armor(currentDepth, rng);
+                            loot = loot::generate_armor(currentDepth, lootRng);
                         } else {
                             // 30% chance for consumable
-                            loot = loot::generate_consumable(currentDepth, rng);
+                            loot = loot::generate_consumable(currentDepth, lootRng);
                         }
                         
                     player.inventory().push_back(loot);
@@ -2160,6 +2216,7 @@ int main(int argc, char* argv[]) {
                 ++it;
             }
         }
+        floor.occupancy.rebuild(dungeon.width(), dungeon.height(), enemies);
 
         // Auto-respawn: DISABLED - was used for testing, now removed
         // if (enemies.empty()) {
@@ -2175,7 +2232,9 @@ int main(int argc, char* argv[]) {
 
         if (player.get_stats().hp <= 0 && player.get_stats().hp != -999) {
             if (!corpseSaved) {
-                save_corpse_state(player, difficulty, currentDepth, seed, stairsDown);
+                if (!replaySession) {
+                    save_corpse_state(player, difficulty, currentDepth, seed, stairsDown);
+                }
                 corpseSaved = true;
                 log.add(MessageType::Warning, "Your fallen gear lingers as a vengeful spirit!");
             }
@@ -2183,6 +2242,10 @@ int main(int argc, char* argv[]) {
             log.add(MessageType::Death, "You died.");
             running = false;
         }
+        if (running && autosaveTurns > 0 && ++turnsSinceAutosave >= autosaveTurns) {
+            turnsSinceAutosave = 0;
+            autosaver.submit(current_state(), floor, session.traps);
+        }
         auto frameEnd = std::chrono::steady_clock::now();
         auto frameDuration = std::chrono::duration_cast<std::chrono::milliseconds>(frameEnd - frameStart);
         long long frameMs = frameDuration.count();
@@ -2191,7 +2254,6 @@ int main(int argc, char* argv[]) {
             LOG_WARN("SLOW FRAME: Game loop iteration took " + std::to_string(frameMs) + "ms");
         }
         
-        LOG_OP_END("game_loop_iteration");
         
         // Check for slow frames (after logging)
         auto frameEndCheck = std::chrono::steady_clock::now();
@@ -2219,7 +2281,9 @@ int main(int argc, char* argv[]) {
         entry.causeOfDeath = "Victory";
         entry.timestamp = std::time(nullptr);
         entry.seed = seed;
-        leaderboard.add_entry(entry);
+        if (!replaySession) {
+            leaderboard.add_entry(entry);
+        }
         
         show_victory_screen(currentDepth, totalKillCount, player, seed, leaderboard);
     }
@@ -2235,38 +2299,37 @@ int main(int argc, char* argv[]) {
         entry.causeOfDeath = "Slain by " + lastEnemyAttacker;
         entry.timestamp = std::time(nullptr);
         entry.seed = seed;
-        leaderboard.add_entry(entry);
+        if (!replaySession) {
+            leaderboard.add_entry(entry);
+        }
         
         show_gameover_screen(currentDepth, totalKillCount, "Slain by " + lastEnemyAttacker, seed, leaderboard);
     }
 
     const bool playerAlive = player.get_stats().hp > 0 && player.get_stats().hp != -999;
-    if (playerAlive) {
-        // Rotate previous save to slot 3 (slot 2 reserved for corpse runs)
-        GameState previous{};
-        if (fileio::load_from_slot(previous, 1)) {
-            fileio::save_to_slot(previous, 3);
-        }
-
-        GameState state;
-        state.difficulty = difficulty;
-        state.player = player;
-        state.enemies = enemies;
-        state.depth = currentDepth;
-        state.seed = seed;
-        state.stairsDown = stairsDown;
-        fileio::save_to_slot(state, 1);
+    if (playerAlive && autosaver.running()) {
+        // Final save; stop() waits until it is on disk
+        autosaver.submit(current_state(), floor, session.traps);
+        autosaver.stop();
         LOG_INFO("Game saved to slot 1");
-    } else {
+    } else if (!playerAlive && !replaySession) {
+        autosaver.stop();  // A queued autosave must not bring the slot back
         fileio::delete_slot(1);
+        Database floorDb;
+        if (floorDb.open(game_constants::FLOOR_DATABASE_PATH)) {
+            floorDb.delete_save(1);
+        }
         LOG_INFO("Cleared autosave after completed run");
     }
 
     LOG_INFO("Game ended - shutting down");
+    replay::stop();
+    std::string profile = prof::stop();
     Logger::instance().shutdown();
 
     input::disable_raw_mode();
     ui::shutdown();
+    std::cout << profile;
     return 0;
 }
 
@@ -0,0 +1,34 @@
+#include "occupancy_grid.h"
+#include "enemy.h"
+
+#include <algorithm>
+
+void OccupancyGrid::rebuild(int width, int height, std::vector<Enemy>& enemies) {
+    width_ = std::max(0, width);
+    height_ = std::max(0, height);
+    cells_.assign(static_cast<size_t>(width_) * static_cast<size_t>(height_), EMPTY);
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        Enemy& e = enemies[i];
+        e.attach_occupancy(this, static_cast<int32_t>(i));
+        if (int32_t* c = cell(e.get_position().x, e.get_position().y)) {
+            *c = static_cast<int32_t>(i);
+        }
+    }
+}
+
+void OccupancyGrid::move(int32_t slot, const Position& from, const Position& to) {
+    int32_t* src = cell(from.x, from.y);
+    if (src && *src == slot) {
+        *src = EMPTY;
+    }
+    if (int32_t* dst = cell(to.x, to.y)) {
+        *dst = slot;
+    }
+}
+
+int32_t* OccupancyGrid::cell(int x, int y) {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+        return nullptr;
+    }
+    return &cells_[static_cast<size_t>(y) * static_cast<size_t>(width_) + static_cast<size_t>(x)];
+}
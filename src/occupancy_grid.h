@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "types.h"
+
+class Enemy;
+
+// Maps each tile of a floor to the index of the enemy standing on it, so
+// "who is at (x, y)" is a single array read instead of a scan of the enemy list.
+// Enemies attached by rebuild() keep their cell current from set_position/move_by.
+class OccupancyGrid {
+public:
+    static constexpr int32_t EMPTY = -1;
+
+    // Re-register every enemy (slot = index in the vector). Call after enemies
+    // are added, removed or reordered; it also re-attaches them to this grid.
+    void rebuild(int width, int height, std::vector<Enemy>& enemies);
+
+    // Enemy slot at a tile, or EMPTY
+    int32_t at(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+            return EMPTY;
+        }
+        return cells_[static_cast<size_t>(y) * static_cast<size_t>(width_) + static_cast<size_t>(x)];
+    }
+    bool is_occupied(int x, int y) const { return at(x, y) != EMPTY; }
+
+    // Move a slot's registration between tiles (called by Enemy)
+    void move(int32_t slot, const Position& from, const Position& to);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+private:
+    int32_t* cell(int x, int y);
+
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<int32_t> cells_;
+};
+
+// Non-owning link from an enemy to the grid slot it is registered in. The
+// link belongs to the storage slot, not the enemy's value: copies start
+// detached and assignment keeps the destination's link.
+struct OccupancyLink {
+    OccupancyGrid* grid = nullptr;
+    int32_t slot = OccupancyGrid::EMPTY;
+
+    OccupancyLink() = default;
+    OccupancyLink(const OccupancyLink&) {}
+    OccupancyLink& operator=(const OccupancyLink&) { return *this; }
+};
@@ -0,0 +1,159 @@
+#include "pathfinding.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace ai {
+    namespace {
+        // Smaller f first; among equal f prefer the deeper node (closer to goal)
+        bool heap_less(uint32_t fa, uint32_t ga, uint32_t fb, uint32_t gb) {
+            return fa != fb ? fa < fb : ga > gb;
+        }
+    }
+
+    void PathEngine::prepare(size_t tileCount) {
+        if (gScore_.size() < tileCount) {
+            gScore_.resize(tileCount);
+            parent_.resize(tileCount);
+            seenGen_.resize(tileCount, 0);
+            closedGen_.resize(tileCount, 0);
+            heap_.reserve(tileCount);
+        }
+        ++generation_;
+        if (generation_ == 0) {
+            // Stamp counter wrapped: clear stamps once so stale marks can't alias
+            std::fill(seenGen_.begin(), seenGen_.end(), 0);
+            std::fill(closedGen_.begin(), closedGen_.end(), 0);
+            generation_ = 1;
+        }
+        heap_.clear();
+    }
+
+    void PathEngine::heap_push(const HeapEntry& entry) {
+        heap_.push_back(entry);
+        size_t i = heap_.size() - 1;
+        while (i > 0) {
+            size_t up = (i - 1) / 2;
+            if (!heap_less(heap_[i].f, heap_[i].g, heap_[up].f, heap_[up].g)) {
+                break;
+            }
+            std::swap(heap_[i], heap_[up]);
+            i = up;
+        }
+    }
+
+    PathEngine::HeapEntry PathEngine::heap_pop() {
+        HeapEntry top = heap_.front();
+        heap_.front() = heap_.back();
+        heap_.pop_back();
+        size_t i = 0;
+        const size_t n = heap_.size();
+        for (;;) {
+            size_t l = i * 2 + 1;
+            size_t r = l + 1;
+            size_t best = i;
+            if (l < n && heap_less(heap_[l].f, heap_[l].g, heap_[best].f, heap_[best].g)) {
+                best = l;
+            }
+            if (r < n && heap_less(heap_[r].f, heap_[r].g, heap_[best].f, heap_[best].g)) {
+                best = r;
+            }
+            if (best == i) {
+                break;
+            }
+            std::swap(heap_[i], heap_[best]);
+            i = best;
+        }
+        return top;
+    }
+
+    bool PathEngine::find_path(const Dungeon& dungeon, const Position& start, const Position& goal,
+                               std::vector<Position>& out, int maxExpansions) {
+        out.clear();
+        ++queries_;
+        if (!dungeon.in_bounds(start.x, start.y) || !dungeon.in_bounds(goal.x, goal.y)) {
+            return false;
+        }
+        const std::vector<TileType>& tiles = dungeon.tiles();
+        const int width = dungeon.width();
+        const int height = dungeon.height();
+        const int32_t startIdx = start.y * width + start.x;
+        const int32_t goalIdx = goal.y * width + goal.x;
+        if (startIdx == goalIdx) {
+            return true;
+        }
+        if (!Dungeon::is_walkable_tile(tiles[static_cast<size_t>(goalIdx)])) {
+            return false;
+        }
+
+        prepare(tiles.size());
+        auto heuristic = [&](int32_t idx) {
+            return static_cast<uint32_t>(std::abs(idx % width - goal.x) + std::abs(idx / width - goal.y));
+        };
+
+        seenGen_[static_cast<size_t>(startIdx)] = generation_;
+        gScore_[static_cast<size_t>(startIdx)] = 0;
+        parent_[static_cast<size_t>(startIdx)] = -1;
+        heap_push({heuristic(startIdx), 0, startIdx});
+
+        const int dirs[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
+        int expansions = 0;
+        bool found = false;
+        while (!heap_.empty()) {
+            HeapEntry cur = heap_pop();
+            size_t ci = static_cast<size_t>(cur.index);
+            if (closedGen_[ci] == generation_ || cur.g != gScore_[ci]) {
+                continue;  // Stale heap entry
+            }
+            if (cur.index == goalIdx) {
+                found = true;
+                break;
+            }
+            closedGen_[ci] = generation_;
+            if (++expansions > maxExpansions) {
+                LOG_DEBUG("PathEngine gave up after " + std::to_string(maxExpansions) + " expansions");
+                break;
+            }
+
+            int cx = cur.index % width;
+            int cy = cur.index / width;
+            for (const auto& d : dirs) {
+                int nx = cx + d[0];
+                int ny = cy + d[1];
+                if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+                    continue;
+                }
+                int32_t nidx = ny * width + nx;
+                size_t ni = static_cast<size_t>(nidx);
+                if (closedGen_[ni] == generation_ || !Dungeon::is_walkable_tile(tiles[ni])) {
+                    continue;
+                }
+                uint32_t g = cur.g + 1;
+                if (seenGen_[ni] == generation_ && gScore_[ni] <= g) {
+                    continue;
+                }
+                seenGen_[ni] = generation_;
+                gScore_[ni] = g;
+                parent_[ni] = cur.index;
+                heap_push({g + heuristic(nidx), g, nidx});
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+
+        // Walk parents back from the goal, then reverse into start->goal order
+        for (int32_t idx = goalIdx; idx != startIdx; idx = parent_[static_cast<size_t>(idx)]) {
+            out.push_back({idx % width, idx / width});
+        }
+        std::reverse(out.begin(), out.end());
+        return true;
+    }
+
+    PathEngine& path_engine() {
+        thread_local PathEngine engine;
+        return engine;
+    }
+}
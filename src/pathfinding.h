@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "dungeon.h"
+#include "types.h"
+
+
+/**
+ * @namespace ai
+ * @brief Contains enemy AI logic and utility functions for enemy behavior.
+ */
+namespace ai {
+
+    /**
+     * @brief Point-to-point A* search over a dungeon's tile grid.
+     *
+     * Nodes are plain tile indices. The open set is a binary heap and the
+     * visited/closed sets are generation-stamped arrays, so all scratch storage
+     * is kept between queries and only grows when a larger map is searched.
+     */
+    class PathEngine {
+    public:
+        /// Default cap on node expansions per query.
+        static constexpr int DEFAULT_MAX_EXPANSIONS = 4096;
+
+        /**
+         * @brief Find a 4-way walking path between two tiles.
+         * @param dungeon The dungeon map.
+         * @param start Start tile (does not need to be walkable).
+         * @param goal Goal tile (must be walkable).
+         * @param out Output: steps from the tile after @p start up to and including @p goal.
+         *            Cleared first; its capacity is reused.
+         * @param maxExpansions Give up after expanding this many nodes.
+         * @return True if a path was found.
+         */
+        bool find_path(const Dungeon& dungeon, const Position& start, const Position& goal,
+                       std::vector<Position>& out, int maxExpansions = DEFAULT_MAX_EXPANSIONS);
+
+        /**
+         * @brief Get the number of queries run since construction.
+         * @return Query count
+         */
+        uint64_t query_count() const { return queries_; }
+
+    private:
+        struct HeapEntry {
+            uint32_t f;
+            uint32_t g;
+            int32_t index;
+        };
+
+        void prepare(size_t tileCount);
+        void heap_push(const HeapEntry& entry);
+        HeapEntry heap_pop();
+
+        std::vector<uint32_t> gScore_;
+        std::vector<int32_t> parent_;
+        std::vector<uint32_t> seenGen_;    // gScore_/parent_ valid for this generation
+        std::vector<uint32_t> closedGen_;  // node expanded in this generation
+        std::vector<HeapEntry> heap_;
+        uint32_t generation_ = 0;
+        uint64_t queries_ = 0;
+    };
+
+    /**
+     * @brief Get the path engine shared by AI code on the calling thread.
+     * @return Thread-local path engine
+     */
+    PathEngine& path_engine();
+}
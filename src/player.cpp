@@ -97,7 +97,8 @@ const std::vector<Item>& Player::inventory() const {
 
 bool Player::equip_item(size_t inventoryIndex) {
     if (inventoryIndex >= inventory_.size()) return false;
-    Item& it = inventory_[inventoryIndex];
+    // FIXED: Copy the item - unequipping below can grow inventory_ and invalidate a reference
+    const Item it = inventory_[inventoryIndex];
     if (!it.isEquippable) return false;
     
     // Dual wielding: Weapons can be equipped to either Weapon or Offhand slot
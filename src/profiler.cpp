@@ -0,0 +1,267 @@
+#include "profiler.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Zones a thread can hold between folds; a full buffer folds itself
+    constexpr size_t BUFFER_EVENTS = 8192;
+    // Zones longer than this are reported as freezes in the log
+    constexpr uint64_t FREEZE_NS = 500ull * 1000 * 1000;
+
+    struct Event {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Log-linear latency histogram: 8 sub-buckets per power of two, so any
+    // percentile is within 1/8 of the true value
+    struct Histogram {
+        static constexpr int SUB_BITS = 3;
+        static constexpr int SUB = 1 << SUB_BITS;
+
+        std::array<uint32_t, 64 * SUB> counts{};
+        uint64_t count = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+
+        static int bucket(uint64_t ns) {
+            if (ns < SUB) {
+                return static_cast<int>(ns);
+            }
+            int top = 63 - __builtin_clzll(ns);
+            int sub = static_cast<int>((ns >> (top - SUB_BITS)) & (SUB - 1));
+            return (top - SUB_BITS + 1) * SUB + sub;
+        }
+
+        // Midpoint of a bucket's range
+        static uint64_t value(int index) {
+            if (index < SUB) {
+                return static_cast<uint64_t>(index);
+            }
+            int top = index / SUB + SUB_BITS - 1;
+            uint64_t low = (1ull << top) | (static_cast<uint64_t>(index % SUB) << (top - SUB_BITS));
+            return low + (1ull << (top - SUB_BITS)) / 2;
+        }
+
+        void add(uint64_t ns) {
+            ++counts[bucket(ns)];
+            ++count;
+            totalNs += ns;
+            maxNs = std::max(maxNs, ns);
+        }
+
+        uint64_t percentile(double p) const {
+            uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    return std::min(value(static_cast<int>(i)), maxNs);
+                }
+            }
+            return maxNs;
+        }
+    };
+
+    struct ThreadBuffer;
+    void fold(ThreadBuffer& buffer);
+
+    std::atomic<uint32_t> g_nextThreadId{1};
+
+    struct ThreadBuffer {
+        ThreadBuffer() : threadId(g_nextThreadId++) { events.reserve(BUFFER_EVENTS); }
+        ~ThreadBuffer() { fold(*this); }   // Zones from threads that end between frames
+
+        std::vector<Event> events;          // Fixed capacity, never grows
+        uint32_t threadId;
+    };
+
+    // Shared state, guarded by g_mutex; only folds take it
+    std::mutex g_mutex;
+    Clock::time_point g_epoch;
+    std::atomic<bool> g_profiling{false};   // start() until stop(); otherwise freezes only
+    bool g_watchFreezes = false;
+    std::FILE* g_trace = nullptr;
+    bool g_firstEvent = true;
+    uint64_t g_frames = 0;
+    std::map<std::string, Histogram> g_zones;                 // By name, for the report
+    std::unordered_map<const char*, Histogram*> g_byPointer;  // Literal address -> histogram
+
+    ThreadBuffer& local_buffer() {
+        thread_local std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+        return *buffer;
+    }
+
+    void fold(ThreadBuffer& buffer) {
+        if (buffer.events.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(g_mutex);
+        const bool profiling = g_profiling.load(std::memory_order_relaxed);
+        for (const Event& event : buffer.events) {
+            uint64_t duration = event.endNs - event.startNs;
+            if (duration > FREEZE_NS) {
+                LOG_WARN(std::string("FREEZE DETECTED: ") + event.name + " took " +
+                         std::to_string(duration / 1000000) + "ms");
+            }
+            if (!profiling) {
+                continue;
+            }
+            Histogram*& histogram = g_byPointer[event.name];
+            if (!histogram) {
+                // The same name can live at several addresses (one per translation unit)
+                histogram = &g_zones[event.name];
+            }
+            histogram->add(duration);
+
+            if (g_trace) {
+                std::fprintf(g_trace, "%s{\"name\":\"%s\",\"cat\":\"zone\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                             g_firstEvent ? "\n" : ",\n", event.name,
+                             static_cast<double>(event.startNs) / 1000.0, static_cast<double>(duration) / 1000.0,
+                             buffer.threadId);
+                g_firstEvent = false;
+            }
+        }
+        buffer.events.clear();
+        if (g_trace) {
+            // Whole events only, so a trace cut short by a crash still loads
+            std::fflush(g_trace);
+        }
+    }
+
+    std::string format_us(uint64_t ns) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%10.1f", static_cast<double>(ns) / 1e3);
+        return text;
+    }
+}
+
+namespace prof {
+    namespace detail {
+        std::atomic<bool> active{false};
+
+        uint64_t now_ns() {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_epoch).count());
+        }
+
+        void record(const char* name, uint64_t startNs, uint64_t endNs) {
+            ThreadBuffer& buffer = local_buffer();
+            if (buffer.events.size() == BUFFER_EVENTS) {
+                fold(buffer);
+            }
+            buffer.events.push_back(Event{name, startNs, endNs});
+        }
+    }
+
+    bool start(const std::string& tracePath) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_trace) {
+            return true;
+        }
+        g_trace = std::fopen(tracePath.c_str(), "w");
+        if (!g_trace) {
+            LOG_ERROR("Profiler: cannot write " + tracePath);
+            return false;
+        }
+        std::fputs("[", g_trace);
+        g_firstEvent = true;
+        g_frames = 0;
+        g_zones.clear();
+        g_byPointer.clear();
+        if (!g_watchFreezes) {
+            g_epoch = Clock::now();
+        }
+        g_profiling.store(true, std::memory_order_relaxed);
+        detail::active.store(true, std::memory_order_relaxed);
+        LOG_INFO("Profiler: writing trace to " + tracePath);
+        return true;
+    }
+
+    void watch_freezes() {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_watchFreezes) {
+            return;
+        }
+        if (!g_profiling.load(std::memory_order_relaxed)) {
+            g_epoch = Clock::now();
+        }
+        g_watchFreezes = true;
+        detail::active.store(true, std::memory_order_relaxed);
+    }
+
+    bool enabled() {
+        return g_profiling.load(std::memory_order_relaxed);
+    }
+
+    void frame() {
+        if (!detail::active.load(std::memory_order_relaxed)) {
+            return;
+        }
+        fold(local_buffer());
+        if (enabled()) {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            ++g_frames;
+        }
+    }
+
+    std::string stop() {
+        if (!enabled()) {
+            return "";
+        }
+        fold(local_buffer());
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_profiling.store(false, std::memory_order_relaxed);
+        detail::active.store(g_watchFreezes, std::memory_order_relaxed);
+        if (g_trace) {
+            std::fputs("\n]\n", g_trace);
+            std::fclose(g_trace);
+            g_trace = nullptr;
+        }
+
+        // Slowest total time first
+        std::vector<std::pair<const std::string*, const Histogram*>> zones;
+        for (const auto& entry : g_zones) {
+            zones.emplace_back(&entry.first, &entry.second);
+        }
+        std::sort(zones.begin(), zones.end(), [](const auto& a, const auto& b) {
+            return a.second->totalNs > b.second->totalNs;
+        });
+
+        std::string report = "Profile";
+        if (g_frames > 0) {
+            report += ": " + std::to_string(g_frames) + " frames";
+        }
+        report += " (times in us)\n";
+        char header[160];
+        std::snprintf(header, sizeof(header), "%-36s %8s %10s %10s %10s %10s %10s %10s\n",
+                      "zone", "count", "total", "mean", "p50", "p95", "p99", "max");
+        report += header;
+        for (const auto& zone : zones) {
+            const Histogram& h = *zone.second;
+            char count[16];
+            std::snprintf(count, sizeof(count), "%8llu", static_cast<unsigned long long>(h.count));
+            char name[40];
+            std::snprintf(name, sizeof(name), "%-36s", zone.first->c_str());
+            report += std::string(name) + " " + count + " " + format_us(h.totalNs) + " " +
+                      format_us(h.totalNs / h.count) + " " + format_us(h.percentile(0.50)) + " " +
+                      format_us(h.percentile(0.95)) + " " + format_us(h.percentile(0.99)) + " " +
+                      format_us(h.maxNs) + "\n";
+        }
+        g_byPointer.clear();
+        return report;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped-zone profiler. PROF_ZONE("name") times the rest of the enclosing
+// scope. Zones go into a fixed per-thread buffer (no locks, no allocation)
+// and are folded once per frame into per-zone latency histograms and a Chrome
+// trace (open it in chrome://tracing or ui.perfetto.dev). Off unless start()
+// (--profile) or watch_freezes() (--log-file) was called; a disabled zone
+// costs one relaxed atomic load.
+namespace prof {
+    // Start profiling, writing trace events to tracePath
+    // Returns false if the file cannot be created
+    bool start(const std::string& tracePath);
+
+    // Record zones only to warn about freezes: any zone over 500 ms is logged
+    // as FREEZE DETECTED. No trace, no histograms. Used when logging is on.
+    void watch_freezes();
+
+    // True while profiling (start() until stop())
+    bool enabled();
+
+    // Fold the calling thread's zones into the histograms and the trace.
+    // Called once per game-loop frame; buffers also fold themselves when full
+    // and when their thread exits.
+    void frame();
+
+    // Fold what is left, close the trace and stop recording
+    // Returns: per-zone table (count, mean, p50/p95/p99, max), or "" if not profiling
+    std::string stop();
+
+    namespace detail {
+        extern std::atomic<bool> active;
+        uint64_t now_ns();
+        void record(const char* name, uint64_t startNs, uint64_t endNs);
+    }
+
+    class Zone {
+    public:
+        // name is kept by pointer, so it must be a string literal
+        explicit Zone(const char* name)
+            : name_(detail::active.load(std::memory_order_relaxed) ? name : nullptr),
+              start_(name_ ? detail::now_ns() : 0) {}
+
+        ~Zone() {
+            if (name_) detail::record(name_, start_, detail::now_ns());
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t start_;
+    };
+}
+
+#define PROF_CONCAT_INNER(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_INNER(a, b)
+#define PROF_ZONE(name) ::prof::Zone PROF_CONCAT(profZone_, __LINE__)(name)
@@ -0,0 +1,234 @@
+#include "replay.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// File layout (little endian):
+//   "RDRP", version byte, seed u32, difficulty u8, flags u8, width u16, height u16
+// followed by LEB128 varint tokens:
+//   v > 0   key v - 1
+//   v == 0  followed by a count n: n reads in a row that found no key
+// Idle polls run at frame rate, so collapsing them keeps files to a few bytes per keypress.
+
+namespace {
+    constexpr char MAGIC[4] = {'R', 'D', 'R', 'P'};
+    constexpr uint8_t VERSION = 1;
+    constexpr size_t HEADER_SIZE = 4 + 1 + 4 + 1 + 1 + 2 + 2;
+    constexpr uint8_t FLAG_NO_COLOR = 1;
+    constexpr uint8_t FLAG_NO_UNICODE = 2;
+
+    void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void put_le(std::vector<uint8_t>& out, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    uint32_t get_le(const uint8_t* in, int bytes) {
+        uint32_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint32_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // Recording state
+    bool g_capturing = false;            // Between start_recording and cancel_recording / stop
+    std::string g_recordPath;
+    std::ofstream g_out;                 // Open once commit_recording has run
+    std::vector<uint8_t> g_pending;      // Encoded header and tokens not yet written
+    uint64_t g_idleRun = 0;              // "No key" results not yet encoded
+
+    // Playback state
+    std::vector<uint8_t> g_data;
+    size_t g_cursor = 0;
+    uint64_t g_idleLeft = 0;
+    bool g_playing = false;
+    replay::Header g_header;
+
+    void flush_idle_run() {
+        if (g_idleRun > 0) {
+            put_varint(g_pending, 0);
+            put_varint(g_pending, g_idleRun);
+            g_idleRun = 0;
+        }
+    }
+
+    void write_pending() {
+        if (g_out.is_open() && !g_pending.empty()) {
+            g_out.write(reinterpret_cast<const char*>(g_pending.data()),
+                        static_cast<std::streamsize>(g_pending.size()));
+            g_out.flush();
+            g_pending.clear();
+        }
+    }
+
+    // Returns false at the end of the data or on a truncated varint
+    bool get_varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && g_cursor < g_data.size(); shift += 7) {
+            uint8_t byte = g_data[g_cursor++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+namespace replay {
+    void start_recording(const std::string& path, const Header& header) {
+        stop();
+        g_capturing = true;
+        g_recordPath = path;
+        g_pending.assign(MAGIC, MAGIC + sizeof(MAGIC));
+        g_pending.push_back(VERSION);
+        put_le(g_pending, header.seed, 4);
+        g_pending.push_back(header.difficulty);
+        g_pending.push_back(static_cast<uint8_t>((header.noColor ? FLAG_NO_COLOR : 0) |
+                                                 (header.noUnicode ? FLAG_NO_UNICODE : 0)));
+        put_le(g_pending, header.termWidth, 2);
+        put_le(g_pending, header.termHeight, 2);
+    }
+
+    bool commit_recording() {
+        if (!g_capturing || g_out.is_open()) {
+            return g_out.is_open();
+        }
+        std::filesystem::path parent = std::filesystem::path(g_recordPath).parent_path();
+        if (!parent.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(parent, ec);
+        }
+        g_out.open(g_recordPath, std::ios::binary | std::ios::trunc);
+        if (!g_out) {
+            LOG_WARN("Replay: cannot record to " + g_recordPath);
+            cancel_recording();
+            return false;
+        }
+        flush_idle_run();
+        write_pending();
+        LOG_INFO("Replay: recording to " + g_recordPath);
+        return true;
+    }
+
+    void cancel_recording() {
+        g_out.close();
+        g_capturing = false;
+        g_recordPath.clear();
+        g_pending.clear();
+        g_idleRun = 0;
+    }
+
+    bool recording() {
+        return g_capturing;
+    }
+
+    void record_key(int key) {
+        if (!g_capturing) {
+            return;
+        }
+        if (key < 0) {
+            ++g_idleRun;
+            return;
+        }
+        // Written through on every real key (once committed) so a crash still
+        // leaves a usable file
+        flush_idle_run();
+        put_varint(g_pending, static_cast<uint64_t>(key) + 1);
+        write_pending();
+    }
+
+    bool load(const std::string& path, Header& header) {
+        stop();
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            LOG_ERROR("Replay: cannot open " + path);
+            return false;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() < HEADER_SIZE || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), data.begin()) ||
+            data[4] != VERSION) {
+            LOG_ERROR("Replay: " + path + " is not a replay file");
+            return false;
+        }
+
+        const uint8_t* p = data.data() + 5;
+        g_header.seed = get_le(p, 4);
+        g_header.difficulty = p[4];
+        g_header.noColor = (p[5] & FLAG_NO_COLOR) != 0;
+        g_header.noUnicode = (p[5] & FLAG_NO_UNICODE) != 0;
+        g_header.termWidth = static_cast<uint16_t>(get_le(p + 6, 2));
+        g_header.termHeight = static_cast<uint16_t>(get_le(p + 8, 2));
+        header = g_header;
+
+        g_data = std::move(data);
+        g_cursor = HEADER_SIZE;
+        g_idleLeft = 0;
+        g_playing = true;
+        LOG_INFO("Replay: playing " + path + " (" + std::to_string(g_data.size()) + " bytes)");
+        return true;
+    }
+
+    bool playing() {
+        return g_playing;
+    }
+
+    const Header& header() {
+        return g_header;
+    }
+
+    bool next_key(int& key) {
+        if (!g_playing) {
+            return false;
+        }
+        if (g_idleLeft > 0) {
+            --g_idleLeft;
+            key = -1;
+            return true;
+        }
+
+        uint64_t token = 0;
+        if (get_varint(token)) {
+            if (token > 0) {
+                key = static_cast<int>(token - 1);
+                return true;
+            }
+            uint64_t count = 0;
+            if (get_varint(count) && count > 0) {
+                g_idleLeft = count - 1;
+                key = -1;
+                return true;
+            }
+        }
+
+        LOG_INFO("Replay: end of recording, switching to live input");
+        g_playing = false;
+        g_data.clear();
+        return false;
+    }
+
+    void stop() {
+        if (g_out.is_open()) {
+            flush_idle_run();
+            write_pending();
+        }
+        cancel_recording();   // An uncommitted capture is dropped
+        g_playing = false;
+        g_data.clear();
+        g_cursor = 0;
+        g_idleLeft = 0;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Input replay: records every key result the game reads, plus the seed and
+// settings that shape a run, to a compact binary file and feeds them back
+// later so the run plays out exactly as before. Only fresh runs can be
+// replayed: keys are held in memory until the run's starting state is known,
+// and a run that continues a save or meets a vengeful spirit (state from
+// files the replay does not carry) is never written. Playback likewise starts
+// fresh and writes no saves, corpse or leaderboard entries.
+namespace replay {
+    // Everything besides keys that must match for identical playback
+    struct Header {
+        uint32_t seed = 0;
+        uint8_t difficulty = 1;
+        bool noColor = false;
+        bool noUnicode = false;
+        uint16_t termWidth = 80;         // Terminal size at startup (drives layout checks)
+        uint16_t termHeight = 24;
+    };
+
+    // Start capturing keys for path. Nothing is written until commit_recording
+    void start_recording(const std::string& path, const Header& header);
+
+    // The run starts from header.seed alone: write what was captured (parent
+    // directories are created) and write through from now on
+    // Returns false (and drops the capture) if the file cannot be opened
+    bool commit_recording();
+
+    // Drop the capture without touching the file, for a run the replay
+    // could not reproduce
+    void cancel_recording();
+
+    // True from start_recording until the capture is dropped or stopped
+    bool recording();
+
+    // Append one key read result (-1 = no key was available)
+    void record_key(int key);
+
+    // Load a replay for playback; the keys are fed back by next_key
+    // Returns false if the file is missing or not a replay
+    bool load(const std::string& path, Header& header);
+
+    bool playing();
+
+    // Header of the replay being played
+    const Header& header();
+
+    // Next recorded key result. Returns false (and ends playback, so live
+    // input takes over) once the recording is exhausted.
+    bool next_key(int& key);
+
+    // Flush and close the recording and end playback
+    void stop();
+}
@@ -0,0 +1,43 @@
+#include "rng.h"
+#include <random>
+
+namespace rngs {
+    namespace {
+        thread_local Streams* t_bound = nullptr;
+
+        Streams& fallback() {
+            thread_local Streams streams(
+                (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}());
+            return streams;
+        }
+    }
+
+    uint64_t derive_seed(uint64_t runSeed, Stream stream, int floor) {
+        uint64_t state = runSeed;
+        uint64_t base = Rng::splitmix64(state);
+        state = base ^ (static_cast<uint64_t>(stream) + 1) * 0xD1B54A32D192ED03ull;
+        uint64_t perStream = Rng::splitmix64(state);
+        state = perStream ^ static_cast<uint64_t>(static_cast<uint32_t>(floor)) * 0x8CB92BA72F3D8DD7ull;
+        return Rng::splitmix64(state);
+    }
+
+    void Streams::reseed(uint64_t runSeed) {
+        seed = runSeed;
+        for (size_t i = 0; i < streams.size(); ++i) {
+            streams[i].seed(derive_seed(runSeed, static_cast<Stream>(i)));
+        }
+    }
+
+    Rng& stream(Stream which) {
+        Streams* bound = t_bound;
+        return bound ? bound->get(which) : fallback().get(which);
+    }
+
+    Bind::Bind(Streams& streams) : previous_(t_bound) {
+        t_bound = &streams;
+    }
+
+    Bind::~Bind() {
+        t_bound = previous_;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>  // Distributions take an Rng directly
+
+// xoshiro256** generator: 32 bytes of state, a handful of instructions per
+// draw, and usable anywhere a UniformRandomBitGenerator is (std distributions).
+// Seeded through splitmix64, so nearby seeds still give unrelated sequences.
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    Rng() { seed(0); }
+    explicit Rng(uint64_t seedValue) { seed(seedValue); }
+
+    void seed(uint64_t seedValue) {
+        for (auto& word : state_) {
+            word = splitmix64(seedValue);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    // splitmix64 step: advances state and returns a well-mixed 64-bit value
+    static uint64_t splitmix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::array<uint64_t, 4> state_{};
+};
+
+namespace rngs {
+    // Independent random streams, one per subsystem, so e.g. extra combat
+    // rolls never shift which loot drops or where enemies spawn
+    enum class Stream : uint32_t {
+        World,   // Enemy spawns, traps, shrines, floor events
+        Loot,    // Drops and item names
+        Combat,  // Hit rolls, affixes, retreat, arenas
+        Ai,      // Enemy decisions
+        Count
+    };
+
+    // Seed for (run seed, stream, floor); floor 0 = whole-run stream
+    uint64_t derive_seed(uint64_t runSeed, Stream stream, int floor = 0);
+
+    // The per-subsystem streams of one game session, all derived from its seed
+    struct Streams {
+        Streams() { reseed(0); }
+        explicit Streams(uint64_t runSeed) { reseed(runSeed); }
+
+        void reseed(uint64_t runSeed);
+        Rng& get(Stream stream) { return streams[static_cast<size_t>(stream)]; }
+
+        // Fresh generator for one floor of one subsystem (same every time it is asked for)
+        Rng for_floor(Stream stream, int floor) const { return Rng(derive_seed(seed, stream, floor)); }
+
+        uint64_t seed = 0;
+        std::array<Rng, static_cast<size_t>(Stream::Count)> streams;
+    };
+
+    // Stream for code that has no session handle (combat and AI internals).
+    // Draws from the streams bound on this thread, or from a per-thread
+    // fallback seeded from std::random_device when none are bound.
+    Rng& stream(Stream stream);
+
+    // Binds a session's streams to the current thread for its lifetime
+    class Bind {
+    public:
+        explicit Bind(Streams& streams);
+        ~Bind();
+        Bind(const Bind&) = delete;
+        Bind& operator=(const Bind&) = delete;
+
+    private:
+        Streams* previous_;
+    };
+}
@@ -7,7 +7,7 @@
 
 namespace shrine {
 
-BlessingResult get_random_blessing(std::mt19937& rng) {
+BlessingResult get_random_blessing(Rng& rng) {
     std::uniform_int_distribution<int> dist(0, 100);
     int roll = dist(rng);
     
@@ -104,10 +104,8 @@ void apply_blessing(Player& player, ShrineBlessing blessing, MessageLog& log) {
             
         case ShrineBlessing::CURSE: {
             // Random curse effect
-            std::random_device rd;
-            std::mt19937 rng(rd());
             std::uniform_int_distribution<int> curseDist(0, 3);
-            int curseType = curseDist(rng);
+            int curseType = curseDist(rngs::stream(rngs::Stream::World));
             
             switch (curseType) {
                 case 0:
@@ -215,7 +213,7 @@ void tick_blessings(Player& player, MessageLog& log) {
     }
 }
 
-bool interact_with_shrine(Player& player, MessageLog& log, std::mt19937& rng) {
+bool interact_with_shrine(Player& player, MessageLog& log, Rng& rng) {
     // Legacy function no longer used in main loop; keep simple behavior for any remaining callers.
     BlessingResult result = get_random_blessing(rng);
     log.add(MessageType::Info, std::string(glyphs::shrine()) + " You feel the shrine's power...");
@@ -4,7 +4,7 @@
 #include "player.h"
 #include "ui.h"
 #include "logger.h"
-#include <random>
+#include "rng.h"
 #include <string>
 
 namespace shrine {
@@ -16,7 +16,7 @@ namespace shrine {
     };
     
     // Get a random blessing/curse from a shrine
-    BlessingResult get_random_blessing(std::mt19937& rng);
+    BlessingResult get_random_blessing(Rng& rng);
     
     // Apply a blessing to the player
     void apply_blessing(Player& player, ShrineBlessing blessing, MessageLog& log);
@@ -34,6 +34,6 @@ namespace shrine {
     void tick_blessings(Player& player, MessageLog& log);
     
     // Show shrine interaction menu
-    bool interact_with_shrine(Player& player, MessageLog& log, std::mt19937& rng);
+    bool interact_with_shrine(Player& player, MessageLog& log, Rng& rng);
 }
 
@@ -0,0 +1,54 @@
+// rogue_depths_sim: batch balance simulator. Plays a seed range with the
+// headless bot on every core and prints outcome statistics. Accepts the same
+// options as rogue_depths --headless, but defaults to one worker per core.
+#include <iostream>
+#include "cli.h"
+#include "headless.h"
+#include "logger.h"
+#include "profiler.h"
+
+int main(int argc, char* argv[]) {
+    bool threadsGiven = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--threads") {
+            threadsGiven = true;
+        }
+    }
+
+    CLIConfig cliConfig = cli::parse(argc, argv);
+    cli::set_config(cliConfig);
+    if (cliConfig.showHelp) {
+        cli::print_help(argv[0]);
+        return cliConfig.exitCode;
+    }
+    if (cliConfig.showVersion) {
+        cli::print_version();
+        return cliConfig.exitCode;
+    }
+    if (cliConfig.exitRequested) {
+        std::cerr << "Invalid arguments; see --help\n";
+        return cliConfig.exitCode;
+    }
+
+    if (!cliConfig.logFile.empty()) {
+        Logger::instance().set_level(static_cast<LogLevel>(cliConfig.logLevel));
+        Logger::instance().init(cliConfig.logFile);
+        prof::watch_freezes();
+    }
+
+    if (!cliConfig.profileFile.empty()) {
+        prof::start(cliConfig.profileFile);
+    }
+
+    headless::Options options;
+    options.firstSeed = (cliConfig.seed != 0) ? cliConfig.seed : 1;
+    options.runs = cliConfig.runs;
+    options.maxTurns = cliConfig.maxTurns;
+    options.playerClass = static_cast<PlayerClass>(cliConfig.playerClass);
+    options.difficulty = static_cast<Difficulty>(cliConfig.difficulty);
+    options.threads = threadsGiven ? static_cast<unsigned>(cliConfig.threads) : 0;
+    int exitCode = headless::run_batch(options);
+    std::cout << prof::stop();
+    Logger::instance().shutdown();
+    return exitCode;
+}
@@ -5,7 +5,7 @@
 #include "logger.h"
 
 #include <iostream>
-#include <random>
+#include "rng.h"
 #include <cmath>
 #include <algorithm>
 
@@ -121,8 +121,7 @@ namespace spells {
         caster.use_mana(6);
         
         Position ppos = caster.get_position();
-        std::random_device rd;
-        std::mt19937 rng(rd());
+        Rng& rng = rngs::stream(rngs::Stream::Combat);
         
         // Find a random walkable tile within 10 tiles
         for (int attempts = 0; attempts < 100; ++attempts) {
@@ -0,0 +1,76 @@
+#include "tile_codec.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr unsigned LONG_RUN = 15;   // Low nibble marking a varint run length
+
+    static_assert(static_cast<int>(TileType::Unknown) < 16, "tile types must fit in a nibble");
+}
+
+namespace tile_codec {
+    void encode(const TileType* tiles, size_t count, std::vector<uint8_t>& out) {
+        // Worst case is one byte per tile; typical maps need far less
+        out.reserve(out.size() + std::min<size_t>(count, 64 + count / 4));
+        size_t i = 0;
+        while (i < count) {
+            const TileType tile = tiles[i];
+            size_t run = 1;
+            while (i + run < count && tiles[i + run] == tile) {
+                ++run;
+            }
+            i += run;
+
+            const uint8_t high = static_cast<uint8_t>(static_cast<unsigned>(tile) << 4);
+            if (run <= LONG_RUN) {
+                out.push_back(static_cast<uint8_t>(high | (run - 1)));
+                continue;
+            }
+            out.push_back(static_cast<uint8_t>(high | LONG_RUN));
+            size_t extra = run - (LONG_RUN + 1);
+            while (extra >= 0x80) {
+                out.push_back(static_cast<uint8_t>(extra | 0x80));
+                extra >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(extra));
+        }
+    }
+
+    size_t decode(const uint8_t* data, size_t size, size_t count, std::vector<TileType>& tiles) {
+        tiles.clear();
+        size_t pos = 0;
+        size_t filled = 0;
+        while (filled < count) {
+            if (pos >= size) {
+                return 0;
+            }
+            const uint8_t token = data[pos++];
+            const unsigned tile = token >> 4;
+            if (tile > static_cast<unsigned>(TileType::Unknown)) {
+                return 0;
+            }
+
+            size_t run = (token & 0x0F) + 1u;
+            if ((token & 0x0F) == LONG_RUN) {
+                size_t extra = 0;
+                for (unsigned shift = 0;; shift += 7) {
+                    if (pos >= size || shift > 28) {
+                        return 0;
+                    }
+                    const uint8_t byte = data[pos++];
+                    extra |= static_cast<size_t>(byte & 0x7F) << shift;
+                    if (!(byte & 0x80)) {
+                        break;
+                    }
+                }
+                run = LONG_RUN + 1 + extra;
+            }
+            if (run > count - filled) {
+                return 0;
+            }
+            tiles.insert(tiles.end(), run, static_cast<TileType>(tile));
+            filled += run;
+        }
+        return pos;
+    }
+}
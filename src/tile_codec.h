@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "types.h"
+
+// Compact tile encoding for stored maps; Database floor blobs are its only
+// user today. Maps are long runs of a few tile types, so tiles are run-length
+// encoded over the whole row-major array with the tile in the high nibble of
+// each token byte:
+//   (tile << 4) | (run - 1)        runs of 1..15
+//   (tile << 4) | 15, varint(n)    runs of 16 + n (LEB128, 7 bits per byte)
+// An 80x40 floor comes to a few hundred bytes instead of 3200.
+namespace tile_codec {
+    // Append the encoding of count tiles to out
+    void encode(const TileType* tiles, size_t count, std::vector<uint8_t>& out);
+
+    // Decode exactly count tiles from data into tiles (replacing its contents)
+    // tiles only grows by runs that fit in count, so a corrupt count or run
+    // length never allocates more than the decoded tiles; callers still bound
+    // count (e.g. by the maximum map size) before decoding.
+    // Returns: bytes consumed, or 0 if the data is truncated, overruns count
+    // or holds an unknown tile type
+    size_t decode(const uint8_t* data, size_t size, size_t count, std::vector<TileType>& tiles);
+}
@@ -0,0 +1,88 @@
+// embed_assets: build-time generator that turns the ASCII art under an asset
+// directory into a C++ source of constexpr string data (see embedded_assets.h).
+// Usage: embed_assets <asset-root> <output.cpp> <file.txt>...
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// Characters per literal chunk; keeps lines short and clear of compiler string limits
+static constexpr size_t CHUNK = 64;
+
+static void write_literal(std::ostream& out, const std::string& bytes) {
+    static const char* hex = "0123456789abcdef";
+    if (bytes.empty()) {
+        out << "        \"\"";
+        return;
+    }
+    for (size_t start = 0; start < bytes.size(); start += CHUNK) {
+        out << (start == 0 ? "        \"" : "\n        \"");
+        for (size_t i = start; i < bytes.size() && i < start + CHUNK; ++i) {
+            unsigned char c = static_cast<unsigned char>(bytes[i]);
+            switch (c) {
+                case '\n': out << "\\n"; break;
+                case '\r': out << "\\r"; break;
+                case '\t': out << "\\t"; break;
+                case '"':  out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '?':  out << "\\?"; break;   // No trigraphs
+                default:
+                    if (c < 0x20 || c >= 0x7f) {
+                        // Octal escapes stop after three digits, unlike hex ones
+                        out << '\\' << hex[(c >> 6) & 7] << hex[(c >> 3) & 7] << hex[c & 7];
+                    } else {
+                        out << static_cast<char>(c);
+                    }
+            }
+        }
+        out << '"';
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <asset-root> <output.cpp> <file.txt>...\n";
+        return 1;
+    }
+    const fs::path root = argv[1];
+
+    std::ostringstream out;
+    out << "// Generated by embed_assets from " << root.generic_string() << " - do not edit\n"
+        << "#include \"embedded_assets.h\"\n\n"
+        << "namespace assets::embedded {\n"
+        << "    constexpr Entry kEntries[] = {\n";
+    int count = 0;
+    for (int i = 3; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::cerr << "embed_assets: cannot read " << argv[i] << "\n";
+            return 1;
+        }
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::string name = fs::path(argv[i]).lexically_relative(root).replace_extension().generic_string();
+        out << "        {\"" << name << "\",\n";
+        write_literal(out, bytes);
+        out << ",\n         " << bytes.size() << "},\n";
+        ++count;
+    }
+    if (count == 0) {
+        // Zero-length arrays are not valid C++
+        out << "        {\"\", \"\", 0},\n";
+    }
+    out << "    };\n\n"
+        << "    const Entry* entries() { return kEntries; }\n"
+        << "    size_t count() { return " << count << "; }\n"
+        << "}\n";
+
+    std::string generated = out.str();
+    std::ofstream file(argv[2], std::ios::binary | std::ios::trunc);
+    if (!file || !(file << generated)) {
+        std::cerr << "embed_assets: cannot write " << argv[2] << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -5,7 +5,7 @@
 
 namespace traps {
 
-TrapType get_random_trap_type(std::mt19937& rng) {
+TrapType get_random_trap_type(Rng& rng) {
     std::uniform_int_distribution<int> dist(0, 4);
     switch (dist(rng)) {
         case 0: return TrapType::SPIKE_PIT;
@@ -27,7 +27,7 @@ Trap create_trap(int x, int y, TrapType type) {
     return trap;
 }
 
-void trigger_trap(Trap& trap, Player& player, Dungeon& dungeon, MessageLog& log, std::mt19937& rng) {
+void trigger_trap(Trap& trap, Player& player, Dungeon& dungeon, MessageLog& log, Rng& rng) {
     if (trap.triggered) return;  // Already triggered
     
     trap.triggered = true;
@@ -91,7 +91,7 @@ void trigger_trap(Trap& trap, Player& player, Dungeon& dungeon, MessageLog& log,
     }
 }
 
-bool player_detects_trap(const Player& player, const Trap& trap, std::mt19937& rng) {
+bool player_detects_trap(const Player& player, const Trap& trap, Rng& rng) {
     // Base detection chance: 20%
     int baseChance = 20;
     
@@ -157,7 +157,7 @@ const char* get_trap_color(TrapType type) {
     }
 }
 
-int calculate_trap_damage(TrapType type, std::mt19937& rng) {
+int calculate_trap_damage(TrapType type, Rng& rng) {
     auto [minDmg, maxDmg] = get_trap_damage(type);
     if (minDmg == 0 && maxDmg == 0) return 0;
     
@@ -165,7 +165,7 @@ int calculate_trap_damage(TrapType type, std::mt19937& rng) {
     return dist(rng);
 }
 
-Position find_random_walkable(const Dungeon& dungeon, std::mt19937& rng) {
+Position find_random_walkable(const Dungeon& dungeon, Rng& rng) {
     Position pos;
     int attempts = 0;
     const int maxAttempts = 1000;
@@ -5,7 +5,7 @@
 #include "dungeon.h"
 #include "ui.h"
 #include "logger.h"
-#include <random>
+#include "rng.h"
 #include <string>
 
 namespace traps {
@@ -18,16 +18,16 @@ namespace traps {
     };
     
     // Get a random trap type
-    TrapType get_random_trap_type(std::mt19937& rng);
+    TrapType get_random_trap_type(Rng& rng);
     
     // Create a trap at position
     Trap create_trap(int x, int y, TrapType type);
     
     // Trigger a trap on the player
-    void trigger_trap(Trap& trap, Player& player, Dungeon& dungeon, MessageLog& log, std::mt19937& rng);
+    void trigger_trap(Trap& trap, Player& player, Dungeon& dungeon, MessageLog& log, Rng& rng);
     
     // Check if player detects a trap (based on perception/class)
-    bool player_detects_trap(const Player& player, const Trap& trap, std::mt19937& rng);
+    bool player_detects_trap(const Player& player, const Trap& trap, Rng& rng);
     
     // Get trap damage range
     std::pair<int, int> get_trap_damage(TrapType type);
@@ -42,9 +42,9 @@ namespace traps {
     const char* get_trap_color(TrapType type);
     
     // Calculate trap damage
-    int calculate_trap_damage(TrapType type, std::mt19937& rng);
+    int calculate_trap_damage(TrapType type, Rng& rng);
     
     // Find random walkable position for teleport
-    Position find_random_walkable(const Dungeon& dungeon, std::mt19937& rng);
+    Position find_random_walkable(const Dungeon& dungeon, Rng& rng);
 }
 
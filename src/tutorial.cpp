@@ -8,8 +8,8 @@
 #include "types.h"
 #include "viewport.h"
 #include "globals.h"
+#include "animation.h"
 #include <iostream>
-#include <thread>
 #include <chrono>
 #include <algorithm>
 #include <random>
@@ -324,61 +324,71 @@ namespace tutorial {
     }
     
     // Show enhanced success animation (multi-frame: sparkles → checkmark → fade)
+    // IMPROVED: Frames are queued on the animation timeline (any key skips them)
     static void show_success_animation(int row, int col) {
         // Frame 1: Sparkles
-        ui::move_cursor(row, col);
-        ui::set_color(constants::color_msg_heal);
-        std::cout << glyphs::sparkle() << " " << glyphs::sparkle() << " " << glyphs::sparkle();
-        ui::reset_color();
-        std::cout.flush();
-        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        anim::push([row, col] {
+            ui::move_cursor(row, col);
+            ui::set_color(constants::color_msg_heal);
+            std::cout << glyphs::sparkle() << " " << glyphs::sparkle() << " " << glyphs::sparkle();
+            ui::reset_color();
+            std::cout.flush();
+        }, 300);
         
         // Frame 2: Checkmark with sparkles
-        ui::move_cursor(row, col);
-        ui::set_color(constants::color_msg_heal);
-        std::cout << glyphs::sparkle() << " " << glyphs::checkmark() << " Success! " << glyphs::checkmark() << " " << glyphs::sparkle();
-        ui::reset_color();
-        std::cout.flush();
+        anim::call([row, col] {
+            ui::move_cursor(row, col);
+            ui::set_color(constants::color_msg_heal);
+            std::cout << glyphs::sparkle() << " " << glyphs::checkmark() << " Success! " << glyphs::checkmark() << " " << glyphs::sparkle();
+            ui::reset_color();
+            std::cout.flush();
+        });
         ui::play_victory_sound();
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        anim::pause(500);
         
         // Frame 3: Fade out
         for (int i = 0; i < 3; ++i) {
-            ui::move_cursor(row, col);
-            ui::set_color(constants::color_floor);
-            std::cout << glyphs::checkmark() << " Success! ";
-            ui::reset_color();
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            anim::push([row, col] {
+                ui::move_cursor(row, col);
+                ui::set_color(constants::color_floor);
+                std::cout << glyphs::checkmark() << " Success! ";
+                ui::reset_color();
+                std::cout.flush();
+            }, 200);
         }
         
         // Clear the animation
-        ui::move_cursor(row, col);
-        for (int i = 0; i < 20; ++i) std::cout << " ";
-        std::cout.flush();
+        anim::call([row, col] {
+            ui::move_cursor(row, col);
+            for (int i = 0; i < 20; ++i) std::cout << " ";
+            std::cout.flush();
+        });
     }
     
     // Show section completion celebration
     static void show_section_completion_celebration(int row, int col) {
         // Multiple sparkles animation
         for (int frame = 0; frame < 5; ++frame) {
-            ui::move_cursor(row, col);
-            ui::set_color(constants::color_msg_heal);
-            for (int i = 0; i < 10; ++i) {
-                if ((i + frame) % 3 == 0) {
-                    std::cout << glyphs::sparkle() << " ";
-                } else {
-                    std::cout << "  ";
+            anim::push([row, col, frame] {
+                ui::move_cursor(row, col);
+                ui::set_color(constants::color_msg_heal);
+                for (int i = 0; i < 10; ++i) {
+                    if ((i + frame) % 3 == 0) {
+                        std::cout << glyphs::sparkle() << " ";
+                    } else {
+                        std::cout << "  ";
+                    }
                 }
-            }
-            ui::reset_color();
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+                ui::reset_color();
+                std::cout.flush();
+            }, 150);
         }
         // Clear
-        ui::move_cursor(row, col);
-        for (int i = 0; i < 20; ++i) std::cout << " ";
-        std::cout.flush();
+        anim::call([row, col] {
+            ui::move_cursor(row, col);
+            for (int i = 0; i < 20; ++i) std::cout << " ";
+            std::cout.flush();
+        });
     }
     
     // Helper function for section completion transition
@@ -395,20 +405,24 @@ namespace tutorial {
         // Show "Section Complete!" message
         int msgRow = termSize.height / 2;
         int msgCol = termSize.width / 2 - 10;
-        ui::move_cursor(msgRow, msgCol);
-        ui::set_color(constants::color_msg_heal);
-        std::cout << glyphs::checkmark() << " Section Complete! " << glyphs::checkmark();
-        ui::reset_color();
-        std::cout.flush();
-        std::this_thread::sleep_for(std::chrono::milliseconds(2000));  // Increased from 1000
+        anim::push([msgRow, msgCol] {
+            ui::move_cursor(msgRow, msgCol);
+            ui::set_color(constants::color_msg_heal);
+            std::cout << glyphs::checkmark() << " Section Complete! " << glyphs::checkmark();
+            ui::reset_color();
+            std::cout.flush();
+        }, 2000);  // Increased from 1000
         
         state.log->add(MessageType::Info, message);
         
         // Add a brief pause before moving player
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        anim::pause(500);
         
         state.player->set_position(nextX, nextY);
         ui::fade_transition(5);  // Longer fade (was 3)
+        
+        // The tutorial loop redraws every frame, so play the sequence out first
+        anim::finish();
     }
     
     // Unified section completion function - handles all section completions consistently
@@ -454,6 +468,7 @@ namespace tutorial {
         
         // 8. Show transition
         ui::fade_transition(5);
+        anim::finish();
         
         // 9. Show guided prompt (if provided) - will be shown on next frame
         // Note: show_guided_prompt is called from main loop, so we set a flag
@@ -532,7 +547,7 @@ namespace tutorial {
                         if (room3ItemPositions[i].x == mapX && room3ItemPositions[i].y == mapY) {
                             // Check FOV before drawing
                             Position itemPos{mapX, mapY};
-                            if (!in_simple_fov(playerPos, itemPos.x, itemPos.y, constants::fov_radius)) continue;
+                            if (!state.dungeon->is_visible(itemPos.x, itemPos.y)) continue;
                             
                             ui::move_cursor(mapStartRow + 1 + vy, mapStartCol + 1 + vx);
                             // Check if player is nearby (within 2 tiles) for highlighting
@@ -567,7 +582,7 @@ namespace tutorial {
                         if (room4ItemPositions[i].x == mapX && room4ItemPositions[i].y == mapY) {
                             // Check FOV before drawing
                             Position itemPos{mapX, mapY};
-                            if (!in_simple_fov(playerPos, itemPos.x, itemPos.y, constants::fov_radius)) continue;
+                            if (!state.dungeon->is_visible(itemPos.x, itemPos.y)) continue;
                             
                             ui::move_cursor(mapStartRow + 1 + vy, mapStartCol + 1 + vx);
                             int distX = std::abs(playerPos.x - mapX);
@@ -590,7 +605,7 @@ namespace tutorial {
                         if (room5ItemPositions[i].x == mapX && room5ItemPositions[i].y == mapY) {
                             // Check FOV before drawing
                             Position itemPos{mapX, mapY};
-                            if (!in_simple_fov(playerPos, itemPos.x, itemPos.y, constants::fov_radius)) continue;
+                            if (!state.dungeon->is_visible(itemPos.x, itemPos.y)) continue;
                             
                             ui::move_cursor(mapStartRow + 1 + vy, mapStartCol + 1 + vx);
                             int distX = std::abs(playerPos.x - mapX);
@@ -613,7 +628,7 @@ namespace tutorial {
                         if (room7ItemPositions[i].x == mapX && room7ItemPositions[i].y == mapY) {
                             // Check FOV before drawing
                             Position itemPos{mapX, mapY};
-                            if (!in_simple_fov(playerPos, itemPos.x, itemPos.y, constants::fov_radius)) continue;
+                            if (!state.dungeon->is_visible(itemPos.x, itemPos.y)) continue;
                             
                             ui::move_cursor(mapStartRow + 1 + vy, mapStartCol + 1 + vx);
                             if (room7Items[i].type == ItemType::Weapon) {
@@ -1021,7 +1036,7 @@ namespace tutorial {
         state.log = &log;
         
         // Pre-place items in rooms
-        std::mt19937 rng(12345);  // Fixed seed for tutorial
+        Rng rng(12345);  // Fixed seed for tutorial
         
         // Room 3: Pre-place items
         Item weapon1 = loot::generate_weapon(1, rng);
@@ -1065,6 +1080,8 @@ namespace tutorial {
         tutorialSpider.stats().maxHp = 9999;
         tutorialSpider.set_position(7, 14);  // Keep same position (Room 8 unchanged)
         enemies.push_back(tutorialSpider);  // Add to enemies vector so it's drawn on map
+        OccupancyGrid occupancy;
+        occupancy.rebuild(tutorialDungeon.width(), tutorialDungeon.height(), enemies);
         
         // Main tutorial loop
         bool tutorialRunning = true;
@@ -1329,7 +1346,7 @@ namespace tutorial {
             // Draw map viewport only when in MAP view (hide map for other views in UI Views section)
             if (currentView == UIView::MAP) {
                 // Use standard viewport rendering
-                draw_map_viewport(*state.dungeon, *state.player, enemies, mapStartRow, mapStartCol, viewport_w, viewport_h);
+                draw_map_viewport(*state.dungeon, *state.player, enemies, occupancy, mapStartRow, mapStartCol, viewport_w, viewport_h);
                 
                 // Calculate camera position for overlay drawing
                 Position playerPos = state.player->get_position();
@@ -1445,7 +1462,7 @@ namespace tutorial {
             // Handle input
             int key = input::read_key_nonblocking();
             if (key == -1) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                ui::delay(16);
                 continue;
             }
             
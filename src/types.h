@@ -210,7 +210,8 @@ enum class CombatHazard {
 class Dungeon;
 class Player;
 class MessageLog;
-#include <random>  // For std::mt19937
+#include <vector>
+#include "rng.h"  // For Rng
 
 struct Position {
     int x = 0;
@@ -246,7 +247,7 @@ struct CombatArena {
     bool apply_hazard(const Position3D& pos, Player& player, MessageLog& log) const;
     
     // Generate random hazards for an arena
-    static CombatArena generate_random(int hazardCount, const Dungeon& dungeon, std::mt19937& rng);
+    static CombatArena generate_random(int hazardCount, const Dungeon& dungeon, Rng& rng);
 };
 
 // Combat distance zones for tactical positioning
@@ -6,19 +6,31 @@
 #include "enemy.h"
 #include "types.h"
 #include "logger.h"
+#include "animation.h"
+#include "assets.h"
+#include "profiler.h"
 
 #include <iostream>
 #include <cmath>
 #include <iomanip>
 #include <chrono>
 #include <thread>
-#include <sstream>
 #include <random>
 #include <fstream>
 #include <deque>
 #include <algorithm>
 #include <map>
 #include <deque>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <streambuf>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 void MessageLog::add(const std::string& line) {
     lines_.push_back(line);
@@ -199,17 +211,660 @@ void MessageLog::render_framed(int row, int col, int width, int maxLines) const
     }
 }
 
+// ---------------------------------------------------------------------------
+// Diffing screen buffer
+//
+// While a frame is open (ui::begin_frame .. ui::end_frame), everything written
+// to std::cout is interpreted as a terminal would (cursor moves, clears, SGR
+// colours, UTF-8 glyphs) into a back buffer of (glyph, fg, bg) cells instead of
+// being sent. end_frame() diffs the back buffer against the front buffer (what
+// the terminal already shows) and emits only the changed runs, with colour
+// changes and cursor moves coalesced, in a single write. Output outside a frame
+// passes straight through and forces a full repaint of the next frame.
+// ---------------------------------------------------------------------------
+namespace {
+    struct Cell {
+        uint32_t glyph = ' ';  // UTF-8 bytes packed low byte first; 0 = right half of a wide glyph
+        int16_t fg = -1;       // 256-colour index, -1 = terminal default
+        int16_t bg = -1;
+        uint8_t attrs = 0;     // SGR_* bits
+
+        bool same_style(const Cell& o) const { return fg == o.fg && bg == o.bg && attrs == o.attrs; }
+        bool operator==(const Cell& o) const { return glyph == o.glyph && same_style(o); }
+        bool operator!=(const Cell& o) const { return !(*this == o); }
+    };
+
+    enum : uint8_t {
+        SGR_BOLD = 1, SGR_DIM = 2, SGR_ITALIC = 4, SGR_UNDERLINE = 8, SGR_BLINK = 16, SGR_REVERSE = 32
+    };
+
+    // Re-emitting up to this many unchanged cells is cheaper than a cursor move
+    constexpr int RUN_GAP = 4;
+
+    int glyph_columns(uint32_t cp) {
+        if ((cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF) ||
+            (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+            (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF60) ||
+            (cp >= 0xFFE0 && cp <= 0xFFE6) || (cp >= 0x1F300 && cp <= 0x1F64F) ||
+            (cp >= 0x1F900 && cp <= 0x1F9FF) || cp >= 0x20000) {
+            return 2;
+        }
+        return 1;
+    }
+
+    void append_int(std::string& out, int value) {
+        char buf[12];
+        int n = 0;
+        do {
+            buf[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (n > 0) {
+            out += buf[--n];
+        }
+    }
+
+    class ScreenBuffer : public std::streambuf {
+    public:
+        void install() {
+            if (!passthrough_) {
+                passthrough_ = std::cout.rdbuf(this);
+            }
+        }
+
+        void uninstall() {
+            if (passthrough_) {
+                submit();
+                std::cout.rdbuf(passthrough_);
+                passthrough_ = nullptr;
+            }
+            capturing_ = false;
+        }
+
+        bool capturing() const { return capturing_; }
+        void invalidate() { fullRepaint_ = true; }
+
+        void begin_frame() {
+            if (!passthrough_) {
+                return;
+            }
+            auto size = input::get_terminal_size();
+            if (size.width != width_ || size.height != height_) {
+                width_ = std::max(1, size.width);
+                height_ = std::max(1, size.height);
+                front_.assign(static_cast<size_t>(width_) * static_cast<size_t>(height_), Cell{});
+                back_ = front_;
+                fullRepaint_ = true;
+            }
+            row_ = 0;
+            col_ = 0;
+            pen_ = Cell{};
+            state_ = ParseState::Text;
+            utf8Need_ = 0;
+            frameControls_.clear();
+            capturing_ = true;
+        }
+
+        void end_frame() {
+            if (!capturing_) {
+                return;
+            }
+            capturing_ = false;
+
+            // Anything written between frames rides along in the same write
+            out_.clear();
+            out_.swap(arena_);
+            if (fullRepaint_) {
+                out_ += "\033[0m\033[2J";
+                std::fill(front_.begin(), front_.end(), Cell{});
+                fullRepaint_ = false;
+            }
+            out_ += frameControls_;
+            emit_diff();
+            front_ = back_;
+
+            write_all(out_.data(), out_.size());
+            lastFrameBytes_ = out_.size();
+        }
+
+        size_t last_frame_bytes() const { return lastFrameBytes_; }
+
+        // Direct entry for the ui primitives: skips the ostream sentry/locale
+        // layer and lands in the frame parser or the arena.
+        void put(const char* s, size_t n) {
+            if (!passthrough_) {
+                std::cout.write(s, static_cast<std::streamsize>(n));
+                return;
+            }
+            if (capturing_) {
+                for (size_t i = 0; i < n; ++i) {
+                    feed(s[i]);
+                }
+                return;
+            }
+            append_arena(s, n);
+        }
+
+        // Draw a UTF-8 string at the parser cursor with a one-off foreground colour
+        void put_styled(const char* s, int16_t fg) {
+            Cell saved = pen_;
+            pen_ = Cell{};
+            pen_.fg = fg;
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+            while (*p) {
+                unsigned char c = *p++;
+                if (c < 0x80) {
+                    put_glyph(c, 1);
+                    continue;
+                }
+                int need = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : 1;
+                uint32_t packed = c;
+                uint32_t cp = c & (0x3F >> need);
+                for (int i = 1; i <= need && (*p & 0xC0) == 0x80; ++i) {
+                    packed |= static_cast<uint32_t>(*p) << (8 * i);
+                    cp = (cp << 6) | (*p & 0x3F);
+                    ++p;
+                }
+                put_glyph(packed, glyph_columns(cp));
+            }
+            pen_ = saved;
+        }
+
+        // Write out everything queued outside a frame with a single syscall
+        void submit() {
+            if (arena_.empty()) {
+                return;
+            }
+            write_all(arena_.data(), arena_.size());
+            arena_.clear();
+        }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            if (traits_type::eq_int_type(ch, traits_type::eof())) {
+                return traits_type::not_eof(ch);
+            }
+            if (!capturing_) {
+                char c = traits_type::to_char_type(ch);
+                append_arena(&c, 1);
+                return ch;
+            }
+            feed(traits_type::to_char_type(ch));
+            return ch;
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            if (!capturing_) {
+                append_arena(s, static_cast<size_t>(n));
+                return n;
+            }
+            for (std::streamsize i = 0; i < n; ++i) {
+                feed(s[i]);
+            }
+            return n;
+        }
+
+        int sync() override {
+            // Inside a frame a flush is a no-op: the frame is submitted by end_frame()
+            if (!capturing_) {
+                submit();
+            }
+            return 0;
+        }
+
+    private:
+        enum class ParseState { Text, Escape, Csi };
+
+        // Screens drawn outside begin_frame()/end_frame() (menus, combat,
+        // animations) accumulate here until the next flush point.
+        static constexpr size_t ARENA_SOFT_LIMIT = 1 << 20;
+
+        void append_arena(const char* s, size_t n) {
+            fullRepaint_ = true;
+            arena_.append(s, n);
+            if (arena_.size() >= ARENA_SOFT_LIMIT) {
+                submit();
+            }
+        }
+
+        size_t index(int row, int col) const {
+            return static_cast<size_t>(row) * static_cast<size_t>(width_) + static_cast<size_t>(col);
+        }
+
+        void feed(char ch) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            switch (state_) {
+                case ParseState::Escape:
+                    if (c == '[') {
+                        params_.clear();
+                        state_ = ParseState::Csi;
+                    } else {
+                        state_ = ParseState::Text;
+                    }
+                    return;
+                case ParseState::Csi:
+                    if (c >= 0x40 && c <= 0x7E) {
+                        csi_dispatch(static_cast<char>(c));
+                        state_ = ParseState::Text;
+                    } else {
+                        params_ += static_cast<char>(c);
+                    }
+                    return;
+                case ParseState::Text:
+                    break;
+            }
+
+            if (utf8Need_ > 0) {
+                if ((c & 0xC0) == 0x80) {
+                    utf8Packed_ |= static_cast<uint32_t>(c) << (8 * utf8Len_);
+                    utf8Cp_ = (utf8Cp_ << 6) | (c & 0x3F);
+                    ++utf8Len_;
+                    if (--utf8Need_ == 0) {
+                        put_glyph(utf8Packed_, glyph_columns(utf8Cp_));
+                    }
+                    return;
+                }
+                utf8Need_ = 0;  // Malformed sequence: drop it and treat c normally
+            }
+
+            if (c == 0x1B) {
+                state_ = ParseState::Escape;
+            } else if (c == '\n') {
+                ++row_;
+                col_ = 0;
+            } else if (c == '\r') {
+                col_ = 0;
+            } else if (c == '\b') {
+                col_ = std::max(0, col_ - 1);
+            } else if (c == '\t') {
+                col_ = std::min(width_ - 1, (col_ / 8 + 1) * 8);
+            } else if (c == '\a') {
+                frameControls_ += '\a';
+            } else if (c >= 0x20 && c < 0x7F) {
+                put_glyph(c, 1);
+            } else if (c >= 0xC0) {
+                utf8Need_ = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : 1;
+                utf8Len_ = 1;
+                utf8Packed_ = c;
+                utf8Cp_ = c & (0x3F >> utf8Need_);
+            }
+        }
+
+        void put_glyph(uint32_t packed, int columns) {
+            if (col_ >= width_) {
+                col_ = 0;  // Autowrap
+                ++row_;
+            }
+            if (row_ < 0 || row_ >= height_ || col_ < 0) {
+                col_ += columns;
+                return;
+            }
+            // Overwriting half of a wide glyph leaves its other half blank
+            if (back_[index(row_, col_)].glyph == 0 && col_ > 0) {
+                back_[index(row_, col_ - 1)].glyph = ' ';
+            }
+            size_t tail = static_cast<size_t>(col_ + columns);
+            if (tail < static_cast<size_t>(width_) && back_[index(row_, static_cast<int>(tail))].glyph == 0) {
+                back_[index(row_, static_cast<int>(tail))].glyph = ' ';
+            }
+
+            Cell cell = pen_;
+            cell.glyph = packed;
+            back_[index(row_, col_)] = cell;
+            if (columns == 2 && col_ + 1 < width_) {
+                cell.glyph = 0;
+                back_[index(row_, col_ + 1)] = cell;
+            }
+            col_ += columns;
+        }
+
+        int param(size_t n, int fallback) const {
+            size_t pos = 0;
+            for (size_t i = 0; i < n; ++i) {
+                pos = params_.find(';', pos);
+                if (pos == std::string::npos) {
+                    return fallback;
+                }
+                ++pos;
+            }
+            if (pos >= params_.size() || params_[pos] == ';') {
+                return fallback;
+            }
+            return std::atoi(params_.c_str() + pos);
+        }
+
+        void clear_cells(size_t from, size_t to) {
+            Cell blank;
+            blank.bg = pen_.bg;
+            std::fill(back_.begin() + static_cast<std::ptrdiff_t>(from),
+                      back_.begin() + static_cast<std::ptrdiff_t>(to), blank);
+        }
+
+        void csi_dispatch(char final) {
+            if (!params_.empty() && params_[0] == '?') {
+                // Private modes (cursor visibility) are forwarded untouched
+                frameControls_ += "\033[";
+                frameControls_ += params_;
+                frameControls_ += final;
+                return;
+            }
+            switch (final) {
+                case 'H':
+                case 'f':
+                    row_ = std::max(1, param(0, 1)) - 1;
+                    col_ = std::max(1, param(1, 1)) - 1;
+                    break;
+                case 'A': row_ = std::max(0, row_ - std::max(1, param(0, 1))); break;
+                case 'B': row_ += std::max(1, param(0, 1)); break;
+                case 'C': col_ = std::min(width_ - 1, col_ + std::max(1, param(0, 1))); break;
+                case 'D': col_ = std::max(0, col_ - std::max(1, param(0, 1))); break;
+                case 'G': col_ = std::max(1, param(0, 1)) - 1; break;
+                case 'd': row_ = std::max(1, param(0, 1)) - 1; break;
+                case 'J': {
+                    int mode = param(0, 0);
+                    if (mode == 2 || mode == 3) {
+                        clear_cells(0, back_.size());
+                    } else if (mode == 0 && row_ < height_) {
+                        clear_cells(index(row_, std::min(col_, width_)), back_.size());
+                    }
+                    break;
+                }
+                case 'K': {
+                    if (row_ >= height_) {
+                        break;
+                    }
+                    int mode = param(0, 0);
+                    size_t lineStart = index(row_, 0);
+                    size_t cursor = index(row_, std::min(col_, width_));
+                    size_t lineEnd = lineStart + static_cast<size_t>(width_);
+                    if (mode == 0) clear_cells(cursor, lineEnd);
+                    else if (mode == 1) clear_cells(lineStart, std::min(cursor + 1, lineEnd));
+                    else clear_cells(lineStart, lineEnd);
+                    break;
+                }
+                case 'm':
+                    apply_sgr();
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void apply_sgr() {
+            if (params_.empty()) {
+                pen_ = Cell{};
+                return;
+            }
+            size_t count = static_cast<size_t>(std::count(params_.begin(), params_.end(), ';')) + 1;
+            for (size_t i = 0; i < count; ++i) {
+                int p = param(i, 0);
+                if (p == 0) {
+                    pen_ = Cell{};
+                } else if (p == 1) {
+                    pen_.attrs |= SGR_BOLD;
+                } else if (p == 2) {
+                    pen_.attrs |= SGR_DIM;
+                } else if (p == 3) {
+                    pen_.attrs |= SGR_ITALIC;
+                } else if (p == 4) {
+                    pen_.attrs |= SGR_UNDERLINE;
+                } else if (p == 5) {
+                    pen_.attrs |= SGR_BLINK;
+                } else if (p == 7) {
+                    pen_.attrs |= SGR_REVERSE;
+                } else if (p == 22) {
+                    pen_.attrs &= static_cast<uint8_t>(~(SGR_BOLD | SGR_DIM));
+                } else if (p == 23) {
+                    pen_.attrs &= static_cast<uint8_t>(~SGR_ITALIC);
+                } else if (p == 24) {
+                    pen_.attrs &= static_cast<uint8_t>(~SGR_UNDERLINE);
+                } else if (p == 25) {
+                    pen_.attrs &= static_cast<uint8_t>(~SGR_BLINK);
+                } else if (p == 27) {
+                    pen_.attrs &= static_cast<uint8_t>(~SGR_REVERSE);
+                } else if (p >= 30 && p <= 37) {
+                    pen_.fg = static_cast<int16_t>(p - 30);
+                } else if (p == 39) {
+                    pen_.fg = -1;
+                } else if (p >= 40 && p <= 47) {
+                    pen_.bg = static_cast<int16_t>(p - 40);
+                } else if (p == 49) {
+                    pen_.bg = -1;
+                } else if (p >= 90 && p <= 97) {
+                    pen_.fg = static_cast<int16_t>(p - 90 + 8);
+                } else if (p >= 100 && p <= 107) {
+                    pen_.bg = static_cast<int16_t>(p - 100 + 8);
+                } else if ((p == 38 || p == 48) && i + 1 < count) {
+                    int kind = param(i + 1, 0);
+                    if (kind == 5 && i + 2 < count) {
+                        int16_t colour = static_cast<int16_t>(std::min(255, std::max(0, param(i + 2, 0))));
+                        (p == 38 ? pen_.fg : pen_.bg) = colour;
+                        i += 2;
+                    } else if (kind == 2) {
+                        i += 4;  // Truecolour is not used by the game; skip r;g;b
+                    }
+                }
+            }
+        }
+
+        void append_sgr(const Cell& cell) {
+            out_ += "\033[0";
+            const uint8_t codes[] = {1, 2, 3, 4, 5, 7};
+            for (int bit = 0; bit < 6; ++bit) {
+                if (cell.attrs & (1 << bit)) {
+                    out_ += ';';
+                    append_int(out_, codes[bit]);
+                }
+            }
+            if (cell.fg >= 0) {
+                if (cell.fg < 8) { out_ += ';'; append_int(out_, 30 + cell.fg); }
+                else if (cell.fg < 16) { out_ += ';'; append_int(out_, 90 + cell.fg - 8); }
+                else { out_ += ";38;5;"; append_int(out_, cell.fg); }
+            }
+            if (cell.bg >= 0) {
+                if (cell.bg < 8) { out_ += ';'; append_int(out_, 40 + cell.bg); }
+                else if (cell.bg < 16) { out_ += ';'; append_int(out_, 100 + cell.bg - 8); }
+                else { out_ += ";48;5;"; append_int(out_, cell.bg); }
+            }
+            out_ += 'm';
+        }
+
+        void emit_diff() {
+            Cell pen;
+            bool penKnown = false;  // Terminal pen state is unknown until the first SGR
+            int cursorRow = -1;
+            int cursorCol = -1;
+
+            for (int r = 0; r < height_; ++r) {
+                int c = 0;
+                while (c < width_) {
+                    if (back_[index(r, c)] == front_[index(r, c)]) {
+                        ++c;
+                        continue;
+                    }
+                    int start = c;
+                    if (back_[index(r, c)].glyph == 0 && start > 0) {
+                        --start;  // Repaint the left half of a wide glyph
+                    }
+                    int end = c + 1;
+                    for (int probe = end; probe < width_ && probe - end <= RUN_GAP; ++probe) {
+                        if (back_[index(r, probe)] != front_[index(r, probe)]) {
+                            end = probe + 1;
+                        }
+                    }
+                    if (end < width_ && back_[index(r, end)].glyph == 0) {
+                        ++end;  // Never split a wide glyph
+                    }
+
+                    if (cursorRow != r || cursorCol != start) {
+                        out_ += "\033[";
+                        append_int(out_, r + 1);
+                        out_ += ';';
+                        append_int(out_, start + 1);
+                        out_ += 'H';
+                    }
+                    for (int k = start; k < end; ++k) {
+                        const Cell& cell = back_[index(r, k)];
+                        if (cell.glyph == 0) {
+                            continue;
+                        }
+                        if (!penKnown || !cell.same_style(pen)) {
+                            append_sgr(cell);
+                            pen = cell;
+                            penKnown = true;
+                        }
+                        for (uint32_t g = cell.glyph; g != 0; g >>= 8) {
+                            out_ += static_cast<char>(g & 0xFF);
+                        }
+                    }
+                    cursorRow = r;
+                    cursorCol = end;
+                    c = end;
+                }
+            }
+            if (penKnown && !pen.same_style(Cell{})) {
+                out_ += "\033[0m";
+            }
+        }
+
+        static void write_all(const char* data, size_t size) {
+#ifdef _WIN32
+            fwrite(data, 1, size, stdout);
+            fflush(stdout);
+#else
+            while (size > 0) {
+                ssize_t n = ::write(STDOUT_FILENO, data, size);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    LOG_ERROR("ScreenBuffer: write failed (errno " + std::to_string(errno) + ")");
+                    return;
+                }
+                data += n;
+                size -= static_cast<size_t>(n);
+            }
+#endif
+        }
+
+        std::streambuf* passthrough_ = nullptr;
+        bool capturing_ = false;
+        bool fullRepaint_ = true;
+        int width_ = 0;
+        int height_ = 0;
+        std::vector<Cell> front_;
+        std::vector<Cell> back_;
+
+        ParseState state_ = ParseState::Text;
+        std::string params_;
+        int row_ = 0;
+        int col_ = 0;
+        Cell pen_;
+        int utf8Need_ = 0;
+        int utf8Len_ = 0;
+        uint32_t utf8Packed_ = 0;
+        uint32_t utf8Cp_ = 0;
+
+        std::string frameControls_;  // Bells and private-mode toggles seen mid-frame
+        std::string out_;            // Diff output, capacity reused between frames
+        std::string arena_;          // Pass-through output awaiting the next flush
+        size_t lastFrameBytes_ = 0;
+    };
+
+    ScreenBuffer& screen() {
+        static ScreenBuffer buffer;
+        return buffer;
+    }
+
+    // Headless mode: std::cout goes here and effects return immediately
+    class NullBuffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    bool g_headless = false;
+    bool g_skipDelays = false;      // Fast-forward replay: delay() returns at once
+    NullBuffer g_nullBuffer;
+    std::streambuf* g_headlessSaved = nullptr;
+
+    void emit(const char* s, size_t n) {
+        if (!g_headless) screen().put(s, n);
+    }
+    void emit(const char* s) { emit(s, std::strlen(s)); }
+    void emit(const std::string& s) { emit(s.data(), s.size()); }
+
+    // Builds one box edge ("left + fill*n + right") so it is emitted in one put
+    void emit_edge(const char* left, const char* fill, int count, const char* right) {
+        std::string line(left);
+        for (int i = 0; i < count; ++i) line += fill;
+        line += right;
+        emit(line);
+    }
+}
+
 namespace ui {
     bool init() {
+        // IMPROVED: std::cout no longer mirrors C stdio; the screen buffer owns output
+        std::ios::sync_with_stdio(false);
+        screen().install();
         std::cout << "\033[?25l";
         clear();
         return true;
     }
 
     void shutdown() {
+        screen().end_frame();
         reset_color();
         std::cout << "\033[?25h";
         std::cout.flush();
+        screen().uninstall();
+    }
+
+    void set_headless(bool enabled) {
+        if (enabled == g_headless) {
+            return;
+        }
+        g_headless = enabled;
+        if (enabled) {
+            g_headlessSaved = std::cout.rdbuf(&g_nullBuffer);
+        } else {
+            std::cout.rdbuf(g_headlessSaved);
+            g_headlessSaved = nullptr;
+        }
+    }
+
+    bool headless() {
+        return g_headless;
+    }
+
+    void delay(int ms) {
+        if (g_headless || g_skipDelays) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    void set_skip_delays(bool enabled) {
+        g_skipDelays = enabled;
+    }
+
+    bool delays_skipped() {
+        return g_skipDelays;
+    }
+
+    void begin_frame() {
+        screen().begin_frame();
+    }
+
+    void end_frame() {
+        screen().end_frame();
+    }
+
+    void invalidate_screen() {
+        screen().invalidate();
+    }
+
+    size_t last_frame_bytes() {
+        return screen().last_frame_bytes();
     }
 
     void clear() {
@@ -222,8 +877,8 @@ namespace ui {
                 return;
             }
         }
-        std::cout << "\033[2J\033[H";
-        std::cout.flush();
+        // IMPROVED: No flush here - the clear is submitted with whatever is drawn next
+        emit("\033[2J\033[H");
         
         // PHASE 3: Verify clear succeeded
         if (!std::cout.good()) {
@@ -233,19 +888,47 @@ namespace ui {
     }
 
     void move_cursor(int row, int col) {
-        std::cout << "\033[" << row << ";" << col << "H";
+        char seq[32];
+        int n = std::snprintf(seq, sizeof(seq), "\033[%d;%dH", row, col);
+        emit(seq, static_cast<size_t>(n));
     }
 
     void set_color(const std::string& code) {
         // Only output color if colors are enabled
         if (glyphs::use_color) {
-            std::cout << code;
+            emit(code);
         }
     }
 
     void reset_color() {
         if (glyphs::use_color) {
-            std::cout << constants::ansi_reset;
+            emit(constants::ansi_reset);
+        }
+    }
+
+    void put_glyph(const char* glyph, int fg) {
+        if (g_headless) {
+            return;
+        }
+        if (!glyphs::use_color) {
+            fg = -1;
+        }
+        if (screen().capturing()) {
+            screen().put_styled(glyph, static_cast<int16_t>(fg));
+            return;
+        }
+        if (fg < 0) {
+            emit(glyph);
+            return;
+        }
+        char seq[48];
+        int n = std::snprintf(seq, sizeof(seq), "\033[38;5;%dm%s\033[0m", fg, glyph);
+        if (n > 0 && static_cast<size_t>(n) < sizeof(seq)) {
+            emit(seq, static_cast<size_t>(n));
+        } else {
+            set_color("\033[38;5;" + std::to_string(fg) + "m");
+            emit(glyph);
+            reset_color();
         }
     }
 
@@ -254,13 +937,13 @@ namespace ui {
         std::string spaces(width, ' ');
         for (int r = 0; r < height; ++r) {
             move_cursor(startRow + r, startCol);
-            std::cout << spaces;
+            emit(spaces);
         }
     }
 
     void draw_text(int row, int col, const std::string& text) {
         move_cursor(row, col);
-        std::cout << text;
+        emit(text);
     }
 
     // Draw a double-line box frame (uses glyphs for Unicode/ASCII fallback)
@@ -269,23 +952,19 @@ namespace ui {
         
         // Top border
         move_cursor(row, col);
-        std::cout << glyphs::box_dbl_tl();
-        for (int i = 0; i < width - 2; ++i) std::cout << glyphs::box_dbl_h();
-        std::cout << glyphs::box_dbl_tr();
+        emit_edge(glyphs::box_dbl_tl(), glyphs::box_dbl_h(), width - 2, glyphs::box_dbl_tr());
         
         // Side borders
         for (int r = 1; r < height - 1; ++r) {
             move_cursor(row + r, col);
-            std::cout << glyphs::box_dbl_v();
+            emit(glyphs::box_dbl_v());
             move_cursor(row + r, col + width - 1);
-            std::cout << glyphs::box_dbl_v();
+            emit(glyphs::box_dbl_v());
         }
         
         // Bottom border
         move_cursor(row + height - 1, col);
-        std::cout << glyphs::box_dbl_bl();
-        for (int i = 0; i < width - 2; ++i) std::cout << glyphs::box_dbl_h();
-        std::cout << glyphs::box_dbl_br();
+        emit_edge(glyphs::box_dbl_bl(), glyphs::box_dbl_h(), width - 2, glyphs::box_dbl_br());
         
         reset_color();
     }
@@ -318,23 +997,19 @@ namespace ui {
         
         // Top border
         move_cursor(row, col);
-        std::cout << glyphs::box_sgl_tl();
-        for (int i = 0; i < width - 2; ++i) std::cout << glyphs::box_sgl_h();
-        std::cout << glyphs::box_sgl_tr();
+        emit_edge(glyphs::box_sgl_tl(), glyphs::box_sgl_h(), width - 2, glyphs::box_sgl_tr());
         
         // Side borders
         for (int r = 1; r < height - 1; ++r) {
             move_cursor(row + r, col);
-            std::cout << glyphs::box_sgl_v();
+            emit(glyphs::box_sgl_v());
             move_cursor(row + r, col + width - 1);
-            std::cout << glyphs::box_sgl_v();
+            emit(glyphs::box_sgl_v());
         }
         
         // Bottom border
         move_cursor(row + height - 1, col);
-        std::cout << glyphs::box_sgl_bl();
-        for (int i = 0; i < width - 2; ++i) std::cout << glyphs::box_sgl_h();
-        std::cout << glyphs::box_sgl_br();
+        emit_edge(glyphs::box_sgl_bl(), glyphs::box_sgl_h(), width - 2, glyphs::box_sgl_br());
         
         reset_color();
     }
@@ -342,9 +1017,7 @@ namespace ui {
     void draw_horizontal_line_double(int row, int col, int width, const std::string& color) {
         set_color(color);
         move_cursor(row, col);
-        std::cout << glyphs::box_dbl_lt();
-        for (int i = 0; i < width - 2; ++i) std::cout << glyphs::box_dbl_h();
-        std::cout << glyphs::box_dbl_rt();
+        emit_edge(glyphs::box_dbl_lt(), glyphs::box_dbl_h(), width - 2, glyphs::box_dbl_rt());
         reset_color();
     }
 
@@ -377,7 +1050,7 @@ namespace ui {
     }
 
     void draw_status_bar_framed(int row, int col, int width, const Player& player, int depth) {
-        LOG_OP_START("draw_status_bar_framed_internal");
+        PROF_ZONE("draw_status_bar_framed");
         
         // PHASE 3: Log parameters for debugging
         LOG_DEBUG("draw_status_bar_framed: row=" + std::to_string(row) + 
@@ -401,15 +1074,15 @@ namespace ui {
             std::cout.clear();
             if (!std::cout.good()) {
                 LOG_ERROR("draw_status_bar_framed: Failed to recover std::cout state - aborting");
-                LOG_OP_END("draw_status_bar_framed_internal");
                 return;
             }
         }
         
         // Draw frame
-        LOG_OP_START("draw_box_single_status");
-        draw_box_single(row, col, width, 3, constants::color_frame_status);
-        LOG_OP_END("draw_box_single_status");
+        {
+            PROF_ZONE("draw_box_single_status");
+            draw_box_single(row, col, width, 3, constants::color_frame_status);
+        }
         // PHASE 2: Removed intermediate flush - rely on main loop flush
         
         // PHASE 3: Check output stream health before title
@@ -419,118 +1092,120 @@ namespace ui {
         }
         
         // Draw title
-        LOG_OP_START("draw_status_title");
-        move_cursor(row, col + 2);
-        set_color(constants::color_frame_status);
-        std::cout << " Status ";
-        reset_color();
-        // PHASE 2: Removed intermediate flush
-        LOG_OP_END("draw_status_title");
+        {
+            PROF_ZONE("draw_status_title");
+            move_cursor(row, col + 2);
+            set_color(constants::color_frame_status);
+            std::cout << " Status ";
+            reset_color();
+            // PHASE 2: Removed intermediate flush
+        }
         
         // Draw status content
-        LOG_OP_START("draw_status_content");
-        move_cursor(row + 1, col + 2);
-        set_color(constants::ansi_bold);
-        set_color(constants::color_player);
-        std::cout << Player::class_name(player.player_class());
-        reset_color();
-        std::cout << " ";
-        set_color(constants::color_ui);
-        std::cout << "D:" << depth << "/10 ";
-        // PHASE 2: Removed intermediate flush
-        LOG_OP_END("draw_status_content");
+        {
+            PROF_ZONE("draw_status_content");
+            move_cursor(row + 1, col + 2);
+            set_color(constants::ansi_bold);
+            set_color(constants::color_player);
+            std::cout << Player::class_name(player.player_class());
+            reset_color();
+            std::cout << " ";
+            set_color(constants::color_ui);
+            std::cout << "D:" << depth << "/10 ";
+            // PHASE 2: Removed intermediate flush
+        }
         
         // HP with heart icon and color based on health
-        LOG_OP_START("draw_status_hp");
-        int hpPercent = (player.get_stats().maxHp > 0) ? 
-            (player.get_stats().hp * 100 / player.get_stats().maxHp) : 0;
-        if (hpPercent > 60) set_color("\033[38;5;46m");       // Green
-        else if (hpPercent > 30) set_color("\033[38;5;226m"); // Yellow
-        else set_color("\033[38;5;196m");                     // Red
-        std::cout << glyphs::stat_hp() << ":" << player.get_stats().hp << "/" << player.get_stats().maxHp;
-        reset_color();
-        // PHASE 2: Removed intermediate flush
-        LOG_OP_END("draw_status_hp");
+        {
+            PROF_ZONE("draw_status_hp");
+            int hpPercent = (player.get_stats().maxHp > 0) ? 
+                (player.get_stats().hp * 100 / player.get_stats().maxHp) : 0;
+            if (hpPercent > 60) set_color("\033[38;5;46m");       // Green
+            else if (hpPercent > 30) set_color("\033[38;5;226m"); // Yellow
+            else set_color("\033[38;5;196m");                     // Red
+            std::cout << glyphs::stat_hp() << ":" << player.get_stats().hp << "/" << player.get_stats().maxHp;
+            reset_color();
+            // PHASE 2: Removed intermediate flush
+        }
         
         // Mana system removed
         
         // Attack icon
-        LOG_OP_START("draw_status_stats");
-        std::cout << " " << glyphs::stat_attack() << ":" << player.get_stats().attack;
-        // Defense icon
-        std::cout << " " << glyphs::stat_defense() << ":" << player.get_stats().defense;
-        // Speed icon
-        std::cout << " " << glyphs::stat_speed() << ":" << player.get_stats().speed;
-        // PHASE 2: Removed intermediate flush
-        LOG_OP_END("draw_status_stats");
+        {
+            PROF_ZONE("draw_status_stats");
+            std::cout << " " << glyphs::stat_attack() << ":" << player.get_stats().attack;
+            // Defense icon
+            std::cout << " " << glyphs::stat_defense() << ":" << player.get_stats().defense;
+            // Speed icon
+            std::cout << " " << glyphs::stat_speed() << ":" << player.get_stats().speed;
+            // PHASE 2: Removed intermediate flush
+        }
         
         // Status effects with icons
-        LOG_OP_START("draw_status_effects");
-        if (!player.statuses().empty()) {
-            std::cout << " [";
-            bool first = true;
-            // PHASE 1: Add safety limit for status effects loop (max 20 statuses)
-            constexpr int MAX_STATUS_EFFECTS = 20;
-            int statusCount = 0;
-            for (const auto& s : player.statuses()) {
-                if (statusCount >= MAX_STATUS_EFFECTS) {
-                    LOG_WARN("draw_status_bar_framed: Too many status effects (" + 
-                             std::to_string(player.statuses().size()) + ") - truncating at " + 
-                             std::to_string(MAX_STATUS_EFFECTS));
-                    break;
-                }
-                statusCount++;
-                
-                if (!first) std::cout << " ";
-                first = false;
-                switch (s.type) {
-                    case StatusType::Bleed: 
-                        set_color(constants::color_status_bleed);
-                        std::cout << glyphs::status_bleed(); 
+        {
+            PROF_ZONE("draw_status_effects");
+            if (!player.statuses().empty()) {
+                std::cout << " [";
+                bool first = true;
+                // PHASE 1: Add safety limit for status effects loop (max 20 statuses)
+                constexpr int MAX_STATUS_EFFECTS = 20;
+                int statusCount = 0;
+                for (const auto& s : player.statuses()) {
+                    if (statusCount >= MAX_STATUS_EFFECTS) {
+                        LOG_WARN("draw_status_bar_framed: Too many status effects (" + 
+                                 std::to_string(player.statuses().size()) + ") - truncating at " + 
+                                 std::to_string(MAX_STATUS_EFFECTS));
                         break;
-                    case StatusType::Poison: 
-                        set_color(constants::color_status_poison);
-                        std::cout << glyphs::status_poison(); 
-                        break;
-                    case StatusType::Fortify: 
-                        set_color(constants::color_status_fortify);
-                        std::cout << glyphs::status_fortify(); 
-                        break;
-                    case StatusType::Haste: 
-                        set_color(constants::color_status_haste);
-                        std::cout << glyphs::status_haste(); 
-                        break;
-                    case StatusType::Burn:
-                        set_color(constants::color_status_burn);
-                        std::cout << glyphs::status_fire();
-                        break;
-                    case StatusType::Freeze:
-                        set_color(constants::color_status_freeze);
-                        std::cout << glyphs::status_ice();
-                        break;
-                    case StatusType::Stun:
-                        set_color(constants::color_status_stun);
-                        std::cout << glyphs::status_stun();
-                        break;
-                    default: break;
+                    }
+                    statusCount++;
+                
+                    if (!first) std::cout << " ";
+                    first = false;
+                    switch (s.type) {
+                        case StatusType::Bleed: 
+                            set_color(constants::color_status_bleed);
+                            std::cout << glyphs::status_bleed(); 
+                            break;
+                        case StatusType::Poison: 
+                            set_color(constants::color_status_poison);
+                            std::cout << glyphs::status_poison(); 
+                            break;
+                        case StatusType::Fortify: 
+                            set_color(constants::color_status_fortify);
+                            std::cout << glyphs::status_fortify(); 
+                            break;
+                        case StatusType::Haste: 
+                            set_color(constants::color_status_haste);
+                            std::cout << glyphs::status_haste(); 
+                            break;
+                        case StatusType::Burn:
+                            set_color(constants::color_status_burn);
+                            std::cout << glyphs::status_fire();
+                            break;
+                        case StatusType::Freeze:
+                            set_color(constants::color_status_freeze);
+                            std::cout << glyphs::status_ice();
+                            break;
+                        case StatusType::Stun:
+                            set_color(constants::color_status_stun);
+                            std::cout << glyphs::status_stun();
+                            break;
+                        default: break;
+                    }
+                    reset_color();
+                    std::cout << "(" << s.remainingTurns << ")";
                 }
-                reset_color();
-                std::cout << "(" << s.remainingTurns << ")";
+                std::cout << "]";
+                // PHASE 2: Removed intermediate flush
             }
-            std::cout << "]";
-            // PHASE 2: Removed intermediate flush
         }
-        LOG_OP_END("draw_status_effects");
         
-        // PHASE 2: Single flush at end of function (main loop also flushes, but this ensures completion)
-        // PHASE 3: Check output stream health before final flush
+        // IMPROVED: No flush - the status bar is submitted with the rest of the frame
         if (!std::cout.good()) {
-            LOG_WARN("draw_status_bar_framed: std::cout bad state before final flush - clearing");
+            LOG_WARN("draw_status_bar_framed: std::cout bad state - clearing");
             std::cout.clear();
         }
-        std::cout.flush();
         
-        LOG_OP_END("draw_status_bar_framed_internal");
     }
 
     void draw_inventory_items(int row, int col, int width, const Player& player, int selectedIndex, int maxItems, int scrollOffset, bool showStats, bool compact) {
@@ -1202,144 +1877,143 @@ namespace ui {
     // Visual Feedback Effects
     // ============================================
     
+    // IMPROVED: Flashes, bells and transitions queue their frames on the
+    // animation timeline (animation.h) instead of sleeping between them
     void flash_damage() {
+        if (g_headless) return;
         if (!glyphs::use_color) return;  // Skip if colors disabled
         
         // Flash red background briefly
-        std::cout << "\033[41m" << std::flush;  // Red background
-        std::this_thread::sleep_for(std::chrono::milliseconds(80));
-        std::cout << "\033[0m" << std::flush;   // Reset
+        anim::push([] { std::cout << "\033[41m" << std::flush; }, 80);  // Red background
+        anim::call([] { std::cout << "\033[0m" << std::flush; });      // Reset
     }
     
     void flash_heal() {
+        if (g_headless) return;
         if (!glyphs::use_color) return;
         
         // Flash green background briefly
-        std::cout << "\033[42m" << std::flush;  // Green background
-        std::this_thread::sleep_for(std::chrono::milliseconds(80));
-        std::cout << "\033[0m" << std::flush;
+        anim::push([] { std::cout << "\033[42m" << std::flush; }, 80);  // Green background
+        anim::call([] { std::cout << "\033[0m" << std::flush; });
     }
     
     void flash_critical() {
+        if (g_headless) return;
         if (!glyphs::use_color) return;
         
         // Flash yellow background briefly
-        std::cout << "\033[43m" << std::flush;  // Yellow background
-        std::this_thread::sleep_for(std::chrono::milliseconds(60));
-        std::cout << "\033[0m" << std::flush;
-        std::this_thread::sleep_for(std::chrono::milliseconds(40));
-        std::cout << "\033[43m" << std::flush;
-        std::this_thread::sleep_for(std::chrono::milliseconds(60));
-        std::cout << "\033[0m" << std::flush;
+        anim::push([] { std::cout << "\033[43m" << std::flush; }, 60);  // Yellow background
+        anim::push([] { std::cout << "\033[0m" << std::flush; }, 40);
+        anim::push([] { std::cout << "\033[43m" << std::flush; }, 60);
+        anim::call([] { std::cout << "\033[0m" << std::flush; });
     }
     
     void flash_warning() {
+        if (g_headless) return;
         if (!glyphs::use_color) return;
         
         // Flash orange/yellow background for warnings (telegraphed attacks)
-        std::cout << "\033[43m" << std::flush;  // Yellow background
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        std::cout << "\033[0m" << std::flush;
+        anim::push([] { std::cout << "\033[43m" << std::flush; }, 100);  // Yellow background
+        anim::call([] { std::cout << "\033[0m" << std::flush; });
     }
     
     // ============================================
     // Sound Effects (Terminal Bell)
     // ============================================
     
+    static void ring_bell() {
+        std::cout << '\a' << std::flush;
+    }
+    
     void play_hit_sound() {
-        std::cout << '\a' << std::flush;  // Single bell
+        if (g_headless) return;
+        anim::call(ring_bell);  // Single bell
     }
     
     void play_critical_sound() {
-        std::cout << '\a' << std::flush;
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        std::cout << '\a' << std::flush;
+        if (g_headless) return;
+        anim::push(ring_bell, 100);
+        anim::call(ring_bell);
     }
     
     void play_death_sound() {
+        if (g_headless) return;
         // Slow, mournful pattern
         for (int i = 0; i < 3; i++) {
-            std::cout << '\a' << std::flush;
-            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            anim::push(ring_bell, 300);
         }
     }
     
     void play_victory_sound() {
+        if (g_headless) return;
         // Triumphant ascending pattern
         for (int i = 0; i < 5; i++) {
-            std::cout << '\a' << std::flush;
-            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            anim::push(ring_bell, 150);
         }
     }
     
     void play_level_up_sound() {
+        if (g_headless) return;
         // Quick double bell
-        std::cout << '\a' << std::flush;
-        std::this_thread::sleep_for(std::chrono::milliseconds(80));
-        std::cout << '\a' << std::flush;
+        anim::push(ring_bell, 80);
+        anim::call(ring_bell);
     }
     
     // ============================================
     // Screen Transitions
     // ============================================
     
-    void wipe_transition_down(int steps) {
-        auto termSize = input::get_terminal_size();
-        int h = termSize.height;
-        int w = termSize.width;
-        
-        std::string blankLine(w, ' ');
-        int rowsPerStep = h / steps;
-        
-        for (int s = 0; s < steps; s++) {
+    // One wipe step: blank rowsPerStep rows starting at band * rowsPerStep
+    static void queue_wipe_band(int band, int rowsPerStep, int height, int width) {
+        anim::push([band, rowsPerStep, height, width] {
+            std::string blankLine(width, ' ');
             for (int y = 0; y < rowsPerStep; y++) {
-                int row = s * rowsPerStep + y;
-                if (row < h) {
+                int row = band * rowsPerStep + y;
+                if (row < height) {
                     move_cursor(row + 1, 1);
                     std::cout << blankLine;
                 }
             }
             std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(90));
+        }, 90);
+    }
+    
+    void wipe_transition_down(int steps) {
+        if (g_headless) return;
+        auto termSize = input::get_terminal_size();
+        int rowsPerStep = termSize.height / steps;
+        
+        for (int s = 0; s < steps; s++) {
+            queue_wipe_band(s, rowsPerStep, termSize.height, termSize.width);
         }
     }
     
     void wipe_transition_up(int steps) {
+        if (g_headless) return;
         auto termSize = input::get_terminal_size();
-        int h = termSize.height;
-        int w = termSize.width;
-        
-        std::string blankLine(w, ' ');
-        int rowsPerStep = h / steps;
+        int rowsPerStep = termSize.height / steps;
         
         for (int s = steps - 1; s >= 0; s--) {
-            for (int y = 0; y < rowsPerStep; y++) {
-                int row = s * rowsPerStep + y;
-                if (row < h) {
-                    move_cursor(row + 1, 1);
-                    std::cout << blankLine;
-                }
-            }
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(90));
+            queue_wipe_band(s, rowsPerStep, termSize.height, termSize.width);
         }
     }
     
     void fade_transition(int steps) {
+        if (g_headless) return;
         // Simulate fade by progressively dimming colors
         if (!glyphs::use_color) {
-            clear();
+            anim::call([] { clear(); });
             return;
         }
         
         // Use ANSI dim attribute for fade effect
         for (int s = 0; s < steps; s++) {
-            std::cout << "\033[2m";  // Dim
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            anim::push([] { std::cout << "\033[2m" << std::flush; }, 100);  // Dim
         }
-        clear();
-        std::cout << "\033[0m";  // Reset
+        anim::call([] {
+            clear();
+            std::cout << "\033[0m";  // Reset
+        });
     }
 
     // ============================================
@@ -1379,6 +2053,7 @@ namespace ui {
     
     // Helper: Add damage number to display (implementation)
     void add_damage_number(int damage, int spriteRow, int spriteCol, bool isPlayer, bool isCritical) {
+        if (g_headless) return;
         // Center the damage number above the sprite
         int displayCol = spriteCol + 8; // Approximate center of sprite
         damageNumbers.emplace_back(damage, spriteRow - 1, displayCol, isPlayer, isCritical);
@@ -1467,167 +2142,138 @@ namespace ui {
         }
     }
     
-    // Helper: Load sprite from file with fallback
-    static std::string load_sprite_from_file(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            return ""; // File not found
-        }
-        
-        std::string sprite;
-        std::string line;
-        bool firstLine = true;
-        while (std::getline(file, line)) {
-            if (!firstLine) {
-                sprite += "\n";
-            }
-            sprite += line;
-            firstLine = false;
+    // Helper: Sprite with its size measured once, for art that is not in the registry
+    static assets::Sprite make_sprite(std::string_view text) {
+        auto dims = assets::measure(text);
+        return assets::Sprite{text, dims.first, dims.second};
+    }
+    
+    // Helper: Asset name of a player class's combat sprite, or nullptr if it has none
+    static const char* player_sprite_name(PlayerClass pclass) {
+        switch (pclass) {
+            case PlayerClass::Warrior: return "combat/warrior";
+            case PlayerClass::Rogue: return "combat/rogue";
+            case PlayerClass::Mage: return "combat/mage";
+            default: return nullptr;
         }
-        return sprite;
     }
     
-    // Helper: Get sprite for player class (loads from file, falls back to hardcoded)
-    std::string get_player_sprite(PlayerClass pclass) {
-        std::string sprite;
-        
-        // Try to load from file first
+    // Helper: Get sprite for player class (from the asset registry, falls back to hardcoded)
+    const assets::Sprite& get_player_sprite(PlayerClass pclass) {
+        // Try the loaded asset first
+        if (const char* name = player_sprite_name(pclass)) {
+            const assets::Sprite* sprite = assets::find(name);
+            if (sprite && !sprite->text.empty()) return *sprite;
+        }
+        
+        // Fallback to hardcoded
+        static const assets::Sprite warrior = make_sprite(
+            "  /\\\n"
+            " |  |\n"
+            " |__|\n"
+            " ||||\n"
+            "  ||");
+        static const assets::Sprite rogue = make_sprite(
+            "   /\\\n"
+            "  |  |\n"
+            "  |__|\n"
+            "  ||\n"
+            "  ||");
+        static const assets::Sprite mage = make_sprite(
+            "  /\\\n"
+            " |  |\n"
+            " |__|\n"
+            "  ||\n"
+            "  *");
+        static const assets::Sprite generic = make_sprite(
+            "  @\n"
+            " /|\\\n"
+            " / \\");
         switch (pclass) {
-            case PlayerClass::Warrior:
-                sprite = load_sprite_from_file("assets/ascii/combat/warrior.txt");
-                if (!sprite.empty()) return sprite;
-                // Fallback to hardcoded
-                return "  /\\\n"
-                       " |  |\n"
-                       " |__|\n"
-                       " ||||\n"
-                       "  ||";
-            case PlayerClass::Rogue:
-                sprite = load_sprite_from_file("assets/ascii/combat/rogue.txt");
-                if (!sprite.empty()) return sprite;
-                // Fallback to hardcoded
-                return "   /\\\n"
-                       "  |  |\n"
-                       "  |__|\n"
-                       "  ||\n"
-                       "  ||";
-            case PlayerClass::Mage:
-                sprite = load_sprite_from_file("assets/ascii/combat/mage.txt");
-                if (!sprite.empty()) return sprite;
-                // Fallback to hardcoded
-                return "  /\\\n"
-                       " |  |\n"
-                       " |__|\n"
-                       "  ||\n"
-                       "  *";
-            default:
-                return "  @\n"
-                       " /|\\\n"
-                       " / \\";
+            case PlayerClass::Warrior: return warrior;
+            case PlayerClass::Rogue: return rogue;
+            case PlayerClass::Mage: return mage;
+            default: return generic;
         }
     }
     
-    // Helper: Get sprite for enemy type (loads from file, falls back to glyph-based)
-    std::string get_enemy_sprite(const Enemy& enemy) {
-        // Try to load enemy sprites from file
-        EnemyType etype = enemy.enemy_type();
-        std::string sprite;
-        
+    // Helper: Asset name of an enemy type's combat sprite, or nullptr if it has none
+    static const char* enemy_sprite_name(EnemyType etype) {
         switch (etype) {
-            case EnemyType::Rat:
-                sprite = load_sprite_from_file("assets/ascii/combat/rat.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Spider:
-                sprite = load_sprite_from_file("assets/ascii/combat/spider.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Goblin:
-                sprite = load_sprite_from_file("assets/ascii/combat/goblin.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Kobold:
-                sprite = load_sprite_from_file("assets/ascii/combat/kobold.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Orc:
-                sprite = load_sprite_from_file("assets/ascii/combat/orc.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Zombie:
-                sprite = load_sprite_from_file("assets/ascii/combat/zombie.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Archer:
-                sprite = load_sprite_from_file("assets/ascii/combat/archer.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Gnome:
-                sprite = load_sprite_from_file("assets/ascii/combat/gnome.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Ogre:
-                sprite = load_sprite_from_file("assets/ascii/combat/ogre.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Troll:
-                sprite = load_sprite_from_file("assets/ascii/combat/troll.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Dragon:
-                sprite = load_sprite_from_file("assets/ascii/combat/dragon.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::Lich:
-                sprite = load_sprite_from_file("assets/ascii/combat/skeleton.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::StoneGolem:
-                sprite = load_sprite_from_file("assets/ascii/combat/stonegolem.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::ShadowLord:
-                sprite = load_sprite_from_file("assets/ascii/combat/shadowlord.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            case EnemyType::CorpseEnemy:
-                sprite = load_sprite_from_file("assets/ascii/combat/corpse.txt");
-                if (!sprite.empty()) return sprite;
-                break;
-            default:
-                break;
+            case EnemyType::Rat: return "combat/rat";
+            case EnemyType::Spider: return "combat/spider";
+            case EnemyType::Goblin: return "combat/goblin";
+            case EnemyType::Kobold: return "combat/kobold";
+            case EnemyType::Orc: return "combat/orc";
+            case EnemyType::Zombie: return "combat/zombie";
+            case EnemyType::Archer: return "combat/archer";
+            case EnemyType::Gnome: return "combat/gnome";
+            case EnemyType::Ogre: return "combat/ogre";
+            case EnemyType::Troll: return "combat/troll";
+            case EnemyType::Dragon: return "combat/dragon";
+            case EnemyType::Lich: return "combat/skeleton";
+            case EnemyType::StoneGolem: return "combat/stonegolem";
+            case EnemyType::ShadowLord: return "combat/shadowlord";
+            case EnemyType::CorpseEnemy: return "combat/corpse";
+            default: return nullptr;
+        }
+    }
+    
+    // Helper: Get sprite for enemy type (from the asset registry, falls back to glyph-based)
+    const assets::Sprite& get_enemy_sprite(const Enemy& enemy) {
+        // Try the loaded enemy asset first
+        if (const char* name = enemy_sprite_name(enemy.enemy_type())) {
+            const assets::Sprite* sprite = assets::find(name);
+            if (sprite && !sprite->text.empty()) return *sprite;
         }
         
         // Fallback to glyph-based sprite
+        static const assets::Sprite large = make_sprite(
+            "  /\\\n"
+            " |  |\n"
+            " |__|\n"
+            " ||||\n"
+            "  ||");
         char glyph = enemy.glyph();
         switch (glyph) {
             case 'D': // Dragon
             case 'O': // Ogre
             case 'T': // Troll
-                sprite = "  /\\\n"
-                         " |  |\n"
-                         " |__|\n"
-                         " ||||\n"
-                         "  ||";
-                break;
-            default:
-                // Generic enemy sprite
-                sprite = "  " + std::string(1, glyph) + "\n"
-                         " /|\\\n"
-                         " / \\";
+                return large;
+            default: {
+                // Generic enemy sprite, built once per glyph (map nodes keep the text in place)
+                static std::map<char, std::pair<std::string, assets::Sprite>> generic;
+                auto it = generic.find(glyph);
+                if (it == generic.end()) {
+                    it = generic.emplace(glyph, std::make_pair("  " + std::string(1, glyph) + "\n"
+                                                               " /|\\\n"
+                                                               " / \\", assets::Sprite{})).first;
+                    it->second.second = make_sprite(it->second.first);
+                }
+                return it->second.second;
+            }
         }
-        return sprite;
     }
     
-    void draw_combat_sprite(int row, int col, const std::string& sprite, const std::string& color) {
-        std::istringstream iss(sprite);
-        std::string line;
+    // Helper: Call fn for each line of text, split the way std::getline splits it
+    template <typename Fn>
+    static void for_each_line(std::string_view text, Fn fn) {
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) end = text.size();
+            fn(text.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+    
+    void draw_combat_sprite(int row, int col, std::string_view sprite, const std::string& color) {
         int currentRow = row;
         set_color(color);
-        while (std::getline(iss, line)) {
+        for_each_line(sprite, [&](std::string_view line) {
             move_cursor(currentRow++, col);
             std::cout << line;
-        }
+        });
         reset_color();
     }
     
@@ -1766,30 +2412,26 @@ namespace ui {
         int enemySpriteCol = startCol + (width * 2 / 3);  // ~67% from left
         
         // Get sprites
-        std::string playerSprite = get_player_sprite(player.player_class());
-        std::string enemySprite = get_enemy_sprite(enemy);
-        
-        // Calculate sprite dimensions
-        auto playerDims = calculate_sprite_dimensions(playerSprite);
-        auto enemyDims = calculate_sprite_dimensions(enemySprite);
+        const assets::Sprite& playerSprite = get_player_sprite(player.player_class());
+        const assets::Sprite& enemySprite = get_enemy_sprite(enemy);
         
         // Position player sprite from bottom of viewport (accounting for frame border)
         // Leave some space from bottom (2 rows for frame + 1 row padding)
-        int playerSpriteRow = startRow + height - playerDims.first - 3;
+        int playerSpriteRow = startRow + height - playerSprite.height - 3;
         
         // Position enemy sprite from top of viewport (accounting for frame border)
         // Leave space for title (1 row) + 1 row padding
         int enemySpriteRow = startRow + 2;
         
         // Draw player sprite
-        draw_combat_sprite(playerSpriteRow, playerSpriteCol, playerSprite, constants::color_player);
+        draw_combat_sprite(playerSpriteRow, playerSpriteCol, playerSprite.text, constants::color_player);
         
         // Draw enemy sprite
         std::string enemyColor = enemy.color();
         if (enemyColor.empty()) {
             enemyColor = "\033[91m"; // Default red
         }
-        draw_combat_sprite(enemySpriteRow, enemySpriteCol, enemySprite, enemyColor);
+        draw_combat_sprite(enemySpriteRow, enemySpriteCol, enemySprite.text, enemyColor);
         
         // Draw damage numbers (only visual feedback, HP/status moved to bottom right)
         draw_damage_numbers(startRow, startCol);
@@ -1797,8 +2439,29 @@ namespace ui {
         // Note: HP bars and status effects are now drawn in bottom right (below arena)
     }
     
-    void animate_sprite_attack(int startRow, int startCol, const std::string& sprite,
+    // Blank the cells a sprite drawn at (row, col) covers, plus a two-column margin
+    static void erase_sprite(int row, int col, std::string_view sprite) {
+        for_each_line(sprite, [&](std::string_view line) {
+            move_cursor(row++, col);
+            std::cout << std::string(line.length() + 2, ' ');
+        });
+    }
+    
+    // Queue one frame that moves a sprite from (fromRow, fromCol) to (toRow, toCol)
+    static void queue_sprite_move(int fromRow, int fromCol, int toRow, int toCol,
+                                  std::string_view sprite, const std::string& color, int holdMs) {
+        anim::push([=] {
+            erase_sprite(fromRow, fromCol, sprite);
+            draw_combat_sprite(toRow, toCol, sprite, color);
+            std::cout.flush();
+        }, holdMs);
+    }
+    
+    // IMPROVED: Sprite animations precompute their frames and queue them on the
+    // animation timeline; the caller carries on without waiting for them
+    void animate_sprite_attack(int startRow, int startCol, std::string_view sprite,
                                const std::string& color, bool isPlayer) {
+        if (g_headless) return;
         const int frames = 3;
         const int frameDelay = 100; // milliseconds
         
@@ -1807,99 +2470,38 @@ namespace ui {
         
         // Slide forward
         for (int i = 0; i < frames; ++i) {
-            // Clear previous position
-            std::istringstream iss(sprite);
-            std::string line;
-            int row = startRow;
-            while (std::getline(iss, line)) {
-                move_cursor(row++, currentCol);
-                for (size_t j = 0; j < line.length() + 2; ++j) {
-                    std::cout << " ";
-                }
-            }
-            
+            queue_sprite_move(startRow, currentCol, startRow, currentCol + step, sprite, color, frameDelay);
             currentCol += step;
-            draw_combat_sprite(startRow, currentCol, sprite, color);
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
         }
         
         // Return to original position
         for (int i = 0; i < frames; ++i) {
-            std::istringstream iss(sprite);
-            std::string line;
-            int row = startRow;
-            while (std::getline(iss, line)) {
-                move_cursor(row++, currentCol);
-                for (size_t j = 0; j < line.length() + 2; ++j) {
-                    std::cout << " ";
-                }
-            }
-            
+            queue_sprite_move(startRow, currentCol, startRow, currentCol - step, sprite, color, frameDelay);
             currentCol -= step;
-            draw_combat_sprite(startRow, currentCol, sprite, color);
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
         }
     }
     
-    void animate_sprite_shake(int baseRow, int baseCol, const std::string& sprite,
+    void animate_sprite_shake(int baseRow, int baseCol, std::string_view sprite,
                               const std::string& color, int intensity, int duration) {
+        if (g_headless) return;
         const int shakeFrames = duration / 50; // 50ms per frame
         std::mt19937 rng(std::random_device{}());
         std::uniform_int_distribution<int> offsetDist(-intensity, intensity);
         
+        // Each frame clears the sprite at its base position and draws it at a random offset
         for (int i = 0; i < shakeFrames; ++i) {
-            // Clear sprite
-            std::istringstream iss(sprite);
-            std::string line;
-            int row = baseRow;
-            while (std::getline(iss, line)) {
-                move_cursor(row++, baseCol);
-                for (size_t j = 0; j < line.length() + 2; ++j) {
-                    std::cout << " ";
-                }
-            }
-            
-            // Draw at offset position
             int offsetCol = baseCol + offsetDist(rng);
             int offsetRow = baseRow + offsetDist(rng);
-            draw_combat_sprite(offsetRow, offsetCol, sprite, color);
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            queue_sprite_move(baseRow, baseCol, offsetRow, offsetCol, sprite, color, 50);
         }
         
         // Return to base position
-        std::istringstream iss(sprite);
-        std::string line;
-        int row = baseRow;
-        while (std::getline(iss, line)) {
-            move_cursor(row++, baseCol);
-            for (size_t j = 0; j < line.length() + 2; ++j) {
-                std::cout << " ";
-            }
-        }
-        draw_combat_sprite(baseRow, baseCol, sprite, color);
-        std::cout.flush();
-    }
-    
-    std::pair<int, int> calculate_sprite_dimensions(const std::string& sprite) {
-        std::istringstream iss(sprite);
-        std::string line;
-        int height = 0;
-        int maxWidth = 0;
-        while (std::getline(iss, line)) {
-            height++;
-            int lineWidth = static_cast<int>(line.length());
-            if (lineWidth > maxWidth) {
-                maxWidth = lineWidth;
-            }
-        }
-        return std::make_pair(height, maxWidth);
+        queue_sprite_move(baseRow, baseCol, baseRow, baseCol, sprite, color, 0);
     }
     
     void animate_projectile(int fromRow, int fromCol, int toRow, int toCol,
                            const std::string& projectile, const std::string& color) {
+        if (g_headless) return;
         const int steps = 15;
         const int frameDelay = 30; // milliseconds
         
@@ -1909,202 +2511,141 @@ namespace ui {
         int colStep = (toCol - fromCol) / steps;
         
         for (int i = 0; i < steps; ++i) {
-            // Clear previous position
-            move_cursor(currentRow, currentCol);
-            std::cout << " ";
-            
+            int prevRow = currentRow;
+            int prevCol = currentCol;
             currentRow += rowStep;
             currentCol += colStep;
             
-            // Draw projectile
-            move_cursor(currentRow, currentCol);
-            set_color(color);
-            std::cout << projectile;
-            reset_color();
-            std::cout.flush();
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
+            anim::push([=] {
+                // Clear previous position
+                move_cursor(prevRow, prevCol);
+                std::cout << " ";
+                
+                // Draw projectile
+                move_cursor(currentRow, currentCol);
+                set_color(color);
+                std::cout << projectile;
+                reset_color();
+                std::cout.flush();
+            }, frameDelay);
         }
         
         // Clear final position
-        move_cursor(currentRow, currentCol);
-        std::cout << " ";
-        std::cout.flush();
+        anim::call([=] {
+            move_cursor(currentRow, currentCol);
+            std::cout << " ";
+            std::cout.flush();
+        });
     }
     
     void animate_explosion(int row, int col, const std::string& color) {
-        const std::vector<std::string> explosionFrames = {
+        if (g_headless) return;
+        static const std::vector<std::string> explosionFrames = {
             " * ",
             "***",
             " * ",
             " * "
         };
         
-        set_color(color);
+        auto clearArea = [row, col] {
+            move_cursor(row - 1, col - 1);
+            std::cout << "   ";
+            move_cursor(row, col - 1);
+            std::cout << "   ";
+            move_cursor(row + 1, col - 1);
+            std::cout << "   ";
+        };
+        
         for (size_t i = 0; i < explosionFrames.size(); ++i) {
-            // Clear previous frame
-            if (i > 0) {
+            anim::push([=] {
+                // Clear previous frame
+                if (i > 0) {
+                    clearArea();
+                }
+                
+                // Draw explosion frame
+                set_color(color);
                 move_cursor(row - 1, col - 1);
-                std::cout << "   ";
-                move_cursor(row, col - 1);
-                std::cout << "   ";
-                move_cursor(row + 1, col - 1);
-                std::cout << "   ";
-            }
-            
-            // Draw explosion frame
-            move_cursor(row - 1, col - 1);
-            std::cout << explosionFrames[i];
-            std::cout.flush();
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(80));
+                std::cout << explosionFrames[i];
+                reset_color();
+                std::cout.flush();
+            }, 80);
         }
-        reset_color();
         
         // Clear explosion
-        move_cursor(row - 1, col - 1);
-        std::cout << "   ";
-        move_cursor(row, col - 1);
-        std::cout << "   ";
-        move_cursor(row + 1, col - 1);
-        std::cout << "   ";
-        std::cout.flush();
+        anim::call([=] {
+            clearArea();
+            std::cout.flush();
+        });
+    }
+    
+    // Queue frames sliding a sprite from startCol toward targetCol (at most
+    // `frames` steps of `step` columns). Returns the column it ends on.
+    static int queue_sprite_slide(int row, int startCol, int targetCol, int step, int frames,
+                                  std::string_view sprite, const std::string& color, int frameDelay) {
+        int currentCol = startCol;
+        for (int i = 0; i < frames; ++i) {
+            int nextCol = currentCol + step;
+            if ((step > 0 && nextCol >= targetCol) || (step < 0 && nextCol <= targetCol)) {
+                nextCol = targetCol;
+            }
+            queue_sprite_move(row, currentCol, row, nextCol, sprite, color, frameDelay);
+            currentCol = nextCol;
+            
+            if (currentCol == targetCol) break;
+        }
+        return currentCol;
     }
     
     void animate_rogue_slide(int startRow, int startCol, int targetCol,
-                            const std::string& sprite, const std::string& color) {
+                            std::string_view sprite, const std::string& color) {
+        if (g_headless) return;
         const int frames = 8;
         const int frameDelay = 60; // milliseconds
         
-        int currentCol = startCol;
         int step = (targetCol - startCol) / frames;
         if (step == 0) step = (targetCol > startCol) ? 1 : -1;
         
         // Slide forward to target
-        for (int i = 0; i < frames; ++i) {
-            // Clear previous position
-            std::istringstream iss(sprite);
-            std::string line;
-            int row = startRow;
-            while (std::getline(iss, line)) {
-                move_cursor(row++, currentCol);
-                for (size_t j = 0; j < line.length() + 2; ++j) {
-                    std::cout << " ";
-                }
-            }
-            
-            currentCol += step;
-            if ((step > 0 && currentCol >= targetCol) || (step < 0 && currentCol <= targetCol)) {
-                currentCol = targetCol;
-            }
-            
-            draw_combat_sprite(startRow, currentCol, sprite, color);
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
-            
-            if (currentCol == targetCol) break;
-        }
+        int currentCol = queue_sprite_slide(startRow, startCol, targetCol, step, frames, sprite, color, frameDelay);
         
         // Brief pause at target
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        anim::pause(100);
         
         // Slide back to original position
-        for (int i = 0; i < frames; ++i) {
-            // Clear previous position
-            std::istringstream iss(sprite);
-            std::string line;
-            int row = startRow;
-            while (std::getline(iss, line)) {
-                move_cursor(row++, currentCol);
-                for (size_t j = 0; j < line.length() + 2; ++j) {
-                    std::cout << " ";
-                }
-            }
-            
-            currentCol -= step;
-            if ((step > 0 && currentCol <= startCol) || (step < 0 && currentCol >= startCol)) {
-                currentCol = startCol;
-            }
-            
-            draw_combat_sprite(startRow, currentCol, sprite, color);
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
-            
-            if (currentCol == startCol) break;
-        }
+        queue_sprite_slide(startRow, currentCol, startCol, -step, frames, sprite, color, frameDelay);
     }
     
     void animate_warrior_charge(int startRow, int startCol, int targetCol,
-                               const std::string& sprite, const std::string& color) {
+                               std::string_view sprite, const std::string& color) {
+        if (g_headless) return;
         const int frames = 6;
         const int frameDelay = 70; // milliseconds
         
-        int currentCol = startCol;
         int step = (targetCol - startCol) / frames;
         if (step == 0) step = (targetCol > startCol) ? 1 : -1;
         
         // Charge forward to target
-        for (int i = 0; i < frames; ++i) {
-            // Clear previous position
-            std::istringstream iss(sprite);
-            std::string line;
-            int row = startRow;
-            while (std::getline(iss, line)) {
-                move_cursor(row++, currentCol);
-                for (size_t j = 0; j < line.length() + 2; ++j) {
-                    std::cout << " ";
-                }
-            }
-            
-            currentCol += step;
-            if ((step > 0 && currentCol >= targetCol) || (step < 0 && currentCol <= targetCol)) {
-                currentCol = targetCol;
-            }
-            
-            draw_combat_sprite(startRow, currentCol, sprite, color);
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
-            
-            if (currentCol == targetCol) break;
-        }
+        int currentCol = queue_sprite_slide(startRow, startCol, targetCol, step, frames, sprite, color, frameDelay);
         
         // Weapon slash effect at target
-        move_cursor(startRow, targetCol + 10);
-        set_color("\033[93m"); // Yellow for slash
-        std::cout << "╲╱";
-        reset_color();
-        std::cout.flush();
-        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        anim::push([=] {
+            move_cursor(startRow, targetCol + 10);
+            set_color("\033[93m"); // Yellow for slash
+            std::cout << "╲╱";
+            reset_color();
+            std::cout.flush();
+        }, 150);
         
         // Clear slash
-        move_cursor(startRow, targetCol + 10);
-        std::cout << "  ";
-        std::cout.flush();
+        anim::call([=] {
+            move_cursor(startRow, targetCol + 10);
+            std::cout << "  ";
+            std::cout.flush();
+        });
         
         // Charge back to original position
-        for (int i = 0; i < frames; ++i) {
-            // Clear previous position
-            std::istringstream iss(sprite);
-            std::string line;
-            int row = startRow;
-            while (std::getline(iss, line)) {
-                move_cursor(row++, currentCol);
-                for (size_t j = 0; j < line.length() + 2; ++j) {
-                    std::cout << " ";
-                }
-            }
-            
-            currentCol -= step;
-            if ((step > 0 && currentCol <= startCol) || (step < 0 && currentCol >= startCol)) {
-                currentCol = startCol;
-            }
-            
-            draw_combat_sprite(startRow, currentCol, sprite, color);
-            std::cout.flush();
-            std::this_thread::sleep_for(std::chrono::milliseconds(frameDelay));
-            
-            if (currentCol == startCol) break;
-        }
+        queue_sprite_slide(startRow, currentCol, startCol, -step, frames, sprite, color, frameDelay);
     }
 }
 
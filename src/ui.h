@@ -1,12 +1,14 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
 #include <thread>
 #include "types.h"
 #include "constants.h"
 #include "glyphs.h"
+#include "assets.h"
 
 // Forward declarations
 class Player;
@@ -92,9 +94,65 @@ namespace ui {
     /** @brief Shutdown and cleanup the UI system. */
     void shutdown();
 
-    /** @brief Clear the terminal screen. */
+    /** @brief Clear the terminal screen (queued with the next output, not flushed). */
     void clear();
 
+    /**
+     * @brief Switch headless mode (batch simulation without a terminal).
+     *
+     * While enabled, std::cout output is discarded and flashes, sounds,
+     * transitions and animations are dropped.
+     * @param enabled True to enter headless mode, false to restore output.
+     */
+    void set_headless(bool enabled);
+
+    /** @brief Whether headless mode is active. */
+    bool headless();
+
+    /**
+     * @brief Wait out a pacing delay (idle input polling).
+     *
+     * Animations do not sleep; they queue frames on the animation timeline
+     * (animation.h).
+     * Returns immediately in headless mode or while delays are skipped.
+     * @param ms Delay in milliseconds.
+     */
+    void delay(int ms);
+
+    /**
+     * @brief Skip every delay() (fast-forward replay playback).
+     * @param enabled True to skip delays, false to wait them out again.
+     */
+    void set_skip_delays(bool enabled);
+
+    /** @brief Whether delays are being skipped. */
+    bool delays_skipped();
+
+    /**
+     * @brief Start a buffered frame.
+     *
+     * Until end_frame(), output written to std::cout is drawn into an off-screen
+     * cell buffer instead of the terminal, and flushes are ignored. Output
+     * written outside a frame is queued and submitted in one write on the next
+     * flush, end_frame(), or blocking key read.
+     */
+    void begin_frame();
+
+    /**
+     * @brief Finish the frame: emit only the cells that differ from the previous
+     * frame, in a single write.
+     */
+    void end_frame();
+
+    /** @brief Force the next end_frame() to repaint the whole screen. */
+    void invalidate_screen();
+
+    /**
+     * @brief Get the number of bytes the last end_frame() sent to the terminal.
+     * @return Byte count
+     */
+    size_t last_frame_bytes();
+
     /**
      * @brief Move the cursor to a specific row and column.
      * @param row Row to move to.
@@ -111,6 +169,16 @@ namespace ui {
     /** @brief Reset terminal color to default. */
     void reset_color();
 
+    /**
+     * @brief Write a glyph at the cursor in a 256-colour palette index.
+     *
+     * Inside a frame the glyph goes straight into the cell buffer without
+     * building or parsing an ANSI string; the colour does not persist.
+     * @param glyph UTF-8 glyph string (usually one glyph).
+     * @param fg Palette index 0-255, or -1 for the terminal default.
+     */
+    void put_glyph(const char* glyph, int fg);
+
     /**
      * @brief Fill a rectangular area with spaces.
      * @param startRow Starting row.
@@ -297,10 +365,10 @@ namespace ui {
      * @brief Draw a combat sprite at specified position.
      * @param row Starting row.
      * @param col Starting column.
-     * @param sprite Multi-line sprite string.
+     * @param sprite Multi-line sprite text.
      * @param color Color code for sprite.
      */
-    void draw_combat_sprite(int row, int col, const std::string& sprite, const std::string& color);
+    void draw_combat_sprite(int row, int col, std::string_view sprite, const std::string& color);
 
     /**
      * @brief Draw HP bars in Pokemon style.
@@ -321,49 +389,43 @@ namespace ui {
     void draw_combat_status_info(int row, int col, const Player& player, const Enemy& enemy);
 
     /**
-     * @brief Get sprite string for player class.
+     * @brief Get sprite for player class.
      * @param pclass Player class.
-     * @return Sprite string (multi-line).
+     * @return Sprite with its text and size, valid for the rest of the run.
      */
-    std::string get_player_sprite(PlayerClass pclass);
+    const assets::Sprite& get_player_sprite(PlayerClass pclass);
 
     /**
-     * @brief Get sprite string for enemy.
+     * @brief Get sprite for enemy.
      * @param enemy Enemy reference.
-     * @return Sprite string (multi-line).
+     * @return Sprite with its text and size, valid for the rest of the run.
      */
-    std::string get_enemy_sprite(const Enemy& enemy);
+    const assets::Sprite& get_enemy_sprite(const Enemy& enemy);
 
     /**
      * @brief Animate sprite attack (slide animation).
      * @param startRow Starting row.
      * @param startCol Starting column.
-     * @param sprite Sprite string to animate.
+     * @param sprite Sprite text to animate; must outlive the queued frames
+     *        (get_player_sprite / get_enemy_sprite text does).
      * @param color Color code.
      * @param isPlayer True if player attacking (slides right), false if enemy (slides left).
      */
-    void animate_sprite_attack(int startRow, int startCol, const std::string& sprite, 
+    void animate_sprite_attack(int startRow, int startCol, std::string_view sprite,
                                const std::string& color, bool isPlayer);
 
     /**
      * @brief Animate sprite shake effect (for taking damage).
      * @param baseRow Base row position.
      * @param baseCol Base column position.
-     * @param sprite Sprite string.
+     * @param sprite Sprite text; must outlive the queued frames.
      * @param color Color code.
      * @param intensity Shake intensity (pixels).
      * @param duration Duration in milliseconds.
      */
-    void animate_sprite_shake(int baseRow, int baseCol, const std::string& sprite,
+    void animate_sprite_shake(int baseRow, int baseCol, std::string_view sprite,
                               const std::string& color, int intensity, int duration);
 
-    /**
-     * @brief Calculate sprite dimensions from sprite string.
-     * @param sprite Sprite string (multi-line).
-     * @return Pair of (height, width) in rows and columns.
-     */
-    std::pair<int, int> calculate_sprite_dimensions(const std::string& sprite);
-
     /**
      * @brief Animate projectile flying from source to target.
      * @param fromRow Source row.
@@ -389,22 +451,22 @@ namespace ui {
      * @param startRow Starting row.
      * @param startCol Starting column.
      * @param targetCol Target column (to slide to).
-     * @param sprite Sprite string.
+     * @param sprite Sprite text; must outlive the queued frames.
      * @param color Color code.
      */
     void animate_rogue_slide(int startRow, int startCol, int targetCol,
-                             const std::string& sprite, const std::string& color);
+                             std::string_view sprite, const std::string& color);
 
     /**
      * @brief Animate warrior charge attack with weapon slash.
      * @param startRow Starting row.
      * @param startCol Starting column.
      * @param targetCol Target column (to charge to).
-     * @param sprite Sprite string.
+     * @param sprite Sprite text; must outlive the queued frames.
      * @param color Color code.
      */
     void animate_warrior_charge(int startRow, int startCol, int targetCol,
-                                const std::string& sprite, const std::string& color);
+                                std::string_view sprite, const std::string& color);
 
     /**
      * @brief Add a damage number to display in combat viewport.
@@ -423,6 +485,11 @@ namespace ui {
      */
     const char* view_name(UIView view);
 
+    /*
+     * Flashes, sounds, transitions and sprite animations below queue their
+     * frames on the animation timeline (animation.h) and return at once.
+     */
+
     /** @brief Flash the screen red when the player takes damage. */
     void flash_damage();
 
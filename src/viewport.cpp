@@ -3,6 +3,8 @@
 #include "glyphs.h"
 #include "ui.h"
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 
 // Simple FOV check (circular radius)
@@ -43,11 +45,109 @@ const std::string& get_entity_shade(int dist) {
     return constants::shade_fog;
 }
 
+namespace {
+    constexpr int kShadeSpan = constants::fov_radius * 2 + 1;
+    constexpr int kShadeBands = 4;  // close, medium, far, fog
+
+    constexpr int isqrt(int v) {
+        int r = 0;
+        while ((r + 1) * (r + 1) <= v) ++r;
+        return r;
+    }
+
+    // Truncated Euclidean distance for every offset in the sight square, built
+    // at compile time for fov_radius (same values as calculate_distance)
+    struct ShadeDistanceTable {
+        uint8_t dist[kShadeSpan][kShadeSpan];
+
+        constexpr ShadeDistanceTable() : dist{} {
+            for (int dy = -constants::fov_radius; dy <= constants::fov_radius; ++dy) {
+                for (int dx = -constants::fov_radius; dx <= constants::fov_radius; ++dx) {
+                    dist[dy + constants::fov_radius][dx + constants::fov_radius] =
+                        static_cast<uint8_t>(isqrt(dx * dx + dy * dy));
+                }
+            }
+        }
+
+        constexpr int at(int dx, int dy) const {
+            if (dx < -constants::fov_radius || dx > constants::fov_radius ||
+                dy < -constants::fov_radius || dy > constants::fov_radius) {
+                return constants::fov_radius + 1;
+            }
+            return dist[dy + constants::fov_radius][dx + constants::fov_radius];
+        }
+    };
+    constexpr ShadeDistanceTable kShadeDistance{};
+
+    // Same thresholds as get_wall_shade/get_floor_shade/get_entity_shade
+    constexpr int shade_band(int dist) {
+        return dist <= 2 ? 0 : dist <= 4 ? 1 : dist <= 6 ? 2 : 3;
+    }
+
+    // 256-colour palette index of a "\033[38;5;Nm" constant, -1 if it is not one
+    int16_t palette_index(const std::string& sgr) {
+        size_t pos = sgr.find("38;5;");
+        if (pos == std::string::npos) {
+            return -1;
+        }
+        return static_cast<int16_t>(std::atoi(sgr.c_str() + pos + 5));
+    }
+
+    // Colour indices for the viewport, resolved once from the constants strings
+    struct ShadePalette {
+        int16_t wall[kShadeBands];
+        int16_t floor[kShadeBands];
+        int16_t entity[kShadeBands];
+        int16_t player, stairs, trap, shrine, water, deepWater, lava, chasm, remembered;
+    };
+
+    const ShadePalette& shade_palette() {
+        static const ShadePalette palette = [] {
+            ShadePalette p{};
+            for (int b = 0; b < kShadeBands; ++b) {
+                int dist = b * 2 + 1;  // Any distance inside band b
+                p.wall[b] = palette_index(get_wall_shade(dist));
+                p.floor[b] = palette_index(get_floor_shade(dist));
+                p.entity[b] = palette_index(get_entity_shade(dist));
+            }
+            p.player = palette_index(constants::color_player);
+            p.stairs = palette_index(constants::color_stairs);
+            p.trap = palette_index(constants::color_trap);
+            p.shrine = palette_index(constants::color_shrine);
+            p.water = palette_index(constants::color_water);
+            p.deepWater = palette_index(constants::color_deep_water);
+            p.lava = palette_index(constants::color_lava);
+            p.chasm = palette_index(constants::color_chasm);
+            p.remembered = palette_index(constants::shade_remembered);
+            return p;
+        }();
+        return palette;
+    }
+}
+
+// Glyph for an explored tile that is currently out of sight (terrain only)
+static const char* remembered_glyph(TileType t) {
+    switch (t) {
+        case TileType::Wall: return glyphs::wall();
+        case TileType::Floor: return glyphs::floor_tile();
+        case TileType::Door: return glyphs::door_closed();
+        case TileType::StairsDown: return glyphs::stairs_down();
+        case TileType::StairsUp: return glyphs::stairs_up();
+        case TileType::Trap: return glyphs::trap();
+        case TileType::Shrine: return glyphs::shrine();
+        case TileType::Water: return glyphs::water();
+        case TileType::DeepWater: return glyphs::deep_water();
+        case TileType::Lava: return glyphs::lava();
+        case TileType::Chasm: return glyphs::chasm();
+        default: return " ";
+    }
+}
+
 // Camera-centered viewport rendering (Dwarf Fortress style)
 // Player is always at center of viewport; map scrolls around them
 // Now with distance-based shading for depth perception
 void draw_map_viewport(const Dungeon& dungeon, const Player& player, 
-                       const std::vector<Enemy>& enemies, 
+                       const std::vector<Enemy>& enemies, const OccupancyGrid& occupancy,
                        int startRow, int startCol, int vw, int vh) {
     
     // Calculate camera position (centered on player)
@@ -58,6 +158,9 @@ void draw_map_viewport(const Dungeon& dungeon, const Player& player,
     // Clamp camera to map bounds
     cam_x = std::max(0, std::min(cam_x, dungeon.width() - vw));
     cam_y = std::max(0, std::min(cam_y, dungeon.height() - vh));
+
+    // IMPROVED: Shadowcast FOV, cached on the dungeon and only recomputed when the player moves
+    dungeon.compute_fov(pp, constants::fov_radius);
     
     // Draw the main game frame
     ui::draw_box_double(startRow, startCol, vw + 2, vh + 2, constants::color_frame_main);
@@ -77,144 +180,121 @@ void draw_map_viewport(const Dungeon& dungeon, const Player& player,
             
             // Out of map bounds
             if (!dungeon.in_bounds(x, y)) {
-                std::cout << ' ';
+                ui::put_glyph(" ", -1);
                 continue;
             }
             
-            // FOV check
-            if (!in_simple_fov(pp, x, y, constants::fov_radius)) {
-                std::cout << ' ';
+            // FOV check: out-of-sight tiles show remembered terrain or nothing
+            if (!dungeon.is_visible(x, y)) {
+                if (dungeon.is_explored(x, y)) {
+                    ui::put_glyph(remembered_glyph(dungeon.get_tile(x, y)), shade_palette().remembered);
+                } else {
+                    ui::put_glyph(" ", -1);
+                }
                 continue;
             }
             
-            // Calculate distance for shading
-            int dist = calculate_distance(pp.x, pp.y, x, y);
+            // Distance for shading (IMPROVED: table lookup instead of sqrt per cell)
+            int dist = kShadeDistance.at(x - pp.x, y - pp.y);
+            int band = shade_band(dist);
             
             TileType t = dungeon.get_tile(x, y);
             
             // Player (always at center when visible)
             if (pp.x == x && pp.y == y) {
-                ui::set_color(constants::color_player);
-                std::cout << glyphs::player();
-                ui::reset_color();
+                ui::put_glyph(glyphs::player(), shade_palette().player);
                 continue;
             }
             
             // Enemies (with distance shading)
-            bool drawnEnemy = false;
-            for (const auto& e : enemies) {
-                if (e.get_position().x == x && e.get_position().y == y) {
-                    // Apply distance-based shading to enemy color
-                    // Color based on distance and height
-                    if (e.height() == HeightLevel::Flying) {
-                        // Flying enemies have a distinct bright color
-                        ui::set_color("\033[38;5;51m"); // Bright cyan for flying
-                    } else if (e.height() == HeightLevel::LowAir) {
-                        // Hovering enemies are slightly faded
-                        ui::set_color("\033[38;5;147m"); // Light purple for hovering
-                    } else if (dist <= 3) {
-                        ui::set_color(e.color()); // Full color when close
-                    } else {
-                        ui::set_color(get_entity_shade(dist)); // Faded when far
+            // IMPROVED: O(1) occupancy lookup instead of scanning every enemy per cell
+            int32_t slot = occupancy.at(x, y);
+            if (slot != OccupancyGrid::EMPTY && static_cast<size_t>(slot) < enemies.size()) {
+                const Enemy& e = enemies[static_cast<size_t>(slot)];
+                // Apply distance-based shading to enemy color
+                // Color based on distance and height
+                if (e.height() == HeightLevel::Flying) {
+                    // Flying enemies have a distinct bright color
+                    ui::set_color("\033[38;5;51m"); // Bright cyan for flying
+                } else if (e.height() == HeightLevel::LowAir) {
+                    // Hovering enemies are slightly faded
+                    ui::set_color("\033[38;5;147m"); // Light purple for hovering
+                } else if (dist <= 3) {
+                    ui::set_color(e.color()); // Full color when close
+                } else {
+                    ui::set_color(get_entity_shade(dist)); // Faded when far
+                }
+                
+                char eglyph = e.glyph();
+                
+                // Show AI tier indicator or height indicator
+                AITier tier = e.knowledge().tier;
+                if (e.height() == HeightLevel::Flying) {
+                    std::cout << glyphs::height_flying(); // Flying indicator
+                } else if (e.height() == HeightLevel::LowAir) {
+                    std::cout << glyphs::height_low_air(); // Hovering indicator
+                } else if (tier == AITier::Master) {
+                    // Master tier: uppercase glyph + bright color
+                    if (eglyph >= 'a' && eglyph <= 'z') {
+                        eglyph = eglyph - 'a' + 'A';
                     }
-                    
-                    char eglyph = e.glyph();
-                    
-                    // Show AI tier indicator or height indicator
-                    AITier tier = e.knowledge().tier;
-                    if (e.height() == HeightLevel::Flying) {
-                        std::cout << glyphs::height_flying(); // Flying indicator
-                    } else if (e.height() == HeightLevel::LowAir) {
-                        std::cout << glyphs::height_low_air(); // Hovering indicator
-                    } else if (tier == AITier::Master) {
-                        // Master tier: uppercase glyph + bright color
-                        if (eglyph >= 'a' && eglyph <= 'z') {
-                            eglyph = eglyph - 'a' + 'A';
-                        }
-                        ui::set_color("\033[38;5;226m"); // Bright yellow for master
-                        std::cout << eglyph;
-                    } else if (tier == AITier::Adapted || tier == AITier::Learning) {
-                        // Learning/Adapted: uppercase glyph
-                        if (eglyph >= 'a' && eglyph <= 'z') {
-                            eglyph = eglyph - 'a' + 'A';
-                        }
-                        std::cout << eglyph;
-                    } else {
-                        std::cout << eglyph;
+                    ui::set_color("\033[38;5;226m"); // Bright yellow for master
+                    std::cout << eglyph;
+                } else if (tier == AITier::Adapted || tier == AITier::Learning) {
+                    // Learning/Adapted: uppercase glyph
+                    if (eglyph >= 'a' && eglyph <= 'z') {
+                        eglyph = eglyph - 'a' + 'A';
                     }
-                    ui::reset_color();
-                    drawnEnemy = true;
-                    break;
+                    std::cout << eglyph;
+                } else {
+                    std::cout << eglyph;
                 }
+                ui::reset_color();
+                continue;
             }
-            if (drawnEnemy) continue;
             
             // Terrain with distance-based shading
+            // IMPROVED: Palette indices from the precomputed tables, no strings per cell
+            const ShadePalette& pal = shade_palette();
             switch (t) {
                 case TileType::Wall:
-                    ui::set_color(get_wall_shade(dist));
-                    std::cout << glyphs::wall();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::wall(), pal.wall[band]);
                     break;
                 case TileType::Floor:
-                    ui::set_color(get_floor_shade(dist));
-                    std::cout << glyphs::floor_tile();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::floor_tile(), pal.floor[band]);
                     break;
                 case TileType::Door:
-                    ui::set_color(get_entity_shade(dist));
-                    std::cout << glyphs::door_closed();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::door_closed(), pal.entity[band]);
                     break;
                 case TileType::StairsDown:
                     // Stairs are always bright (important navigation)
-                    ui::set_color(constants::color_stairs);
-                    std::cout << glyphs::stairs_down();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::stairs_down(), pal.stairs);
                     break;
                 case TileType::StairsUp:
-                    ui::set_color(constants::color_stairs);
-                    std::cout << glyphs::stairs_up();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::stairs_up(), pal.stairs);
                     break;
                 case TileType::Trap:
                     // Traps fade with distance (harder to see from far)
-                    if (dist <= 3) {
-                        ui::set_color(constants::color_trap);
-                    } else {
-                        ui::set_color(get_floor_shade(dist)); // Blend with floor when far
-                    }
-                    std::cout << glyphs::trap();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::trap(), dist <= 3 ? pal.trap : pal.floor[band]);
                     break;
                 case TileType::Shrine:
                     // Shrines glow (always visible)
-                    ui::set_color(constants::color_shrine);
-                    std::cout << glyphs::shrine();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::shrine(), pal.shrine);
                     break;
                 case TileType::Water:
                     // Water shimmers
-                    ui::set_color(constants::color_water);
-                    std::cout << glyphs::water();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::water(), pal.water);
                     break;
                 case TileType::DeepWater:
-                    ui::set_color(constants::color_deep_water);
-                    std::cout << glyphs::deep_water();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::deep_water(), pal.deepWater);
                     break;
                 case TileType::Lava:
                     // Lava glows bright (always visible, dangerous)
-                    ui::set_color(constants::color_lava);
-                    std::cout << glyphs::lava();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::lava(), pal.lava);
                     break;
                 case TileType::Chasm:
                     // Chasm is dark void
-                    ui::set_color(constants::color_chasm);
-                    std::cout << glyphs::chasm();
-                    ui::reset_color();
+                    ui::put_glyph(glyphs::chasm(), pal.chasm);
                     break;
                 default:
                     std::cout << ' ';
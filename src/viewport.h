@@ -3,6 +3,7 @@
 #include "dungeon.h"
 #include "player.h"
 #include "enemy.h"
+#include "occupancy_grid.h"
 #include "types.h"
 #include <vector>
 
@@ -24,7 +25,10 @@ const std::string& get_entity_shade(int dist);
 // Camera-centered viewport rendering (Dwarf Fortress style)
 // Player is always at center of viewport; map scrolls around them
 // Now with distance-based shading for depth perception
+// Enemies are looked up through the floor's occupancy grid
+// Visibility comes from the dungeon's shadowcast FOV; explored tiles out of
+// sight are drawn dimmed as fog-of-war memory
 void draw_map_viewport(const Dungeon& dungeon, const Player& player, 
-                       const std::vector<Enemy>& enemies, 
+                       const std::vector<Enemy>& enemies, const OccupancyGrid& occupancy,
                        int startRow, int startCol, int vw, int vh);
 
@@ -0,0 +1,106 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    workers_.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    WorkQueue& queue = *queues_[nextQueue_];
+    nextQueue_ = (nextQueue_ + 1) % size();
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        // Counted before the task is visible, so a worker that pops it at once
+        // can never take queued_ below zero
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queued_.fetch_add(1, std::memory_order_release);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        // Pass through the sleep mutex so a worker between its queued_ check
+        // and its wait cannot miss the notify
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    workAvailable_.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    allDone_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+bool WorkStealingPool::pop_local(unsigned index, Task& out) {
+    WorkQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    out = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, Task& out) {
+    const unsigned n = size();
+    for (unsigned offset = 1; offset < n; ++offset) {
+        WorkQueue& victim = *queues_[(thief + offset) % n];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) {
+            continue;
+        }
+        out = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(unsigned index) {
+    Task task;
+    while (true) {
+        if (pop_local(index, task) || steal(index, task)) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            task(index);
+            task = nullptr;
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                allDone_.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        if (stopping_) {
+            return;
+        }
+        // A steal can miss work behind a contended lock; only sleep when the
+        // deques are really empty
+        if (queued_.load(std::memory_order_acquire) == 0) {
+            workAvailable_.wait(lock, [this] {
+                return stopping_ || queued_.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+}
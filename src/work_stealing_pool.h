@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque each. A worker takes work
+// from the back of its own deque and, once that is empty, steals from the
+// front of the other deques, so uneven task lengths still keep every core busy.
+class WorkStealingPool {
+public:
+    // A task receives the index of the worker running it (0 .. size()-1),
+    // which callers use to address per-worker buffers without locking
+    using Task = std::function<void(unsigned workerIndex)>;
+
+    // threadCount 0 = one worker per hardware thread
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues_.size()); }
+
+    // Queue a task; tasks are dealt round-robin across the worker deques
+    void submit(Task task);
+
+    // Block until every submitted task has finished
+    void wait();
+
+private:
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(unsigned index);
+    bool pop_local(unsigned index, Task& out);
+    bool steal(unsigned thief, Task& out);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> pending_{0};   // Submitted but not finished
+    std::atomic<size_t> queued_{0};    // Sitting in a deque
+    unsigned nextQueue_ = 0;
+    bool stopping_ = false;
+
+    std::mutex sleepMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+};